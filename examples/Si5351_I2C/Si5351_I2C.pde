@@ -34,16 +34,17 @@ static void Si5351_I2C_BeginTransmission(const uint8_t u8Address) {
 static void Si5351_I2C_RequestFrom(const uint8_t u8Address, const uint8_t u8Count) {
 #if !defined(SI5351_I2C_USE_TINYWIREM)
   Wire.requestFrom(u8Address, u8Count);
+#else
+  /* Must endTransmission before this call */
+  TinyWireM.requestFrom(u8Address, u8Count);
 #endif  /* SI5351_I2C_USE_TINYWIREM */
 }
 
 static uint8_t Si5351_I2C_Read(const uint8_t u8Address) {
-#if !defined(SI5351_I2C_USE_TINYWIREM)
   (void)u8Address;
+#if !defined(SI5351_I2C_USE_TINYWIREM)
   return Wire.read();
 #else
-  /* Must endTransmission before this call */
-  TinyWireM.requestFrom(u8Address, 1);
   return TinyWireM.receive();
 #endif  /* SI5351_I2C_USE_TINYWIREM */
 }
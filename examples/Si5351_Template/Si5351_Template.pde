@@ -0,0 +1,101 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#elif defined(ESP8266)
+#include <pgmspace.h>
+#else
+#define PROGMEM
+#endif
+
+//#define SI5351_I2C_USE_TINYWIREM
+
+#if !defined(SI5351_I2C_USE_TINYWIREM)
+#include <Wire.h>
+#else
+#include <TinyWireM.h>
+#endif  /* SI5351_I2C_USE_TINYWIREM */
+
+#include <si5351_template.h>
+
+/* Transport policy: static members, inlined into every register access */
+struct Si5351_Wire {
+  static void beginTransmission(const uint8_t u8Address) {
+#if !defined(SI5351_I2C_USE_TINYWIREM)
+    Wire.beginTransmission(u8Address);
+#else
+    TinyWireM.beginTransmission(u8Address);
+#endif  /* SI5351_I2C_USE_TINYWIREM */
+  }
+
+  static void requestFrom(const uint8_t u8Address, const uint8_t u8Count) {
+#if !defined(SI5351_I2C_USE_TINYWIREM)
+    Wire.requestFrom(u8Address, u8Count);
+#else
+    /* Must endTransmission before this call */
+    TinyWireM.requestFrom(u8Address, u8Count);
+#endif  /* SI5351_I2C_USE_TINYWIREM */
+  }
+
+  static uint8_t read(const uint8_t u8Address) {
+    (void)u8Address;
+#if !defined(SI5351_I2C_USE_TINYWIREM)
+    return Wire.read();
+#else
+    return TinyWireM.receive();
+#endif  /* SI5351_I2C_USE_TINYWIREM */
+  }
+
+  static void write(const uint8_t u8Value) {
+#if !defined(SI5351_I2C_USE_TINYWIREM)
+    Wire.write(u8Value);
+#else
+    TinyWireM.send(u8Value);
+#endif  /* SI5351_I2C_USE_TINYWIREM */
+  }
+
+  static void endTransmission(void) {
+#if !defined(SI5351_I2C_USE_TINYWIREM)
+    Wire.endTransmission();
+#else
+    TinyWireM.endTransmission();
+#endif  /* SI5351_I2C_USE_TINYWIREM */
+  }
+};
+
+Si5351<Si5351_Wire, Si5351_VariantA3> g_oSi5351;
+
+void setup() {
+  Si5351_MS_t tMSPLL, tMSClk;
+
+#if !defined(SI5351_I2C_USE_TINYWIREM)
+  Wire.begin();
+  Wire.setClock(400000);
+#else
+  TinyWireM.begin();
+#endif  /* SI5351_I2C_USE_TINYWIREM */
+
+  g_oSi5351.initDevice();
+
+  /* XTAL -> PLLA -> MS0 -> CLK0 */
+
+  g_oSi5351.setPLLA_SRC(SI5351_INPUT_XTAL);
+  /* PLL: 800MHz from the Variant's XTAL, within its VCO range (600MHz - 900MHz) */
+  if(g_oSi5351.calcMSPLL(&tMSPLL, 800000000)) {
+    g_oSi5351.setMSA(&tMSPLL);
+    g_oSi5351.PLLSoftReset();
+
+    g_oSi5351.setClkPowerDown(0, false);
+    g_oSi5351.setClkMSSource(0, SI5351_CLK_MS_SRC_PLLA);
+    g_oSi5351.setClkSrc(0, SI5351_INPUT_MS);
+    /* Clk: 10MHz*/
+    if(g_oSi5351.calcMSClk(&tMSClk, 800000000, 10000000)) {
+      g_oSi5351.setMS(0, &tMSClk);
+      g_oSi5351.setOutputEnable(1 << 0);
+    }
+  }
+}
+
+void loop() {
+}
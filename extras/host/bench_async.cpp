@@ -0,0 +1,151 @@
+/* Si5351 asynchronous command queue benchmark (host) */
+/*
+  Producer threads retune CLK outputs (frequency hops), either calling
+  Si5351_I2C directly under the pthread lock policy, or posting
+  SI5351_ASYNC_FREQUENCY commands to one Si5351_Async worker.
+  The I2C bus is a mock that burns a fixed time per byte.
+  Prints completed commands/s, bus bytes per command and coalesced share.
+
+  usage: bench_async [milliseconds] [ns per bus byte]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "si5351_async.h"
+#include "bench_clock.h"
+#include "bench_bus.h"
+
+#define BENCH_VCO 800000000
+#define BENCH_FREQ 10000000
+
+static std::atomic<bool> g_bRun;
+static std::atomic<uint64_t> g_u64Done;
+
+static void Bench_Done(void* pUser, const bool bResult) {
+  (void)pUser;
+  (void)bResult;
+  g_u64Done.fetch_add(1, std::memory_order_relaxed);
+}
+
+static bool Bench_Setup(Si5351_I2C* poSi5351, Si5351_Cache_t* ptCache, void** ppLock) {
+  bool bValid;
+
+  memset(g_au8Register, 0, sizeof(g_au8Register));
+  bValid = poSi5351->initialize(
+    Bench_BeginTransmission, Bench_RequestFrom, Bench_Read, Bench_Write, Bench_EndTransmission,
+    Bench_MemoryBarrier, ppLock
+  );
+  if(bValid) {
+    bValid = poSi5351->attachCache(ptCache);
+  }
+
+  return bValid;
+}
+
+static void Bench_Direct(Si5351_I2C* poSi5351, const uint32_t u32Producer) {
+  Si5351_MS_t tMS;
+  uint32_t u32Loop = 0;
+
+  while(g_bRun.load(std::memory_order_relaxed)) {
+    Si5351_I2C::calcMSClk(&tMS, BENCH_VCO, BENCH_FREQ + (u32Loop++ % 1000) * 10);
+    poSi5351->setMS((Si5351_CLKNo_t)(u32Producer % SI5351_CLKNUM), &tMS);
+    g_u64Done.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+static void Bench_Post(Si5351_Async* poAsync, const uint32_t u32Producer) {
+  Si5351_AsyncCommand_t tCommand;
+  uint32_t u32Loop = 0;
+
+  memset(&tCommand, 0, sizeof(tCommand));
+  tCommand.tType = SI5351_ASYNC_FREQUENCY;
+  tCommand.tCLKNo = (Si5351_CLKNo_t)(u32Producer % SI5351_CLKNUM);
+  tCommand.u32VCO = BENCH_VCO;
+  while(g_bRun.load(std::memory_order_relaxed)) {
+    tCommand.u32Freq = BENCH_FREQ + (u32Loop++ % 1000) * 10;
+    while(!poAsync->post(&tCommand, Bench_Done, NULL)) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+static void Bench_Report(const char* pszMode, const uint32_t u32Producers, const uint64_t u64Nanoseconds, const uint32_t u32Coalesced) {
+  uint64_t u64Done = g_u64Done.load();
+
+  printf("%-6s producers %u  %9.0f cmd/s  %6.1f bus bytes/cmd  coalesced %5.1f%%\n",
+    pszMode, u32Producers, (double)u64Done * 1e9 / u64Nanoseconds,
+    u64Done ? (double)g_u64Bytes.load() / u64Done : 0.0,
+    u64Done ? 100.0 * u32Coalesced / u64Done : 0.0);
+}
+
+int main(int argc, char* argv[]) {
+  static const uint32_t au32Producers[] = { 1, 2, 4, 8 };
+  static pthread_mutex_t tMutex = PTHREAD_MUTEX_INITIALIZER;
+  static Si5351_Cache_t tCache;
+  static Si5351_I2C oSi5351;
+  uint32_t u32Milliseconds = 300;
+  uint32_t u32Index;
+  uint32_t u32Producer;
+  uint64_t u64Nanoseconds;
+  void* pLock = NULL;
+  Si5351_AsyncStats_t tStats;
+  std::vector<std::thread> aoThread;
+
+  if(argc > 1) {
+    u32Milliseconds = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+  if(argc > 2) {
+    g_u32ByteNs = (uint32_t)strtoul(argv[2], NULL, 0);
+  }
+  printf("bus %u ns/byte, %u ms per run\n", g_u32ByteNs, u32Milliseconds);
+
+  for(u32Index = 0; u32Index < sizeof(au32Producers) / sizeof(au32Producers[0]); u32Index++) {
+    /* direct: every producer drives the bus under the lock */
+    Bench_Setup(&oSi5351, &tCache, &pLock);
+    oSi5351.setLockPolicy(&Si5351_LockPolicyPthread, &tMutex);
+    g_u64Done.store(0);
+    g_u64Bytes.store(0);
+    g_bRun.store(true);
+    u64Nanoseconds = Bench_Nanoseconds();
+    for(u32Producer = 0; u32Producer < au32Producers[u32Index]; u32Producer++) {
+      aoThread.push_back(std::thread(Bench_Direct, &oSi5351, u32Producer));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(u32Milliseconds));
+    g_bRun.store(false);
+    for(u32Producer = 0; u32Producer < aoThread.size(); u32Producer++) {
+      aoThread[u32Producer].join();
+    }
+    aoThread.clear();
+    Bench_Report("direct", au32Producers[u32Index], Bench_Nanoseconds() - u64Nanoseconds, 0);
+
+    /* async: one worker owns the bus, no lock */
+    {
+      Si5351_Async oAsync(oSi5351);
+
+      Bench_Setup(&oSi5351, &tCache, NULL);
+      oAsync.start();
+      g_u64Done.store(0);
+      g_u64Bytes.store(0);
+      g_bRun.store(true);
+      u64Nanoseconds = Bench_Nanoseconds();
+      for(u32Producer = 0; u32Producer < au32Producers[u32Index]; u32Producer++) {
+        aoThread.push_back(std::thread(Bench_Post, &oAsync, u32Producer));
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(u32Milliseconds));
+      g_bRun.store(false);
+      for(u32Producer = 0; u32Producer < aoThread.size(); u32Producer++) {
+        aoThread[u32Producer].join();
+      }
+      aoThread.clear();
+      oAsync.stop();
+      oAsync.getStats(&tStats);
+      Bench_Report("async", au32Producers[u32Index], Bench_Nanoseconds() - u64Nanoseconds, tStats.u32Coalesced);
+    }
+  }
+
+  return 0;
+}
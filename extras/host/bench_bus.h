@@ -0,0 +1,68 @@
+#ifndef _BENCH_BUS_H_
+#define _BENCH_BUS_H_
+
+/* Mock Wire-style I2C bus for Si5351_I2C host benchmarks (C++) */
+/*
+  One register file per device address (0x60 + n, BENCH_DEVICES of them),
+  every transferred byte (address, register, data) burns g_u32ByteNs
+  nanoseconds of CPU and is counted in g_u64Bytes.
+*/
+
+#include <atomic>
+#include "bench_clock.h"
+
+#ifndef BENCH_DEVICES
+#define BENCH_DEVICES 1
+#endif
+
+static uint8_t g_aau8Register[BENCH_DEVICES][256];
+#define g_au8Register (g_aau8Register[0])
+static uint8_t g_u8Device;
+static uint8_t g_u8Pointer;
+static bool g_bAddress;
+static uint32_t g_u32ByteNs = 2500;
+static std::atomic<uint64_t> g_u64Bytes;
+
+static void Bench_Byte(void) {
+  uint64_t u64Start = Bench_Nanoseconds();
+
+  g_u64Bytes.fetch_add(1, std::memory_order_relaxed);
+  while(Bench_Nanoseconds() - u64Start < g_u32ByteNs);
+}
+
+static void Bench_BeginTransmission(const uint8_t u8Address) {
+  g_u8Device = (uint8_t)((u8Address - 0x60) % BENCH_DEVICES);
+  g_bAddress = true;
+  Bench_Byte();
+}
+
+static void Bench_RequestFrom(const uint8_t u8Address, const uint8_t u8Count) {
+  (void)u8Count;
+  g_u8Device = (uint8_t)((u8Address - 0x60) % BENCH_DEVICES);
+  Bench_Byte();
+}
+
+static uint8_t Bench_Read(const uint8_t u8Address) {
+  (void)u8Address;
+  Bench_Byte();
+  return g_aau8Register[g_u8Device][g_u8Pointer++];
+}
+
+static void Bench_Write(const uint8_t u8Value) {
+  Bench_Byte();
+  if(g_bAddress) {
+    g_bAddress = false;
+    g_u8Pointer = u8Value;
+  } else {
+    g_aau8Register[g_u8Device][g_u8Pointer++] = u8Value;
+  }
+}
+
+static void Bench_EndTransmission(void) {
+}
+
+static void Bench_MemoryBarrier(void) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+#endif  /* _BENCH_BUS_H_ */
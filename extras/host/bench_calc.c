@@ -0,0 +1,78 @@
+/* Si5351 divider math benchmark (host) */
+/*
+  Built once per math path (see Makefile):
+    bench_calc_double : double
+    bench_calc_int    : SI5351_USE_INTEGER_MATH
+*/
+
+#include <stdio.h>
+#include "si5351.h"
+#include "bench_clock.h"
+
+#define BENCH_LOOPS 200000
+
+#if defined(SI5351_USE_INTEGER_MATH)
+#define BENCH_PATH "integer"
+typedef uint32_t Bench_Freq_t;
+#else
+#define BENCH_PATH "double"
+typedef double Bench_Freq_t;
+#endif
+
+static volatile uint32_t g_u32Sink;
+
+int main(void) {
+  Si5351_MS_t tMS;
+  Bench_Freq_t tOutput;
+  uint64_t u64Cycles;
+  uint64_t u64Nanoseconds;
+  uint32_t u32Loop;
+
+  /* PLL: 600MHz - 900MHz */
+  u64Nanoseconds = Bench_Nanoseconds();
+  u64Cycles = Bench_Cycles();
+  for(u32Loop = 0; u32Loop < BENCH_LOOPS; u32Loop++) {
+    Si5351_CalcMSPLL(&tMS, SI5351_XTAL_FREQ, 600000000 + u32Loop * 1499);
+    g_u32Sink += tMS.u32MSX_P2;
+  }
+  u64Cycles = Bench_Cycles() - u64Cycles;
+  u64Nanoseconds = Bench_Nanoseconds() - u64Nanoseconds;
+  printf("%-8s CalcMSPLL   %8.1f cycles/call %8.1f ns/call\n", BENCH_PATH,
+    (double)u64Cycles / BENCH_LOOPS, (double)u64Nanoseconds / BENCH_LOOPS);
+
+  u64Nanoseconds = Bench_Nanoseconds();
+  u64Cycles = Bench_Cycles();
+  for(u32Loop = 0; u32Loop < BENCH_LOOPS; u32Loop++) {
+    Si5351_DecalcMSPLL(&tOutput, SI5351_XTAL_FREQ, &tMS);
+    g_u32Sink += (uint32_t)tOutput;
+  }
+  u64Cycles = Bench_Cycles() - u64Cycles;
+  u64Nanoseconds = Bench_Nanoseconds() - u64Nanoseconds;
+  printf("%-8s DecalcMSPLL %8.1f cycles/call %8.1f ns/call\n", BENCH_PATH,
+    (double)u64Cycles / BENCH_LOOPS, (double)u64Nanoseconds / BENCH_LOOPS);
+
+  /* Clk: 1MHz - 100MHz from 800MHz */
+  u64Nanoseconds = Bench_Nanoseconds();
+  u64Cycles = Bench_Cycles();
+  for(u32Loop = 0; u32Loop < BENCH_LOOPS; u32Loop++) {
+    Si5351_CalcMSClk(&tMS, 800000000, 1000000 + u32Loop * 495);
+    g_u32Sink += tMS.u32MSX_P2;
+  }
+  u64Cycles = Bench_Cycles() - u64Cycles;
+  u64Nanoseconds = Bench_Nanoseconds() - u64Nanoseconds;
+  printf("%-8s CalcMSClk   %8.1f cycles/call %8.1f ns/call\n", BENCH_PATH,
+    (double)u64Cycles / BENCH_LOOPS, (double)u64Nanoseconds / BENCH_LOOPS);
+
+  u64Nanoseconds = Bench_Nanoseconds();
+  u64Cycles = Bench_Cycles();
+  for(u32Loop = 0; u32Loop < BENCH_LOOPS; u32Loop++) {
+    Si5351_DecalcMSClk(&tOutput, 800000000, &tMS);
+    g_u32Sink += (uint32_t)tOutput;
+  }
+  u64Cycles = Bench_Cycles() - u64Cycles;
+  u64Nanoseconds = Bench_Nanoseconds() - u64Nanoseconds;
+  printf("%-8s DecalcMSClk %8.1f cycles/call %8.1f ns/call\n", BENCH_PATH,
+    (double)u64Cycles / BENCH_LOOPS, (double)u64Nanoseconds / BENCH_LOOPS);
+
+  return 0;
+}
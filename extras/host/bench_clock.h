@@ -0,0 +1,28 @@
+#ifndef _BENCH_CLOCK_H_
+#define _BENCH_CLOCK_H_
+
+/* Host benchmark timing helpers */
+
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+static inline uint64_t Bench_Nanoseconds(void) {
+  struct timespec tTime;
+
+  clock_gettime(CLOCK_MONOTONIC, &tTime);
+  return (uint64_t)tTime.tv_sec * 1000000000 + tTime.tv_nsec;
+}
+
+/* TSC cycles on x86, nanoseconds elsewhere */
+static inline uint64_t Bench_Cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return Bench_Nanoseconds();
+#endif
+}
+
+#endif  /* _BENCH_CLOCK_H_ */
@@ -0,0 +1,339 @@
+/* Si5351 coroutine front-end benchmark (host) */
+/*
+  A non-blocking mock transport: each simulated I2C bus is a thread that
+  takes queued transfers, holds them for their wire time (g_u32ByteNs per
+  byte incl. address and register bytes) and then completes them through
+  tDone. Devices spread round robin over BENCH_BUSES buses.
+  For each operation the same work runs
+    sequential : every task awaited before the next one starts (what a
+                 blocking API does), the event loop waits with it
+    in flight  : all tasks started at once, the event loop keeps polling
+  and prints the elapsed time and the longest gap between event loop ticks.
+
+  usage: bench_coro [ns per bus byte (default 22500 : 400 kHz)]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "si5351_coro.h"
+#include "bench_clock.h"
+
+#define BENCH_BUSES 4
+#define BENCH_PER_BUS 2
+#define BENCH_DEVICES (BENCH_BUSES * BENCH_PER_BUS)
+#define BENCH_VCO 800000000
+#define BENCH_HOPS 20
+
+typedef struct Bench_Transfer_t_ {
+  bool bWrite;
+  uint8_t u8Device;
+  uint8_t u8Reg;
+  uint8_t* pu8Value;
+  uint8_t u8Count;
+  Si5351_CoroDone_t tDone;
+  void* pUser;
+} Bench_Transfer_t;
+
+typedef struct Bench_Bus_t_ {
+  uint8_t aau8Register[BENCH_PER_BUS][256];
+  std::mutex oMutex;
+  std::condition_variable oReady;
+  std::deque<Bench_Transfer_t> atQueue;
+  bool bRun;
+  uint64_t u64Bytes;
+  uint64_t u64Transfers;
+} Bench_Bus_t;
+
+static Bench_Bus_t g_atBus[BENCH_BUSES];
+static uint32_t g_u32ByteNs = 22500;
+
+static void Bench_BusThread(Bench_Bus_t* ptBus) {
+  Bench_Transfer_t tTransfer;
+  uint32_t u32Bytes;
+
+  for(;;) {
+    {
+      std::unique_lock<std::mutex> oLock(ptBus->oMutex);
+      ptBus->oReady.wait(oLock, [ptBus] { return !ptBus->bRun || !ptBus->atQueue.empty(); });
+      if(ptBus->atQueue.empty()) {
+        break;
+      }
+      tTransfer = ptBus->atQueue.front();
+      ptBus->atQueue.pop_front();
+    }
+    /* write : address, register, data / read : address, register, address, data */
+    u32Bytes = tTransfer.bWrite ? 2 + tTransfer.u8Count : 3 + tTransfer.u8Count;
+    std::this_thread::sleep_for(std::chrono::nanoseconds((uint64_t)u32Bytes * g_u32ByteNs));
+    if(tTransfer.bWrite) {
+      memcpy(&ptBus->aau8Register[tTransfer.u8Device][tTransfer.u8Reg], tTransfer.pu8Value, tTransfer.u8Count);
+    } else {
+      memcpy(tTransfer.pu8Value, &ptBus->aau8Register[tTransfer.u8Device][tTransfer.u8Reg], tTransfer.u8Count);
+    }
+    {
+      std::lock_guard<std::mutex> oLock(ptBus->oMutex);
+      ptBus->u64Bytes += u32Bytes;
+      ptBus->u64Transfers++;
+    }
+    tTransfer.tDone(tTransfer.pUser, true);
+  }
+}
+
+static bool Bench_Start(
+  void* pContext, const bool bWrite, const uint8_t u8Address, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count,
+  Si5351_CoroDone_t tDone, void* pUser
+) {
+  Bench_Bus_t* ptBus = (Bench_Bus_t*)pContext;
+  Bench_Transfer_t tTransfer;
+
+  if(u8Address < 0x60 || u8Address >= 0x60 + BENCH_PER_BUS || (uint16_t)u8Reg + u8Count > 0x100) {
+    return false;
+  }
+  tTransfer.bWrite = bWrite;
+  tTransfer.u8Device = (uint8_t)(u8Address - 0x60);
+  tTransfer.u8Reg = u8Reg;
+  tTransfer.pu8Value = pu8Value;
+  tTransfer.u8Count = u8Count;
+  tTransfer.tDone = tDone;
+  tTransfer.pUser = pUser;
+  {
+    std::lock_guard<std::mutex> oLock(ptBus->oMutex);
+    ptBus->atQueue.push_back(tTransfer);
+  }
+  ptBus->oReady.notify_one();
+
+  return true;
+}
+
+static bool Bench_StartRead(
+  void* pContext, const uint8_t u8Address, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count,
+  Si5351_CoroDone_t tDone, void* pUser
+) {
+  return Bench_Start(pContext, false, u8Address, u8Reg, pu8Value, u8Count, tDone, pUser);
+}
+
+static bool Bench_StartWrite(
+  void* pContext, const uint8_t u8Address, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count,
+  Si5351_CoroDone_t tDone, void* pUser
+) {
+  return Bench_Start(pContext, true, u8Address, u8Reg, (uint8_t*)pu8Value, u8Count, tDone, pUser);
+}
+
+static Si5351_CoroExecutor g_oExecutor;
+static Si5351_Coro g_aoSi5351[BENCH_DEVICES];
+static Si5351_Plan_t g_tPlan;
+static Si5351_Status_t g_atStatus[BENCH_DEVICES];
+
+typedef enum Bench_Op_t_ {
+  BENCH_OP_PLAN = 0,
+  BENCH_OP_HOPS,
+  BENCH_OP_STATUS,
+  BENCH_OPS
+} Bench_Op_t;
+
+static const char* const g_apszOp[BENCH_OPS] = { "setPlan (cold)", "setFrequency x20", "getStatus x20" };
+
+/* The work of one device */
+static Si5351_CoroTask Bench_Work(const Bench_Op_t tOp, const uint32_t u32Device) {
+  bool bValid = true;
+  uint32_t u32Hop;
+
+  switch(tOp) {
+  case BENCH_OP_PLAN:
+    bValid = co_await g_aoSi5351[u32Device].setPlan(&g_tPlan);
+    break;
+  case BENCH_OP_HOPS:
+    for(u32Hop = 0; bValid && u32Hop < BENCH_HOPS; u32Hop++) {
+      bValid = co_await g_aoSi5351[u32Device].setFrequency(SI5351_CLK0, BENCH_VCO, 10000000 + u32Hop * 1000);
+    }
+    break;
+  case BENCH_OP_STATUS:
+    for(u32Hop = 0; bValid && u32Hop < BENCH_HOPS; u32Hop++) {
+      bValid = co_await g_aoSi5351[u32Device].getStatus(&g_atStatus[u32Device]);
+    }
+    break;
+  default:
+    bValid = false;
+    break;
+  }
+
+  co_return bValid;
+}
+
+/* Event loop: other work ticks between polls, the longest gap is the stall */
+static bool Bench_Loop(Si5351_CoroTask* ptTask, const uint32_t u32Tasks, uint64_t* pu64StallNs) {
+  bool bValid = true;
+  bool bDone = false;
+  uint64_t u64Last = Bench_Nanoseconds();
+  uint64_t u64Now;
+  uint32_t u32Index;
+
+  while(!bDone) {
+    g_oExecutor.poll();
+    u64Now = Bench_Nanoseconds();
+    if(u64Now - u64Last > *pu64StallNs) {
+      *pu64StallNs = u64Now - u64Last;
+    }
+    u64Last = u64Now;
+    bDone = true;
+    for(u32Index = 0; u32Index < u32Tasks; u32Index++) {
+      if(!ptTask[u32Index].isDone()) {
+        bDone = false;
+      }
+    }
+    if(!bDone) {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+  for(u32Index = 0; u32Index < u32Tasks; u32Index++) {
+    if(!ptTask[u32Index].getResult()) {
+      bValid = false;
+    }
+  }
+
+  return bValid;
+}
+
+/* cold start: empty register files and caches */
+static void Bench_Reset(void) {
+  uint32_t u32Bus;
+  uint32_t u32Device;
+
+  for(u32Bus = 0; u32Bus < BENCH_BUSES; u32Bus++) {
+    memset(g_atBus[u32Bus].aau8Register, 0, sizeof(g_atBus[u32Bus].aau8Register));
+  }
+  for(u32Device = 0; u32Device < BENCH_DEVICES; u32Device++) {
+    g_aoSi5351[u32Device].invalidateCache();
+  }
+}
+
+static bool Bench_Check(void) {
+  bool bValid = true;
+  uint32_t u32Device;
+  Bench_Bus_t* ptBus;
+
+  /* MSNA parameter P3 low byte and the PLL reset of every device */
+  for(u32Device = 0; u32Device < BENCH_DEVICES; u32Device++) {
+    ptBus = &g_atBus[u32Device % BENCH_BUSES];
+    if(
+      ptBus->aau8Register[u32Device / BENCH_BUSES][27] != (uint8_t)g_tPlan.atPLL[0].u32MSX_P3 ||
+      ptBus->aau8Register[u32Device / BENCH_BUSES][177] != 0xA0
+    ) {
+      bValid = false;
+    }
+  }
+
+  return bValid;
+}
+
+/* Bus traffic since the last call */
+static void Bench_Bytes(uint64_t* pu64Bytes, uint64_t* pu64Transfers) {
+  uint32_t u32Bus;
+
+  *pu64Bytes = 0;
+  *pu64Transfers = 0;
+  for(u32Bus = 0; u32Bus < BENCH_BUSES; u32Bus++) {
+    std::lock_guard<std::mutex> oLock(g_atBus[u32Bus].oMutex);
+    *pu64Bytes += g_atBus[u32Bus].u64Bytes;
+    *pu64Transfers += g_atBus[u32Bus].u64Transfers;
+    g_atBus[u32Bus].u64Bytes = 0;
+    g_atBus[u32Bus].u64Transfers = 0;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  Si5351_PlanRequest_t atRequest[SI5351_CLKNUM];
+  Si5351_CoroTransport_t atTransport[BENCH_BUSES];
+  Si5351_CoroTask atTask[BENCH_DEVICES];
+  std::thread aoThread[BENCH_BUSES];
+  uint64_t au64Ns[2];
+  uint64_t au64StallNs[2];
+  uint64_t u64Start;
+  uint64_t u64Bytes = 0;
+  uint64_t u64Transfers = 0;
+  uint32_t u32Bus;
+  uint32_t u32Device;
+  uint32_t u32Op;
+  uint32_t u32Mode;
+  bool bValid = true;
+
+  if(argc > 1) {
+    g_u32ByteNs = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+
+  memset(atRequest, 0, sizeof(atRequest));
+  atRequest[0].u32Freq = 10000000;
+  atRequest[1].u32Freq = 12288000;
+  atRequest[2].u32Freq = 27000000;
+  if(!Si5351_I2C::calcPlan(&g_tPlan, SI5351_XTAL_FREQ, atRequest)) {
+    fprintf(stderr, "calcPlan failed\n");
+    return 1;
+  }
+  for(u32Bus = 0; u32Bus < BENCH_BUSES; u32Bus++) {
+    g_atBus[u32Bus].bRun = true;
+    aoThread[u32Bus] = std::thread(Bench_BusThread, &g_atBus[u32Bus]);
+    atTransport[u32Bus].tStartRead = Bench_StartRead;
+    atTransport[u32Bus].tStartWrite = Bench_StartWrite;
+    atTransport[u32Bus].pContext = &g_atBus[u32Bus];
+  }
+  for(u32Device = 0; u32Device < BENCH_DEVICES; u32Device++) {
+    if(!g_aoSi5351[u32Device].initialize(&atTransport[u32Device % BENCH_BUSES], &g_oExecutor, (uint8_t)(0x60 + u32Device / BENCH_BUSES))) {
+      fprintf(stderr, "initialize failed\n");
+      return 1;
+    }
+  }
+
+  printf("%u devices on %u buses, %u ns/byte, event loop polls every 50 us\n", BENCH_DEVICES, BENCH_BUSES, g_u32ByteNs);
+  for(u32Op = 0; bValid && u32Op < BENCH_OPS; u32Op++) {
+    for(u32Mode = 0; bValid && u32Mode < 2; u32Mode++) {
+      if(u32Op == BENCH_OP_PLAN) {
+        Bench_Reset();
+      }
+      au64StallNs[u32Mode] = 0;
+      u64Start = Bench_Nanoseconds();
+      for(u32Device = 0; bValid && u32Device < BENCH_DEVICES; u32Device++) {
+        atTask[u32Device] = Bench_Work((Bench_Op_t)u32Op, u32Device);
+        if(u32Mode) {
+          g_oExecutor.start(atTask[u32Device]);
+        } else {
+          /* a blocking call: nothing else runs until it returns */
+          bValid = g_oExecutor.run(atTask[u32Device]);
+        }
+      }
+      if(u32Mode) {
+        bValid = Bench_Loop(atTask, BENCH_DEVICES, &au64StallNs[u32Mode]);
+      } else {
+        au64StallNs[u32Mode] = Bench_Nanoseconds() - u64Start;
+      }
+      au64Ns[u32Mode] = Bench_Nanoseconds() - u64Start;
+      if(bValid && u32Op == BENCH_OP_PLAN) {
+        bValid = Bench_Check();
+      }
+    }
+    if(!bValid) {
+      fprintf(stderr, "%s failed\n", g_apszOp[u32Op]);
+      break;
+    }
+    Bench_Bytes(&u64Bytes, &u64Transfers);
+    printf("%-17s sequential %7.2f ms (stall %7.2f ms)  in flight %7.2f ms (stall %5.2f ms)  x%.2f  %4.0f bytes %3.0f transfers/device\n",
+      g_apszOp[u32Op], au64Ns[0] / 1e6, au64StallNs[0] / 1e6, au64Ns[1] / 1e6, au64StallNs[1] / 1e6,
+      (double)au64Ns[0] / (au64Ns[1] ? au64Ns[1] : 1),
+      (double)u64Bytes / (2 * BENCH_DEVICES), (double)u64Transfers / (2 * BENCH_DEVICES));
+  }
+
+  for(u32Bus = 0; u32Bus < BENCH_BUSES; u32Bus++) {
+    {
+      std::lock_guard<std::mutex> oLock(g_atBus[u32Bus].oMutex);
+      g_atBus[u32Bus].bRun = false;
+    }
+    g_atBus[u32Bus].oReady.notify_one();
+    aoThread[u32Bus].join();
+  }
+
+  return bValid ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+/* Si5351 fleet programming benchmark (host) */
+/*
+  Devices spread round robin over BENCH_BUSES simulated I2C buses
+  (device n : bus n % BENCH_BUSES, address 0x60 + n / BENCH_BUSES).
+  A bus is a wire with its own timeline: every byte takes g_u32ByteNs and
+  the caller sleeps until its transfer is on the wire, like a blocking Wire
+  endTransmission/requestFrom. So buses overlap in time even on one CPU.
+  Programs the same frequency plan into every device one after another
+  (separate Si5351_I2C calls) and with Si5351_Fleet, and prints the time
+  until all devices are configured.
+
+  usage: bench_fleet [ns per bus byte (default 22500 : 400 kHz)]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include "si5351_fleet.h"
+#include "bench_clock.h"
+
+#define BENCH_BUSES 4
+#define BENCH_PER_BUS 4
+#define BENCH_DEVICES (BENCH_BUSES * BENCH_PER_BUS)
+/* the caller runs ahead of its wire by at most this, then sleeps */
+#define BENCH_SLICE_NS 200000
+
+typedef struct Bench_Bus_t_ {
+  uint8_t  aau8Register[BENCH_PER_BUS][256];
+  uint8_t  u8Device;
+  uint8_t  u8Pointer;
+  bool     bAddress;
+  uint64_t u64FreeNs;  /* the wire is busy until */
+  uint64_t u64Bytes;
+} Bench_Bus_t;
+
+static Bench_Bus_t g_atBus[BENCH_BUSES];
+static uint32_t g_u32ByteNs = 22500;
+
+static void Bench_Byte(Bench_Bus_t* ptBus) {
+  uint64_t u64Now = Bench_Nanoseconds();
+
+  if(ptBus->u64FreeNs < u64Now) {
+    ptBus->u64FreeNs = u64Now;
+  }
+  ptBus->u64FreeNs += g_u32ByteNs;
+  ptBus->u64Bytes++;
+}
+
+static void Bench_Wait(Bench_Bus_t* ptBus) {
+  uint64_t u64Now = Bench_Nanoseconds();
+
+  if(ptBus->u64FreeNs > u64Now + BENCH_SLICE_NS) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(ptBus->u64FreeNs - u64Now));
+  }
+}
+
+/* Wire-style callbacks, one set per bus */
+template<uint8_t u8Bus>
+static void Bench_BeginTransmission(const uint8_t u8Address) {
+  g_atBus[u8Bus].u8Device = (uint8_t)((u8Address - 0x60) % BENCH_PER_BUS);
+  g_atBus[u8Bus].bAddress = true;
+  Bench_Byte(&g_atBus[u8Bus]);
+}
+
+template<uint8_t u8Bus>
+static void Bench_RequestFrom(const uint8_t u8Address, const uint8_t u8Count) {
+  uint8_t u8Index;
+
+  g_atBus[u8Bus].u8Device = (uint8_t)((u8Address - 0x60) % BENCH_PER_BUS);
+  for(u8Index = 0; u8Index <= u8Count; u8Index++) {
+    Bench_Byte(&g_atBus[u8Bus]);
+  }
+  Bench_Wait(&g_atBus[u8Bus]);
+}
+
+template<uint8_t u8Bus>
+static uint8_t Bench_Read(const uint8_t u8Address) {
+  (void)u8Address;
+  return g_atBus[u8Bus].aau8Register[g_atBus[u8Bus].u8Device][g_atBus[u8Bus].u8Pointer++];
+}
+
+template<uint8_t u8Bus>
+static void Bench_Write(const uint8_t u8Value) {
+  Bench_Byte(&g_atBus[u8Bus]);
+  if(g_atBus[u8Bus].bAddress) {
+    g_atBus[u8Bus].bAddress = false;
+    g_atBus[u8Bus].u8Pointer = u8Value;
+  } else {
+    g_atBus[u8Bus].aau8Register[g_atBus[u8Bus].u8Device][g_atBus[u8Bus].u8Pointer++] = u8Value;
+  }
+}
+
+template<uint8_t u8Bus>
+static void Bench_EndTransmission(void) {
+  Bench_Wait(&g_atBus[u8Bus]);
+}
+
+static void Bench_MemoryBarrier(void) {
+}
+
+static const struct {
+  Si5351_I2C_BeginTransmission_t tBeginTransmission;
+  Si5351_I2C_RequestFrom_t       tRequestFrom;
+  Si5351_I2C_Read_t              tRead;
+  Si5351_I2C_Write_t             tWrite;
+  Si5351_I2C_EndTransmission_t   tEndTransmission;
+} g_atCallback[BENCH_BUSES] = {
+  { Bench_BeginTransmission<0>, Bench_RequestFrom<0>, Bench_Read<0>, Bench_Write<0>, Bench_EndTransmission<0> },
+  { Bench_BeginTransmission<1>, Bench_RequestFrom<1>, Bench_Read<1>, Bench_Write<1>, Bench_EndTransmission<1> },
+  { Bench_BeginTransmission<2>, Bench_RequestFrom<2>, Bench_Read<2>, Bench_Write<2>, Bench_EndTransmission<2> },
+  { Bench_BeginTransmission<3>, Bench_RequestFrom<3>, Bench_Read<3>, Bench_Write<3>, Bench_EndTransmission<3> }
+};
+
+static Si5351_I2C g_aoSi5351[BENCH_DEVICES];
+static Si5351_Cache_t g_atCache[BENCH_DEVICES];
+static Si5351_Plan_t g_atPlan[BENCH_DEVICES];
+
+/* cold start: empty register files and caches */
+static void Bench_Reset(const uint32_t u32Devices) {
+  uint32_t u32Device;
+
+  memset(g_atBus, 0, sizeof(g_atBus));
+  for(u32Device = 0; u32Device < u32Devices; u32Device++) {
+    g_aoSi5351[u32Device].invalidateCache();
+  }
+}
+
+static bool Bench_Check(const uint32_t u32Devices) {
+  bool bValid = true;
+  uint32_t u32Device;
+  Bench_Bus_t* ptBus;
+
+  /* MSNA parameter P3 low byte and Reg.3 of every device */
+  for(u32Device = 0; u32Device < u32Devices; u32Device++) {
+    ptBus = &g_atBus[u32Device % BENCH_BUSES];
+    if(
+      ptBus->aau8Register[u32Device / BENCH_BUSES][27] != (uint8_t)g_atPlan[u32Device].atPLL[0].u32MSX_P3 ||
+      ptBus->aau8Register[u32Device / BENCH_BUSES][3] == 0xFF
+    ) {
+      bValid = false;
+    }
+  }
+
+  return bValid;
+}
+
+static uint64_t Bench_Bytes(void) {
+  uint64_t u64Bytes = 0;
+  uint32_t u32Bus;
+
+  for(u32Bus = 0; u32Bus < BENCH_BUSES; u32Bus++) {
+    u64Bytes += g_atBus[u32Bus].u64Bytes;
+  }
+
+  return u64Bytes;
+}
+
+int main(int argc, char* argv[]) {
+  static const uint32_t au32Devices[] = { 1, 2, 4, 8, 16 };
+  Si5351_PlanRequest_t atRequest[SI5351_CLKNUM];
+  Si5351_FleetStats_t tStats;
+  uint32_t u32Index;
+  uint32_t u32Device;
+  uint64_t u64Start;
+  uint64_t u64Sequential;
+  uint64_t u64Bytes;
+  bool bValid;
+
+  if(argc > 1) {
+    g_u32ByteNs = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+
+  memset(atRequest, 0, sizeof(atRequest));
+  atRequest[0].u32Freq = 10000000;
+  atRequest[1].u32Freq = 12288000;
+  atRequest[2].u32Freq = 27000000;
+  for(u32Device = 0; u32Device < BENCH_DEVICES; u32Device++) {
+    g_aoSi5351[u32Device].initialize(
+      g_atCallback[u32Device % BENCH_BUSES].tBeginTransmission,
+      g_atCallback[u32Device % BENCH_BUSES].tRequestFrom,
+      g_atCallback[u32Device % BENCH_BUSES].tRead,
+      g_atCallback[u32Device % BENCH_BUSES].tWrite,
+      g_atCallback[u32Device % BENCH_BUSES].tEndTransmission,
+      Bench_MemoryBarrier, NULL
+    );
+    g_aoSi5351[u32Device].setAddress((uint8_t)(0x60 + u32Device / BENCH_BUSES));
+    g_aoSi5351[u32Device].attachCache(&g_atCache[u32Device]);
+    if(!Si5351_I2C::calcPlan(&g_atPlan[u32Device], SI5351_XTAL_FREQ, atRequest)) {
+      fprintf(stderr, "calcPlan failed\n");
+      return 1;
+    }
+  }
+
+  printf("%u buses, %u ns/byte, cold caches\n", BENCH_BUSES, g_u32ByteNs);
+  for(u32Index = 0; u32Index < sizeof(au32Devices) / sizeof(au32Devices[0]); u32Index++) {
+    Si5351_Fleet oFleet;
+
+    /* one after another */
+    Bench_Reset(au32Devices[u32Index]);
+    u64Start = Bench_Nanoseconds();
+    bValid = true;
+    for(u32Device = 0; u32Device < au32Devices[u32Index]; u32Device++) {
+      if(!g_aoSi5351[u32Device].setPlan(&g_atPlan[u32Device])) {
+        bValid = false;
+      }
+    }
+    u64Sequential = Bench_Nanoseconds() - u64Start;
+    u64Bytes = Bench_Bytes();
+    if(!bValid || !Bench_Check(au32Devices[u32Index])) {
+      fprintf(stderr, "sequential programming failed\n");
+      return 1;
+    }
+
+    /* fleet: one thread per bus */
+    for(u32Device = 0; u32Device < au32Devices[u32Index]; u32Device++) {
+      oFleet.add(g_aoSi5351[u32Device], (uint8_t)(u32Device % BENCH_BUSES));
+    }
+    Bench_Reset(au32Devices[u32Index]);
+    if(!oFleet.program(g_atPlan) || !Bench_Check(au32Devices[u32Index])) {
+      fprintf(stderr, "fleet programming failed\n");
+      return 1;
+    }
+    oFleet.getStats(&tStats);
+
+    printf("devices %2u  sequential %7.2f ms  fleet %7.2f ms (%u buses)  x%.2f  %5.0f bus bytes/device\n",
+      au32Devices[u32Index], u64Sequential / 1e6, tStats.u64TotalUs / 1e3, tStats.u8Buses,
+      (double)u64Sequential / 1e3 / (tStats.u64TotalUs ? tStats.u64TotalUs : 1),
+      (double)u64Bytes / au32Devices[u32Index]);
+  }
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+/* Si5351 lock stress benchmark (host) */
+/*
+  N threads, each with its own Si5351_t handle on one shared device and lock,
+  hammer read-modify-write setters for a fixed time.
+  Built once per lock backend (see Makefile):
+    bench_lock_spin   : check-then-set spin
+    bench_lock_atomic : SI5351_USE_ATOMIC_LOCK
+  Prints throughput, per-thread fairness and mutual exclusion violations
+  (another handle's bus access between a read and its write).
+  The clock starts once every thread runs. With SI5351_USE_ATOMIC_LOCK the
+  core calls tMemoryBarrier only while waiting, so here it also yields: a
+  queued waiter must get the CPU (one core hosts) to take its turn.
+
+  usage: bench_lock_xxx [threads] [milliseconds]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include "si5351.h"
+#include "bench_clock.h"
+
+#if defined(SI5351_USE_ATOMIC_LOCK)
+#define BENCH_LOCK "atomic"
+#else
+#define BENCH_LOCK "spin"
+#endif
+
+#define BENCH_THREADS_MAX 64
+
+typedef struct Bench_Thread_t_ {
+  pthread_t tThread;
+  Si5351_t  tSi5351;
+  uint64_t  u64Ops;
+} Bench_Thread_t;
+
+static uint8_t g_au8Register[256];
+static void* g_pLock;
+static void* volatile g_pInside;
+static atomic_uint_fast64_t g_u64Violations;
+static atomic_bool g_bRun;
+static atomic_uint g_u32Ready;
+
+static uint8_t Bench_Read(void* pInstance, const uint8_t u8Reg) {
+  g_pInside = pInstance;
+  return g_au8Register[u8Reg];
+}
+
+static void Bench_Write(void* pInstance, const uint8_t u8Reg, uint8_t u8Value) {
+  if(g_pInside != pInstance) {
+    atomic_fetch_add(&g_u64Violations, 1);
+  }
+  g_au8Register[u8Reg] = u8Value;
+}
+
+static void Bench_MemoryBarrier(void) {
+  atomic_thread_fence(memory_order_seq_cst);
+#if defined(SI5351_USE_ATOMIC_LOCK)
+  sched_yield();
+#endif
+}
+
+static void* Bench_Worker(void* pArg) {
+  Bench_Thread_t* ptThread = (Bench_Thread_t*)pArg;
+  bool bInvert = false;
+
+  atomic_fetch_add(&g_u32Ready, 1);
+  while(!atomic_load(&g_bRun)) {
+    sched_yield();
+  }
+  while(atomic_load(&g_bRun)) {
+    Si5351_SetClkInvert(&ptThread->tSi5351, SI5351_CLK0, bInvert);
+    bInvert = !bInvert;
+    ptThread->u64Ops++;
+  }
+
+  return NULL;
+}
+
+int main(int argc, char* argv[]) {
+  static Bench_Thread_t atThread[BENCH_THREADS_MAX];
+  uint32_t u32Threads = 4;
+  uint32_t u32Milliseconds = 500;
+  uint32_t u32Index;
+  uint64_t u64Nanoseconds;
+  uint64_t u64Total = 0;
+  uint64_t u64Min = UINT64_MAX;
+  uint64_t u64Max = 0;
+  double dSquare = 0;
+  struct timespec tSleep;
+
+  if(argc > 1) {
+    u32Threads = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+  if(argc > 2) {
+    u32Milliseconds = (uint32_t)strtoul(argv[2], NULL, 0);
+  }
+  if(u32Threads < 1 || u32Threads > BENCH_THREADS_MAX) {
+    fprintf(stderr, "threads: 1 - %d\n", BENCH_THREADS_MAX);
+    return 1;
+  }
+
+  for(u32Index = 0; u32Index < u32Threads; u32Index++) {
+    Si5351_Initialize(&atThread[u32Index].tSi5351, &atThread[u32Index], Bench_Read, Bench_Write, Bench_MemoryBarrier, &g_pLock);
+  }
+  for(u32Index = 0; u32Index < u32Threads; u32Index++) {
+    pthread_create(&atThread[u32Index].tThread, NULL, Bench_Worker, &atThread[u32Index]);
+  }
+  while(atomic_load(&g_u32Ready) < u32Threads) {
+    sched_yield();
+  }
+  u64Nanoseconds = Bench_Nanoseconds();
+  atomic_store(&g_bRun, true);
+  tSleep.tv_sec = u32Milliseconds / 1000;
+  tSleep.tv_nsec = (long)(u32Milliseconds % 1000) * 1000000;
+  nanosleep(&tSleep, NULL);
+  atomic_store(&g_bRun, false);
+  for(u32Index = 0; u32Index < u32Threads; u32Index++) {
+    pthread_join(atThread[u32Index].tThread, NULL);
+  }
+  u64Nanoseconds = Bench_Nanoseconds() - u64Nanoseconds;
+
+  for(u32Index = 0; u32Index < u32Threads; u32Index++) {
+    u64Total += atThread[u32Index].u64Ops;
+    dSquare += (double)atThread[u32Index].u64Ops * atThread[u32Index].u64Ops;
+    if(atThread[u32Index].u64Ops < u64Min) {
+      u64Min = atThread[u32Index].u64Ops;
+    }
+    if(atThread[u32Index].u64Ops > u64Max) {
+      u64Max = atThread[u32Index].u64Ops;
+    }
+  }
+
+  /* Jain's fairness index: 1.0 = equal share */
+  printf("%-6s threads %2u  %10.0f ops/s  %7.1f ns/op  fairness %.3f  min/max %.3f  violations %llu\n",
+    BENCH_LOCK, u32Threads,
+    (double)u64Total * 1e9 / u64Nanoseconds, (double)u64Nanoseconds / (u64Total ? u64Total : 1),
+    dSquare > 0 ? (double)u64Total * u64Total / (u32Threads * dSquare) : 0.0,
+    u64Max ? (double)u64Min / u64Max : 0.0,
+    (unsigned long long)atomic_load(&g_u64Violations));
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+/* Si5351 lock policy overhead benchmark (host) */
+/*
+  One thread, uncontended Si5351_SetClkInvert() (lock, read, write, unlock)
+  on a mock device for each lock policy. Prints per-call cost and the
+  overhead over Si5351_LockPolicyNone. Built once per spin backend (see Makefile).
+*/
+
+#include <stdio.h>
+#include <pthread.h>
+#include "si5351.h"
+#include "bench_clock.h"
+
+#if defined(SI5351_USE_ATOMIC_LOCK)
+#define BENCH_SPIN "spin (atomic)"
+#else
+#define BENCH_SPIN "spin"
+#endif
+
+#define BENCH_LOOPS 2000000
+
+static uint8_t g_au8Register[256];
+
+static uint8_t Bench_Read(void* pInstance, const uint8_t u8Reg) {
+  (void)pInstance;
+  return g_au8Register[u8Reg];
+}
+
+static void Bench_Write(void* pInstance, const uint8_t u8Reg, uint8_t u8Value) {
+  (void)pInstance;
+  g_au8Register[u8Reg] = u8Value;
+}
+
+static void Bench_MemoryBarrier(void) {
+  __sync_synchronize();
+}
+
+static double Bench_Run(Si5351_t* ptSi5351) {
+  uint64_t u64Nanoseconds;
+  uint32_t u32Loop;
+
+  u64Nanoseconds = Bench_Nanoseconds();
+  for(u32Loop = 0; u32Loop < BENCH_LOOPS; u32Loop++) {
+    Si5351_SetClkInvert(ptSi5351, SI5351_CLK0, (u32Loop & 1) ? true : false);
+  }
+  u64Nanoseconds = Bench_Nanoseconds() - u64Nanoseconds;
+
+  return (double)u64Nanoseconds / BENCH_LOOPS;
+}
+
+int main(void) {
+  static pthread_mutex_t tMutex = PTHREAD_MUTEX_INITIALIZER;
+  Si5351_t tSi5351;
+  void* pLock = NULL;
+  double dNone;
+  double dSpin;
+  double dPthread;
+
+  Si5351_Initialize(&tSi5351, &tSi5351, Bench_Read, Bench_Write, Bench_MemoryBarrier, NULL);
+  Bench_Run(&tSi5351);
+  dNone = Bench_Run(&tSi5351);
+
+  Si5351_Initialize(&tSi5351, &tSi5351, Bench_Read, Bench_Write, Bench_MemoryBarrier, &pLock);
+  dSpin = Bench_Run(&tSi5351);
+
+  Si5351_SetLockPolicy(&tSi5351, &Si5351_LockPolicyPthread, &tMutex);
+  dPthread = Bench_Run(&tSi5351);
+
+  printf("%-14s %6.1f ns/call\n", "none", dNone);
+  printf("%-14s %6.1f ns/call  +%5.1f ns\n", BENCH_SPIN, dSpin, dSpin - dNone);
+  printf("%-14s %6.1f ns/call  +%5.1f ns\n", "pthread", dPthread, dPthread - dNone);
+
+  return 0;
+}
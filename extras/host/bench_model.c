@@ -0,0 +1,123 @@
+/* Si5351 device model bus cost (host) */
+/*
+  Runs a start-up sequence and frequency hops through the C core against
+  Si5351_Model_t at 100 kHz, 400 kHz and 1 MHz SCL, prints bus transactions,
+  bytes and wire time per step, and the CLK frequencies the model decodes
+  from the written registers (exact rationals) against the request.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "si5351.h"
+#include "si5351_model.h"
+
+#define BENCH_HOPS 100
+
+static void Bench_MemoryBarrier(void) {
+}
+
+static void Bench_Step(Si5351_Model_t* ptModel, const char* pszStep, const uint32_t u32Calls) {
+  Si5351_ModelStats_t tStats;
+
+  Si5351_Model_GetStats(&tStats, ptModel);
+  printf("  %-24s %6.1f transactions %7.1f bytes %9.1f us  per call\n", pszStep,
+    (double)tStats.u32Transactions / u32Calls,
+    (double)(tStats.u64WriteBytes + tStats.u64ReadBytes) / u32Calls,
+    tStats.u64BusNs / 1e3 / u32Calls);
+  Si5351_Model_ResetStats(ptModel);
+}
+
+int main(void) {
+  static const uint32_t au32Bus[] = { SI5351_MODEL_BUS_100K, SI5351_MODEL_BUS_400K, SI5351_MODEL_BUS_1M };
+  Si5351_ModelConfig_t tConfig;
+  Si5351_Model_t tModel;
+  Si5351_ModelClk_t tClk;
+  Si5351_Cache_t tCache;
+  Si5351_t tSi5351;
+  Si5351_Status_t tStatus;
+  Si5351_PlanRequest_t atRequest[SI5351_CLKNUM];
+  Si5351_Plan_t tPlan;
+  Si5351_MS_t tMS;
+  char szText[64];
+  uint8_t u8Status;
+  uint32_t u32Index;
+  uint32_t u32Polls;
+  uint32_t u32Hop;
+  uint8_t u8CLKNo;
+
+  memset(atRequest, 0, sizeof(atRequest));
+  atRequest[0].u32Freq = 10000000;
+  atRequest[1].u32Freq = 12288000;
+  atRequest[2].u32Freq = 27000000;
+  if(!Si5351_CalcPlan(&tPlan, SI5351_XTAL_FREQ, atRequest)) {
+    fprintf(stderr, "CalcPlan failed\n");
+    return 1;
+  }
+
+  Si5351_Model_DefaultConfig(&tConfig);
+  tConfig.u8Type = SI5351_TYPE;
+  tConfig.u8ClkNum = SI5351_CLKNUM;
+  tConfig.u32XTALFreq = SI5351_XTAL_FREQ;
+  for(u32Index = 0; u32Index < sizeof(au32Bus) / sizeof(au32Bus[0]); u32Index++) {
+    tConfig.u32BusHz = au32Bus[u32Index];
+    if(
+      !Si5351_Model_Initialize(&tModel, &tConfig) ||
+      !Si5351_Initialize(&tSi5351, &tModel, Si5351_Model_Read, Si5351_Model_Write, Bench_MemoryBarrier, NULL) ||
+      !Si5351_SetReadBlock(&tSi5351, Si5351_Model_ReadBlock) ||
+      !Si5351_SetWriteBlock(&tSi5351, Si5351_Model_WriteBlock) ||
+      !Si5351_AttachCache(&tSi5351, &tCache)
+    ) {
+      fprintf(stderr, "initialize failed\n");
+      return 1;
+    }
+    printf("SCL %u Hz, %u byte blocks\n", tConfig.u32BusHz, tConfig.u8BlockMax);
+
+    /* SYS_INIT polled every 1 ms */
+    u32Polls = 0;
+    do {
+      Si5351_Model_Advance(&tModel, 1000000);
+      Si5351_GetStatus(&tStatus, &tSi5351);
+      u32Polls++;
+    } while(tStatus.bSYS_INIT);
+    Bench_Step(&tModel, "GetStatus (SYS_INIT)", u32Polls);
+
+    Si5351_InitDevice(&tSi5351);
+    Bench_Step(&tModel, "InitDevice", 1);
+    Si5351_SyncCache(&tSi5351);
+    Bench_Step(&tModel, "SyncCache", 1);
+    Si5351_SetPlan(&tSi5351, &tPlan);
+    Bench_Step(&tModel, "SetPlan", 1);
+
+    Si5351_Model_GetStatus(&u8Status, &tModel);
+    printf("  after SetPlan  LOL_A %u LOL_B %u", (u8Status & SI5351_MODEL_LOL_A) ? 1 : 0, (u8Status & SI5351_MODEL_LOL_B) ? 1 : 0);
+    Si5351_Model_Advance(&tModel, tConfig.u32LockNs);
+    Si5351_Model_GetStatus(&u8Status, &tModel);
+    printf("  lock time later LOL_A %u LOL_B %u  (virtual time %.3f ms)\n",
+      (u8Status & SI5351_MODEL_LOL_A) ? 1 : 0, (u8Status & SI5351_MODEL_LOL_B) ? 1 : 0,
+      Si5351_Model_GetTime(&tModel) / 1e6);
+    for(u8CLKNo = 0; u8CLKNo < SI5351_CLKNUM; u8CLKNo++) {
+      Si5351_Model_GetClk(&tClk, &tModel, u8CLKNo);
+      Si5351_Model_FormatClk(szText, sizeof(szText), &tClk);
+      printf("  CLK%u request %9u Hz  model %s\n", u8CLKNo, atRequest[u8CLKNo].u32Freq, szText);
+    }
+    Si5351_Model_ResetStats(&tModel);
+
+    /* 1 kHz steps on CLK0 from its VCO */
+    for(u32Hop = 0; u32Hop < BENCH_HOPS; u32Hop++) {
+#if defined(SI5351_USE_INTEGER_MATH)
+      Si5351_CalcMSClk(&tMS, tPlan.au32VCO[0], 10000000 + u32Hop * 1000);
+#elif defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
+      Si5351_CalcMSClk(&tMS, ui32_to_f64(tPlan.au32VCO[0]), ui32_to_f64(10000000 + u32Hop * 1000));
+#else
+      Si5351_CalcMSClk(&tMS, (double)tPlan.au32VCO[0], (double)(10000000 + u32Hop * 1000));
+#endif
+      Si5351_SetMS(&tSi5351, SI5351_CLK0, &tMS);
+    }
+    Bench_Step(&tModel, "SetMS (hop)", BENCH_HOPS);
+    Si5351_Model_GetClk(&tClk, &tModel, 0);
+    Si5351_Model_FormatClk(szText, sizeof(szText), &tClk);
+    printf("  CLK0 after hops %s\n", szText);
+  }
+
+  return 0;
+}
@@ -0,0 +1,198 @@
+/* Si5351 multi-device shared bus benchmark (host) */
+/*
+  Several chips (addresses 0x60 + n) on one mock bus.
+  sync  : one thread per chip retunes its CLK0 through its own Si5351_I2C,
+          the instances share the spin lock or one Si5351_Arbiter_t.
+  async : one producer per chip posts frequency hops, either to per-chip
+          Si5351_Async workers sharing the arbiter, or to queues attached
+          to one Si5351_AsyncBus.
+  Prints operations/s, per-chip fairness (Jain index, 1.0 = equal) and the
+  share of time the bus was transferring.
+
+  usage: bench_multi [milliseconds] [ns per bus byte]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define BENCH_DEVICES 4
+
+#include "si5351_async.h"
+#include "bench_clock.h"
+#include "bench_bus.h"
+
+#define BENCH_VCO 800000000
+#define BENCH_FREQ 10000000
+
+static std::atomic<bool> g_bRun;
+static std::atomic<uint64_t> g_au64Done[BENCH_DEVICES];
+static Si5351_I2C g_aoSi5351[BENCH_DEVICES];
+static Si5351_Cache_t g_atCache[BENCH_DEVICES];
+static Si5351_Arbiter_t g_tArbiter;
+static void* g_pLock;
+
+static void Bench_Yield(void) {
+  sched_yield();
+}
+
+static void Bench_Done(void* pUser, const bool bResult) {
+  (void)bResult;
+  ((std::atomic<uint64_t>*)pUser)->fetch_add(1, std::memory_order_relaxed);
+}
+
+/* bArbiter : shared Si5351_Arbiter_t, otherwise the spin lock (NULL : no lock) */
+static void Bench_Setup(const uint32_t u32Devices, const bool bLock, const bool bArbiter) {
+  uint32_t u32Device;
+
+  memset(g_aau8Register, 0, sizeof(g_aau8Register));
+  g_pLock = NULL;
+  Si5351_InitArbiter(&g_tArbiter, Bench_Yield);
+  for(u32Device = 0; u32Device < u32Devices; u32Device++) {
+    g_aoSi5351[u32Device].initialize(
+      Bench_BeginTransmission, Bench_RequestFrom, Bench_Read, Bench_Write, Bench_EndTransmission,
+      Bench_MemoryBarrier, bLock ? &g_pLock : NULL
+    );
+    g_aoSi5351[u32Device].setAddress((uint8_t)(0x60 + u32Device));
+    g_aoSi5351[u32Device].attachCache(&g_atCache[u32Device]);
+    if(bArbiter) {
+      g_aoSi5351[u32Device].setLockPolicy(&Si5351_LockPolicyArbiter, &g_tArbiter);
+    }
+    g_au64Done[u32Device].store(0);
+  }
+  g_u64Bytes.store(0);
+}
+
+static void Bench_Direct(const uint32_t u32Device) {
+  Si5351_MS_t tMS;
+  uint32_t u32Loop = 0;
+
+  while(g_bRun.load(std::memory_order_relaxed)) {
+    Si5351_I2C::calcMSClk(&tMS, BENCH_VCO, BENCH_FREQ + (u32Loop++ % 1000) * 10);
+    g_aoSi5351[u32Device].setMS(SI5351_CLK0, &tMS);
+    g_au64Done[u32Device].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+static void Bench_Post(Si5351_Async* poAsync, const uint32_t u32Device) {
+  Si5351_AsyncCommand_t tCommand;
+  uint32_t u32Loop = 0;
+
+  memset(&tCommand, 0, sizeof(tCommand));
+  tCommand.tType = SI5351_ASYNC_FREQUENCY;
+  tCommand.tCLKNo = SI5351_CLK0;
+  tCommand.u32VCO = BENCH_VCO;
+  while(g_bRun.load(std::memory_order_relaxed)) {
+    tCommand.u32Freq = BENCH_FREQ + (u32Loop++ % 1000) * 10;
+    if(!poAsync->post(&tCommand, Bench_Done, &g_au64Done[u32Device])) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+static void Bench_Report(const char* pszMode, const uint32_t u32Devices, const uint64_t u64Nanoseconds) {
+  uint32_t u32Device;
+  double dSum = 0;
+  double dSquares = 0;
+  double dDone;
+
+  for(u32Device = 0; u32Device < u32Devices; u32Device++) {
+    dDone = (double)g_au64Done[u32Device].load();
+    dSum += dDone;
+    dSquares += dDone * dDone;
+  }
+  printf("%-14s chips %u  %9.0f ops/s  fairness %.3f  bus busy %5.1f%%\n",
+    pszMode, u32Devices, dSum * 1e9 / u64Nanoseconds,
+    dSquares ? dSum * dSum / (u32Devices * dSquares) : 0.0,
+    100.0 * g_u64Bytes.load() * g_u32ByteNs / u64Nanoseconds);
+}
+
+static void Bench_Run(const uint32_t u32Milliseconds) {
+  g_bRun.store(true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(u32Milliseconds));
+  g_bRun.store(false);
+}
+
+int main(int argc, char* argv[]) {
+  static const uint32_t au32Devices[] = { 2, 4 };
+  uint32_t u32Milliseconds = 300;
+  uint32_t u32Index;
+  uint32_t u32Device;
+  uint32_t u32Devices;
+  uint32_t u32Mode;
+  uint64_t u64Nanoseconds;
+  std::vector<std::thread> aoThread;
+
+  if(argc > 1) {
+    u32Milliseconds = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+  if(argc > 2) {
+    g_u32ByteNs = (uint32_t)strtoul(argv[2], NULL, 0);
+  }
+  printf("bus %u ns/byte, %u ms per run\n", g_u32ByteNs, u32Milliseconds);
+
+  for(u32Index = 0; u32Index < sizeof(au32Devices) / sizeof(au32Devices[0]); u32Index++) {
+    u32Devices = au32Devices[u32Index];
+
+    /* sync: spin lock vs arbiter */
+    for(u32Mode = 0; u32Mode < 2; u32Mode++) {
+      Bench_Setup(u32Devices, true, u32Mode ? true : false);
+      u64Nanoseconds = Bench_Nanoseconds();
+      g_bRun.store(true);
+      for(u32Device = 0; u32Device < u32Devices; u32Device++) {
+        aoThread.push_back(std::thread(Bench_Direct, u32Device));
+      }
+      Bench_Run(u32Milliseconds);
+      for(u32Device = 0; u32Device < aoThread.size(); u32Device++) {
+        aoThread[u32Device].join();
+      }
+      aoThread.clear();
+      Bench_Report(u32Mode ? "sync arbiter" : "sync spin", u32Devices, Bench_Nanoseconds() - u64Nanoseconds);
+    }
+
+    /* async: per-chip workers on the arbiter vs one bus worker */
+    for(u32Mode = 0; u32Mode < 2; u32Mode++) {
+      std::vector<Si5351_Async*> apoAsync;
+      Si5351_AsyncBus oBus;
+
+      Bench_Setup(u32Devices, u32Mode ? false : true, u32Mode ? false : true);
+      for(u32Device = 0; u32Device < u32Devices; u32Device++) {
+        apoAsync.push_back(new Si5351_Async(g_aoSi5351[u32Device]));
+        if(u32Mode) {
+          oBus.attach(*apoAsync[u32Device]);
+        } else {
+          apoAsync[u32Device]->start();
+        }
+      }
+      if(u32Mode) {
+        oBus.start();
+      }
+      u64Nanoseconds = Bench_Nanoseconds();
+      g_bRun.store(true);
+      for(u32Device = 0; u32Device < u32Devices; u32Device++) {
+        aoThread.push_back(std::thread(Bench_Post, apoAsync[u32Device], u32Device));
+      }
+      Bench_Run(u32Milliseconds);
+      for(u32Device = 0; u32Device < aoThread.size(); u32Device++) {
+        aoThread[u32Device].join();
+      }
+      aoThread.clear();
+      if(u32Mode) {
+        oBus.stop();
+      }
+      for(u32Device = 0; u32Device < u32Devices; u32Device++) {
+        apoAsync[u32Device]->stop();
+      }
+      Bench_Report(u32Mode ? "async bus" : "async workers", u32Devices, Bench_Nanoseconds() - u64Nanoseconds);
+      for(u32Device = 0; u32Device < u32Devices; u32Device++) {
+        delete apoAsync[u32Device];
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,131 @@
+/* Si5351 asynchronous queue priority benchmark (host) */
+/*
+  While a BULK producer keeps rewriting the whole register map (Reg.16-183)
+  with SI5351_ASYNC_WRITE_REGISTERS, an URGENT producer hops CLK0 every
+  300us and a NORMAL producer moves a phase offset every 1ms.
+  For several step sizes prints the queueing latency per class
+  (post to start of execution) and the bulk reconfigure rate.
+
+  usage: bench_priority [milliseconds] [ns per bus byte]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include "si5351_async.h"
+#include "bench_clock.h"
+#include "bench_bus.h"
+
+#define BENCH_CONFIG_REG   16
+#define BENCH_CONFIG_COUNT (0xB7 - BENCH_CONFIG_REG + 1)
+
+static std::atomic<bool> g_bRun;
+static uint8_t g_au8Config[BENCH_CONFIG_COUNT];
+
+static void Bench_Bulk(Si5351_Async* poAsync, uint32_t* pu32Configs) {
+  Si5351_AsyncCommand_t tCommand;
+  std::future<bool> oDone;
+
+  memset(&tCommand, 0, sizeof(tCommand));
+  tCommand.tType = SI5351_ASYNC_WRITE_REGISTERS;
+  tCommand.tPriority = SI5351_ASYNC_BULK;
+  tCommand.u8Reg = BENCH_CONFIG_REG;
+  tCommand.u8Count = BENCH_CONFIG_COUNT;
+  tCommand.pu8Data = g_au8Config;
+  while(g_bRun.load(std::memory_order_relaxed)) {
+    oDone = poAsync->submit(&tCommand);
+    if(oDone.valid() && oDone.get()) {
+      (*pu32Configs)++;
+    }
+  }
+}
+
+static void Bench_Periodic(Si5351_Async* poAsync, const Si5351_AsyncCommand_t* ptCommand, const uint32_t u32PeriodUs) {
+  Si5351_AsyncCommand_t tCommand = *ptCommand;
+  uint32_t u32Loop = 0;
+
+  while(g_bRun.load(std::memory_order_relaxed)) {
+    tCommand.u32Freq = ptCommand->u32Freq + (u32Loop % 100) * 10;
+    tCommand.u8Value = (uint8_t)(u32Loop % 100);
+    u32Loop++;
+    poAsync->post(&tCommand);
+    std::this_thread::sleep_for(std::chrono::microseconds(u32PeriodUs));
+  }
+}
+
+int main(int argc, char* argv[]) {
+  static const uint8_t au8Chunk[] = { 0, 32, 16, 8, 4 };
+  static const char* const apszClass[SI5351_ASYNC_PRIORITIES] = { "normal", "urgent", "bulk" };
+  static Si5351_Cache_t tCache;
+  static Si5351_I2C oSi5351;
+  uint32_t u32Milliseconds = 500;
+  uint32_t u32Index;
+  uint32_t u32Configs;
+  uint8_t u8Priority;
+  Si5351_AsyncCommand_t tUrgent;
+  Si5351_AsyncCommand_t tNormal;
+  Si5351_AsyncStats_t tStats;
+
+  if(argc > 1) {
+    u32Milliseconds = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+  if(argc > 2) {
+    g_u32ByteNs = (uint32_t)strtoul(argv[2], NULL, 0);
+  }
+  printf("bus %u ns/byte, %u ms per run, bulk %u registers\n", g_u32ByteNs, u32Milliseconds, BENCH_CONFIG_COUNT);
+
+  for(u32Index = 0; u32Index < BENCH_CONFIG_COUNT; u32Index++) {
+    g_au8Config[u32Index] = (uint8_t)(u32Index * 37);
+  }
+  memset(&tUrgent, 0, sizeof(tUrgent));
+  tUrgent.tType = SI5351_ASYNC_FREQUENCY;
+  tUrgent.tPriority = SI5351_ASYNC_URGENT;
+  tUrgent.tCLKNo = SI5351_CLK0;
+  tUrgent.u32VCO = 800000000;
+  tUrgent.u32Freq = 10000000;
+  memset(&tNormal, 0, sizeof(tNormal));
+  tNormal.tType = SI5351_ASYNC_PHASE_OFFSET;
+  tNormal.tPriority = SI5351_ASYNC_NORMAL;
+  tNormal.tCLKNo = SI5351_CLK1;
+
+  for(u32Index = 0; u32Index < sizeof(au8Chunk); u32Index++) {
+    Si5351_Async oAsync(oSi5351);
+
+    oSi5351.initialize(
+      Bench_BeginTransmission, Bench_RequestFrom, Bench_Read, Bench_Write, Bench_EndTransmission,
+      Bench_MemoryBarrier, NULL
+    );
+    oSi5351.attachCache(&tCache);
+    oAsync.setChunk(au8Chunk[u32Index]);
+    oAsync.start();
+    u32Configs = 0;
+    g_bRun.store(true);
+    std::thread oBulk(Bench_Bulk, &oAsync, &u32Configs);
+    std::thread oUrgent(Bench_Periodic, &oAsync, &tUrgent, 300);
+    std::thread oNormal(Bench_Periodic, &oAsync, &tNormal, 1000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(u32Milliseconds));
+    g_bRun.store(false);
+    oBulk.join();
+    oUrgent.join();
+    oNormal.join();
+    oAsync.stop();
+    oAsync.getStats(&tStats);
+
+    if(au8Chunk[u32Index]) {
+      printf("step %3u regs:", au8Chunk[u32Index]);
+    } else {
+      printf("no split     :");
+    }
+    for(u8Priority = SI5351_ASYNC_NORMAL; u8Priority < SI5351_ASYNC_PRIORITIES; u8Priority++) {
+      printf("  %s worst %5u us mean %6.1f us",
+        apszClass[u8Priority], tStats.atLatency[u8Priority].u32WorstUs,
+        tStats.atLatency[u8Priority].u32Count ?
+          (double)tStats.atLatency[u8Priority].u64TotalUs / tStats.atLatency[u8Priority].u32Count : 0.0);
+    }
+    printf("  bulk %5.1f/s\n", u32Configs * 1000.0 / u32Milliseconds);
+  }
+
+  return 0;
+}
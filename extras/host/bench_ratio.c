@@ -0,0 +1,49 @@
+/* Si5351 best rational divider search benchmark (host) */
+/*
+  Si5351_CalcMSRatio() over a sweep of PLL ratios (25MHz to 600MHz - 900MHz)
+  for several early exit bounds. Prints per-call cost and the achieved error.
+*/
+
+#include <stdio.h>
+#include "si5351.h"
+#include "bench_clock.h"
+
+#define BENCH_LOOPS 200000
+
+static volatile uint32_t g_u32Sink;
+
+int main(void) {
+  static const uint32_t au32PPB[] = { 0, 1, 10, 1000 };
+  Si5351_MS_t tMS;
+  int32_t i32Err;
+  uint32_t u32Abs;
+  uint32_t u32Worst;
+  uint64_t u64Sum;
+  uint64_t u64Cycles;
+  uint64_t u64Nanoseconds;
+  uint32_t u32Loop;
+  uint8_t u8Bound;
+
+  for(u8Bound = 0; u8Bound < sizeof(au32PPB) / sizeof(au32PPB[0]); u8Bound++) {
+    u32Worst = 0;
+    u64Sum = 0;
+    u64Nanoseconds = Bench_Nanoseconds();
+    u64Cycles = Bench_Cycles();
+    for(u32Loop = 0; u32Loop < BENCH_LOOPS; u32Loop++) {
+      Si5351_CalcMSRatio(&tMS, &i32Err, 600000000 + (uint64_t)u32Loop * 1499, 25000000, au32PPB[u8Bound]);
+      g_u32Sink += tMS.u32MSX_P2;
+      u32Abs = (uint32_t)(i32Err < 0 ? -i32Err : i32Err);
+      u64Sum += u32Abs;
+      if(u32Abs > u32Worst) {
+        u32Worst = u32Abs;
+      }
+    }
+    u64Cycles = Bench_Cycles() - u64Cycles;
+    u64Nanoseconds = Bench_Nanoseconds() - u64Nanoseconds;
+    printf("CalcMSRatio ppb<=%-5u %8.1f cycles/call %8.1f ns/call  error mean %6.2f worst %u ppb\n",
+      au32PPB[u8Bound], (double)u64Cycles / BENCH_LOOPS, (double)u64Nanoseconds / BENCH_LOOPS,
+      (double)u64Sum / BENCH_LOOPS, u32Worst);
+  }
+
+  return 0;
+}
@@ -0,0 +1,366 @@
+/* Si5351 benchmark suite: divider math and register traffic (host) */
+/*
+  Built once per math path (see Makefile):
+    bench_suite_double : double
+    bench_suite_int    : SI5351_USE_INTEGER_MATH
+
+  calc   : every Calc/Decalc function, calls per second
+  bus    : every Si5351_I2C setter on Si5351_Model_t through its Wire
+           interface, no cache (read-modify-write on the bus)
+  cache  : the same with a synced register cache and write elision
+
+  Setter arguments alternate so each call changes the device; the
+  set/clear bits and enable/disable rows alternate with their counterpart,
+  the row names the call of the even iterations. Per row:
+  calls per second (host CPU, driver and model), failed calls, and from
+  the model, bus transactions, bytes (address, register, data) and wire
+  time at 400 kHz per call.
+
+  usage: bench_suite [text|csv|json] [loops]
+  csv and json go to stdout for regression tracking (make suite).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "si5351_i2c.h"
+#include "si5351_model.h"
+#include "bench_clock.h"
+
+#if defined(SI5351_USE_INTEGER_MATH)
+#define BENCH_PATH "integer"
+typedef uint32_t Bench_Freq_t;
+#else
+#define BENCH_PATH "double"
+typedef double Bench_Freq_t;
+#endif
+
+#define BENCH_RESULT_MAX 96
+
+typedef enum Bench_Format_t_ {
+  BENCH_FORMAT_TEXT = 0,
+  BENCH_FORMAT_CSV,
+  BENCH_FORMAT_JSON
+} Bench_Format_t;
+
+typedef struct Bench_Result_t_ {
+  const char* pszSuite;
+  const char* pszName;
+  uint32_t    u32Calls;
+  uint32_t    u32Fails;
+  uint64_t    u64Ns;
+  Si5351_ModelStats_t tStats;
+} Bench_Result_t;
+
+static Si5351_Model_t g_tModel;
+static Bench_Result_t g_atResult[BENCH_RESULT_MAX];
+static uint32_t g_u32Results;
+static volatile uint32_t g_u32Sink;
+
+/* Wire-style transport on the model */
+static void Bench_BeginTransmission(const uint8_t u8Address) {
+  Si5351_Model_BeginTransmission(&g_tModel, u8Address);
+}
+
+static void Bench_RequestFrom(const uint8_t u8Address, const uint8_t u8Count) {
+  Si5351_Model_RequestFrom(&g_tModel, u8Address, u8Count);
+}
+
+static uint8_t Bench_Read(const uint8_t u8Address) {
+  (void)u8Address;
+  return Si5351_Model_ReadByte(&g_tModel);
+}
+
+static void Bench_Write(const uint8_t u8Value) {
+  Si5351_Model_WriteByte(&g_tModel, u8Value);
+}
+
+static void Bench_EndTransmission(void) {
+  Si5351_Model_EndTransmission(&g_tModel);
+}
+
+static void Bench_MemoryBarrier(void) {
+}
+
+static void Bench_Record(const char* pszSuite, const char* pszName, const uint32_t u32Calls, const uint32_t u32Fails, const uint64_t u64Ns) {
+  Bench_Result_t* ptResult;
+
+  if(g_u32Results < BENCH_RESULT_MAX) {
+    ptResult = &g_atResult[g_u32Results++];
+    ptResult->pszSuite = pszSuite;
+    ptResult->pszName = pszName;
+    ptResult->u32Calls = u32Calls;
+    ptResult->u32Fails = u32Fails;
+    ptResult->u64Ns = u64Ns ? u64Ns : 1;
+    Si5351_Model_GetStats(&ptResult->tStats, &g_tModel);
+  }
+}
+
+/* expr returns bool; i : loop index */
+#define BENCH_RUN(pszSuite, pszName, u32Count, expr) do { \
+    uint32_t u32Fails = 0; \
+    uint64_t u64Start; \
+    Si5351_Model_ResetStats(&g_tModel); \
+    u64Start = Bench_Nanoseconds(); \
+    for(i = 0; i < (u32Count); i++) { \
+      if(!(expr)) { \
+        u32Fails++; \
+      } \
+    } \
+    Bench_Record(pszSuite, pszName, u32Count, u32Fails, Bench_Nanoseconds() - u64Start); \
+  } while(0)
+
+static void Bench_Calc(const uint32_t u32Loops) {
+  static const Bench_Freq_t atClk[2] = { 10000000, 12288000 };
+  Si5351_MS_t tMS;
+  Si5351_MS_t tPLL;
+  Si5351_SSP_t tSSP;
+  Si5351_Plan_t tPlan;
+  Si5351_PlanRequest_t atRequest[SI5351_CLKNUM];
+  Bench_Freq_t tOutput;
+  int32_t i32ErrPPB;
+  uint32_t i;
+#if SI5351_CLKNUM > 3
+  uint8_t u8MS;
+  Si5351_MS_DIV_t tDIV;
+#endif
+#if SI5351_TYPE == 1
+  uint32_t u32VCXO;
+#endif
+
+  /* PLL: 600MHz - 900MHz, Clk: 1MHz - 100MHz from 800MHz */
+  BENCH_RUN("calc", "CalcMSPLL", u32Loops,
+    (Si5351_CalcMSPLL(&tMS, SI5351_XTAL_FREQ, 600000000 + i % 200000 * 1499) && (g_u32Sink += tMS.u32MSX_P2, true)));
+  BENCH_RUN("calc", "CalcMSPLLEx", u32Loops,
+    (Si5351_CalcMSPLLEx(&tMS, &i32ErrPPB, SI5351_XTAL_FREQ, 600000000 + i % 200000 * 1499, 0) && (g_u32Sink += tMS.u32MSX_P2, true)));
+  Si5351_CalcMSPLL(&tPLL, SI5351_XTAL_FREQ, 800000000);
+  BENCH_RUN("calc", "DecalcMSPLL", u32Loops,
+    (Si5351_DecalcMSPLL(&tOutput, SI5351_XTAL_FREQ, &tPLL) && (g_u32Sink += (uint32_t)tOutput, true)));
+  BENCH_RUN("calc", "CalcMSClk", u32Loops,
+    (Si5351_CalcMSClk(&tMS, 800000000, 1000000 + i % 200000 * 495) && (g_u32Sink += tMS.u32MSX_P2, true)));
+  BENCH_RUN("calc", "CalcMSClkEx", u32Loops,
+    (Si5351_CalcMSClkEx(&tMS, &i32ErrPPB, 800000000, 1000000 + i % 200000 * 495, 0) && (g_u32Sink += tMS.u32MSX_P2, true)));
+  Si5351_CalcMSClk(&tMS, 800000000, atClk[1]);
+  BENCH_RUN("calc", "DecalcMSClk", u32Loops,
+    (Si5351_DecalcMSClk(&tOutput, 800000000, &tMS) && (g_u32Sink += (uint32_t)tOutput, true)));
+  BENCH_RUN("calc", "CalcMSRatio", u32Loops,
+    (Si5351_CalcMSRatio(&tMS, &i32ErrPPB, 800000000, 1000000 + i % 200000 * 495, 0) && (g_u32Sink += tMS.u32MSX_P2, true)));
+  /* down spread 0.1% - 2.5% on a 800MHz PLL */
+#if defined(SI5351_USE_INTEGER_MATH)
+  BENCH_RUN("calc", "CalcSSP", u32Loops,
+    (Si5351_CalcSSP(&tSSP, SI5351_SSP_MODE_DOWN, SI5351_XTAL_FREQ, &tPLL, (uint16_t)(1000 + i % 24001)) && (g_u32Sink += tSSP.u16SSDN_P1, true)));
+#else
+  BENCH_RUN("calc", "CalcSSP", u32Loops,
+    (Si5351_CalcSSP(&tSSP, SI5351_SSP_MODE_DOWN, SI5351_XTAL_FREQ, 32.0, -0.001 - (i % 24001) * 1e-6) && (g_u32Sink += tSSP.u16SSDN_P1, true)));
+#endif
+#if SI5351_CLKNUM > 3
+  BENCH_RUN("calc", "CalcMS67", u32Loops,
+    (Si5351_CalcMS67(&u8MS, &tDIV, &i32ErrPPB, 800000000, 1000000 + i % 200000 * 495) && (g_u32Sink += u8MS, true)));
+#endif
+#if SI5351_TYPE == 1
+#if defined(SI5351_USE_INTEGER_MATH)
+  BENCH_RUN("calc", "CalcVCXO", u32Loops,
+    (Si5351_CalcVCXO(&u32VCXO, &tPLL, (uint8_t)(30 + i % 211)) && (g_u32Sink += u32VCXO, true)));
+#else
+  BENCH_RUN("calc", "CalcVCXO", u32Loops,
+    (Si5351_CalcVCXO(&u32VCXO, 32.0, (uint8_t)(30 + i % 211)) && (g_u32Sink += u32VCXO, true)));
+#endif
+#endif
+  /* three outputs, the last one moving */
+  memset(atRequest, 0, sizeof(atRequest));
+  atRequest[0].u32Freq = 10000000;
+  atRequest[1].u32Freq = 12288000;
+  BENCH_RUN("calc", "CalcPlan", u32Loops / 100,
+    (atRequest[2].u32Freq = 1000000 + i * 4999, Si5351_CalcPlan(&tPlan, SI5351_XTAL_FREQ, atRequest)));
+}
+
+static bool Bench_Setters(const char* pszSuite, Si5351_I2C& roSi5351, const uint32_t u32Loops) {
+  static const uint8_t au8Block[8] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 };
+  Si5351_MS_t atPLL[2];
+  Si5351_MS_t atMS[2];
+  Si5351_SSP_t atSSP[2];
+  Si5351_Status_t atStatus[2];
+  Si5351_Plan_t atPlan[2];
+  Si5351_PlanRequest_t atRequest[SI5351_CLKNUM];
+  uint32_t i;
+
+  memset(atRequest, 0, sizeof(atRequest));
+  memset(atStatus, 0, sizeof(atStatus));
+  atStatus[1].bSYS_INIT = true;
+  atRequest[0].u32Freq = 10000000;
+  atRequest[1].u32Freq = 12288000;
+  atRequest[2].u32Freq = 27000000;
+  if(
+    !Si5351_CalcMSPLL(&atPLL[0], SI5351_XTAL_FREQ, 800000000) ||
+    !Si5351_CalcMSPLL(&atPLL[1], SI5351_XTAL_FREQ, 800000100) ||
+    !Si5351_CalcMSClk(&atMS[0], 800000000, 10000000) ||
+    !Si5351_CalcMSClk(&atMS[1], 800000000, 10000100) ||
+#if defined(SI5351_USE_INTEGER_MATH)
+    !Si5351_CalcSSP(&atSSP[0], SI5351_SSP_MODE_DOWN, SI5351_XTAL_FREQ, &atPLL[0], 5000) ||
+    !Si5351_CalcSSP(&atSSP[1], SI5351_SSP_MODE_DOWN, SI5351_XTAL_FREQ, &atPLL[0], 10000) ||
+#else
+    !Si5351_CalcSSP(&atSSP[0], SI5351_SSP_MODE_DOWN, SI5351_XTAL_FREQ, 32.0, -0.005) ||
+    !Si5351_CalcSSP(&atSSP[1], SI5351_SSP_MODE_DOWN, SI5351_XTAL_FREQ, 32.0, -0.01) ||
+#endif
+    !Si5351_CalcPlan(&atPlan[0], SI5351_XTAL_FREQ, atRequest)
+  ) {
+    return false;
+  }
+  atRequest[2].u32Freq = 25000000;
+  if(!Si5351_CalcPlan(&atPlan[1], SI5351_XTAL_FREQ, atRequest)) {
+    return false;
+  }
+
+  BENCH_RUN(pszSuite, "initDevice", u32Loops / 10, roSi5351.initDevice());
+  BENCH_RUN(pszSuite, "getStatus", u32Loops, roSi5351.getStatus(&atStatus[0]));
+  BENCH_RUN(pszSuite, "setStickyStatus", u32Loops, roSi5351.setStickyStatus(&atStatus[i & 1]));
+  BENCH_RUN(pszSuite, "setStatusMask", u32Loops, roSi5351.setStatusMask(&atStatus[i & 1]));
+  BENCH_RUN(pszSuite, "writeRegisters", u32Loops, roSi5351.writeRegisters((uint8_t)(42 + (i & 1)), au8Block, sizeof(au8Block)));
+  BENCH_RUN(pszSuite, "updateRegister", u32Loops, roSi5351.updateRegister(165, 0x7F, (uint8_t)(i & 0x7F)));
+  BENCH_RUN(pszSuite, "setRegisterBits", u32Loops, (i & 1) ?
+    roSi5351.clearRegisterBits(166, (uint8_t)(1 << ((i >> 1) & 7))) : roSi5351.setRegisterBits(166, (uint8_t)(1 << ((i >> 1) & 7))));
+  BENCH_RUN(pszSuite, "clearRegisterBits", u32Loops, (i & 1) ?
+    roSi5351.setRegisterBits(166, (uint8_t)(1 << ((i >> 1) & 7))) : roSi5351.clearRegisterBits(166, (uint8_t)(1 << ((i >> 1) & 7))));
+  BENCH_RUN(pszSuite, "toggleRegisterBits", u32Loops, roSi5351.toggleRegisterBits(167, 0x01));
+  BENCH_RUN(pszSuite, "setOutputEnable", u32Loops, (i & 1) ?
+    roSi5351.setOutputDisable((uint8_t)(1 << ((i >> 1) % SI5351_CLKNUM))) : roSi5351.setOutputEnable((uint8_t)(1 << ((i >> 1) % SI5351_CLKNUM))));
+  BENCH_RUN(pszSuite, "setOutputDisable", u32Loops, (i & 1) ?
+    roSi5351.setOutputEnable((uint8_t)(1 << ((i >> 1) % SI5351_CLKNUM))) : roSi5351.setOutputDisable((uint8_t)(1 << ((i >> 1) % SI5351_CLKNUM))));
+  BENCH_RUN(pszSuite, "setOutputControlMask", u32Loops, roSi5351.setOutputControlMask((uint8_t)(i & 1)));
+#if SI5351_TYPE == 2
+  BENCH_RUN(pszSuite, "setCLKIN_DIV", u32Loops, roSi5351.setCLKIN_DIV((Si5351_CLKIN_DIV_t)(i & 3)));
+#endif
+  /* XTAL / CLKIN (1 : CLKIN, Si5351C only, the model keeps the bit on every type) */
+  BENCH_RUN(pszSuite, "setPLLA_SRC", u32Loops, roSi5351.setPLLA_SRC((Si5351_PLL_SRC_t)(i & 1)));
+  BENCH_RUN(pszSuite, "setPLLB_SRC", u32Loops, roSi5351.setPLLB_SRC((Si5351_PLL_SRC_t)(i & 1)));
+  BENCH_RUN(pszSuite, "setClkPowerDown", u32Loops, roSi5351.setClkPowerDown((Si5351_CLKNo_t)(i % SI5351_CLKNUM), ((i / SI5351_CLKNUM) & 1) ? true : false));
+  BENCH_RUN(pszSuite, "setClkMSSource", u32Loops, roSi5351.setClkMSSource((Si5351_CLKNo_t)(i % SI5351_CLKNUM), (Si5351_CLK_MS_SRC_t)((i / SI5351_CLKNUM) & 1)));
+  BENCH_RUN(pszSuite, "setClkInvert", u32Loops, roSi5351.setClkInvert((Si5351_CLKNo_t)(i % SI5351_CLKNUM), ((i / SI5351_CLKNUM) & 1) ? true : false));
+  BENCH_RUN(pszSuite, "setClkSrc", u32Loops, roSi5351.setClkSrc((Si5351_CLKNo_t)(i % SI5351_CLKNUM), ((i / SI5351_CLKNUM) & 1) ? SI5351_CLK_SRC_MS : SI5351_CLK_SRC_XTAL));
+  BENCH_RUN(pszSuite, "setClkIDrive", u32Loops, roSi5351.setClkIDrive((Si5351_CLKNo_t)(i % SI5351_CLKNUM), (Si5351_CLK_IDRV_t)((i / SI5351_CLKNUM) & 3)));
+  BENCH_RUN(pszSuite, "setClkDisableState", u32Loops, roSi5351.setClkDisableState((Si5351_CLKNo_t)(i % SI5351_CLKNUM), (Si5351_CLK_DIS_STATE_t)((i / SI5351_CLKNUM) & 3)));
+  BENCH_RUN(pszSuite, "setMSA", u32Loops, roSi5351.setMSA(&atPLL[i & 1]));
+  BENCH_RUN(pszSuite, "setMSB", u32Loops, roSi5351.setMSB(&atPLL[i & 1]));
+  BENCH_RUN(pszSuite, "setMS", u32Loops, roSi5351.setMS((Si5351_CLKNo_t)(i % 3), &atMS[i & 1]));
+#if SI5351_CLKNUM > 3
+  BENCH_RUN(pszSuite, "setMS67", u32Loops, roSi5351.setMS67((Si5351_CLKNo_t)(6 + (i & 1)), (uint8_t)(100 + (i & 2)), (Si5351_MS_DIV_t)(i & 3)));
+  BENCH_RUN(pszSuite, "setMS67Divider", u32Loops, roSi5351.setMS67Divider((Si5351_CLKNo_t)(6 + (i & 1)), (uint8_t)(100 + (i & 2))));
+#endif
+  BENCH_RUN(pszSuite, "retuneMSA", u32Loops, roSi5351.retuneMSA(&atPLL[i & 1], &atPLL[(i + 1) & 1]));
+  BENCH_RUN(pszSuite, "retuneMSB", u32Loops, roSi5351.retuneMSB(&atPLL[i & 1], &atPLL[(i + 1) & 1]));
+  BENCH_RUN(pszSuite, "retuneMS", u32Loops, roSi5351.retuneMS(SI5351_CLK0, &atMS[i & 1], &atMS[(i + 1) & 1]));
+  BENCH_RUN(pszSuite, "setSSPEnable/Disable", u32Loops, (i & 1) ? roSi5351.setSSPDisable() : roSi5351.setSSPEnable());
+  BENCH_RUN(pszSuite, "setSSP", u32Loops, roSi5351.setSSP(&atSSP[i & 1]));
+#if SI5351_TYPE == 1
+  BENCH_RUN(pszSuite, "setVCXO", u32Loops, roSi5351.setVCXO(1000 + (i & 1)));
+#endif
+  BENCH_RUN(pszSuite, "setPhaseOffset", u32Loops, roSi5351.setPhaseOffset((Si5351_CLKNo_t)(i % 3), (uint8_t)(i & 0x7F)));
+  BENCH_RUN(pszSuite, "PLLSoftReset", u32Loops, roSi5351.PLLSoftReset());
+  BENCH_RUN(pszSuite, "setXTALLoadCap", u32Loops, roSi5351.setXTALLoadCap((i & 1) ? SI5351_XTALLOADCAP_8PF : SI5351_XTALLOADCAP_10PF));
+  BENCH_RUN(pszSuite, "setPlan", u32Loops / 10, roSi5351.setPlan(&atPlan[i & 1]));
+
+  return true;
+}
+
+static void Bench_Print(const Bench_Format_t tFormat) {
+  const Bench_Result_t* ptResult;
+  double dNsPerCall;
+  double dCallsPerSec;
+  double dTransactions;
+  double dBytes;
+  double dBusUs;
+  uint32_t u32Index;
+
+  if(tFormat == BENCH_FORMAT_CSV) {
+    printf("path,type,clknum,bus_hz,suite,name,calls,fails,ns_per_call,calls_per_s,transactions_per_op,bytes_per_op,bus_us_per_op\n");
+  } else if(tFormat == BENCH_FORMAT_JSON) {
+    printf("{\n  \"path\": \"%s\",\n  \"type\": %u,\n  \"clknum\": %u,\n  \"bus_hz\": %u,\n  \"results\": [\n",
+      BENCH_PATH, SI5351_TYPE, SI5351_CLKNUM, g_tModel.tConfig.u32BusHz);
+  } else {
+    printf("%s math, Si5351 type %u, %u CLK, SCL %u Hz\n", BENCH_PATH, SI5351_TYPE, SI5351_CLKNUM, g_tModel.tConfig.u32BusHz);
+    printf("%-6s %-20s %12s %10s %6s %8s %8s %9s\n", "suite", "name", "calls/s", "ns/call", "fails", "trans/op", "bytes/op", "bus us/op");
+  }
+  for(u32Index = 0; u32Index < g_u32Results; u32Index++) {
+    ptResult = &g_atResult[u32Index];
+    dNsPerCall = (double)ptResult->u64Ns / ptResult->u32Calls;
+    dCallsPerSec = 1e9 * ptResult->u32Calls / ptResult->u64Ns;
+    dTransactions = (double)ptResult->tStats.u32Transactions / ptResult->u32Calls;
+    dBytes = (double)(ptResult->tStats.u64WriteBytes + ptResult->tStats.u64ReadBytes) / ptResult->u32Calls;
+    dBusUs = ptResult->tStats.u64BusNs / 1e3 / ptResult->u32Calls;
+    if(tFormat == BENCH_FORMAT_CSV) {
+      printf("%s,%u,%u,%u,%s,%s,%u,%u,%.1f,%.0f,%.2f,%.2f,%.2f\n",
+        BENCH_PATH, SI5351_TYPE, SI5351_CLKNUM, g_tModel.tConfig.u32BusHz, ptResult->pszSuite, ptResult->pszName,
+        ptResult->u32Calls, ptResult->u32Fails, dNsPerCall, dCallsPerSec, dTransactions, dBytes, dBusUs);
+    } else if(tFormat == BENCH_FORMAT_JSON) {
+      printf("    {\"suite\": \"%s\", \"name\": \"%s\", \"calls\": %u, \"fails\": %u, \"ns_per_call\": %.1f, "
+        "\"calls_per_s\": %.0f, \"transactions_per_op\": %.2f, \"bytes_per_op\": %.2f, \"bus_us_per_op\": %.2f}%s\n",
+        ptResult->pszSuite, ptResult->pszName, ptResult->u32Calls, ptResult->u32Fails, dNsPerCall, dCallsPerSec,
+        dTransactions, dBytes, dBusUs, (u32Index + 1 < g_u32Results) ? "," : "");
+    } else {
+      printf("%-6s %-20s %12.0f %10.1f %6u %8.2f %8.2f %9.2f\n", ptResult->pszSuite, ptResult->pszName,
+        dCallsPerSec, dNsPerCall, ptResult->u32Fails, dTransactions, dBytes, dBusUs);
+    }
+  }
+  if(tFormat == BENCH_FORMAT_JSON) {
+    printf("  ]\n}\n");
+  }
+}
+
+int main(int argc, char* argv[]) {
+  Bench_Format_t tFormat = BENCH_FORMAT_TEXT;
+  uint32_t u32Loops = 200000;
+  Si5351_ModelConfig_t tConfig;
+  Si5351_Cache_t tCache;
+  Si5351_I2C oSi5351;
+
+  if(argc > 1) {
+    if(!strcmp(argv[1], "csv")) {
+      tFormat = BENCH_FORMAT_CSV;
+    } else if(!strcmp(argv[1], "json")) {
+      tFormat = BENCH_FORMAT_JSON;
+    } else if(strcmp(argv[1], "text")) {
+      fprintf(stderr, "usage: %s [text|csv|json] [loops]\n", argv[0]);
+      return 1;
+    }
+  }
+  if(argc > 2) {
+    u32Loops = (uint32_t)atoi(argv[2]);
+  }
+  if(u32Loops < 100) {
+    u32Loops = 100;
+  }
+
+  Si5351_Model_DefaultConfig(&tConfig);
+  tConfig.u8Type = SI5351_TYPE;
+  tConfig.u8ClkNum = SI5351_CLKNUM;
+  tConfig.u32XTALFreq = SI5351_XTAL_FREQ;
+  tConfig.u8Address = SI5351_I2C_ADDRESS;
+  tConfig.u8BlockMax = SI5351_I2C_BLOCK_MAX;
+  if(
+    !Si5351_Model_Initialize(&g_tModel, &tConfig) ||
+    !Si5351_Model_Advance(&g_tModel, tConfig.u32InitNs) ||
+    !oSi5351.initialize(
+      Bench_BeginTransmission, Bench_RequestFrom, Bench_Read, Bench_Write, Bench_EndTransmission,
+      Bench_MemoryBarrier, NULL
+    )
+  ) {
+    fprintf(stderr, "initialize failed\n");
+    return 1;
+  }
+
+  Bench_Calc(u32Loops);
+  /* the bus rows are model bound, a tenth of the loops is plenty */
+  if(
+    !Bench_Setters("bus", oSi5351, u32Loops / 10) ||
+    !oSi5351.attachCache(&tCache) ||
+    !oSi5351.syncCache() ||
+    !oSi5351.setWriteElision(true) ||
+    !Bench_Setters("cache", oSi5351, u32Loops / 10)
+  ) {
+    fprintf(stderr, "setter setup failed\n");
+    return 1;
+  }
+
+  Bench_Print(tFormat);
+  return 0;
+}
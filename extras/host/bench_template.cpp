@@ -0,0 +1,147 @@
+/* Si5351 template front-end vs function-pointer path benchmark (host) */
+/*
+  The same register operations through Si5351<Transport, Variant> (inlined
+  static transport) and through Si5351_I2C (callbacks via Si5351_t, no lock
+  policy, no cache). The bus is a zero-delay register file, so the numbers
+  are the driver overhead per call. Prints cycles per call (TSC on x86).
+  An Si5351A-3 and an Si5351C-8 descriptor run in the same binary.
+
+  usage: bench_template [loops]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "si5351_i2c.h"
+#include "si5351_template.h"
+#include "bench_clock.h"
+
+static uint8_t g_au8Register[256];
+static uint8_t g_u8Pointer;
+static bool g_bAddress;
+
+static void Bench_BeginTransmission(const uint8_t u8Address) {
+  (void)u8Address;
+  g_bAddress = true;
+}
+
+static void Bench_RequestFrom(const uint8_t u8Address, const uint8_t u8Count) {
+  (void)u8Address;
+  (void)u8Count;
+}
+
+static uint8_t Bench_Read(const uint8_t u8Address) {
+  (void)u8Address;
+  return g_au8Register[g_u8Pointer++];
+}
+
+static void Bench_Write(const uint8_t u8Value) {
+  if(g_bAddress) {
+    g_bAddress = false;
+    g_u8Pointer = u8Value;
+  } else {
+    g_au8Register[g_u8Pointer++] = u8Value;
+  }
+}
+
+static void Bench_EndTransmission(void) {
+}
+
+static void Bench_MemoryBarrier(void) {
+}
+
+struct Bench_Transport {
+  static void beginTransmission(const uint8_t u8Address) { Bench_BeginTransmission(u8Address); }
+  static void requestFrom(const uint8_t u8Address, const uint8_t u8Count) { Bench_RequestFrom(u8Address, u8Count); }
+  static uint8_t read(const uint8_t u8Address) { return Bench_Read(u8Address); }
+  static void write(const uint8_t u8Value) { Bench_Write(u8Value); }
+  static void endTransmission(void) { Bench_EndTransmission(); }
+};
+
+typedef Si5351<Bench_Transport, Si5351_VariantA3> Bench_Si5351;
+typedef Si5351<Bench_Transport, Si5351_VariantC8> Bench_Si5351C;
+
+static Si5351_MS_t g_tMS;
+
+static void Bench_Report(const char* pszName, const uint64_t u64Template, const uint64_t u64Pointer, const uint32_t u32Loops) {
+  printf("%-16s template %7.1f  Si5351_I2C %7.1f cycles/call  (x%.2f)\n",
+    pszName, (double)u64Template / u32Loops, (double)u64Pointer / u32Loops,
+    (double)u64Pointer / (u64Template ? u64Template : 1));
+}
+
+#define BENCH_RUN(u64Cycles, expr) do { \
+    uint64_t u64Start = Bench_Cycles(); \
+    for(u32Loop = 0; u32Loop < u32Loops; u32Loop++) { \
+      expr; \
+    } \
+    u64Cycles = Bench_Cycles() - u64Start; \
+  } while(0)
+
+int main(int argc, char* argv[]) {
+  uint32_t u32Loops = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1000000;
+  uint32_t u32Loop;
+  uint64_t u64Template;
+  uint64_t u64Pointer;
+  uint8_t au8Template[256];
+  Bench_Si5351 oTemplate;
+  Bench_Si5351C oTemplateC;
+  Si5351_I2C oPointer;
+
+  Si5351_CalcMSClk(&g_tMS, 800000000, 10000000);
+  if(!oPointer.initialize(
+    Bench_BeginTransmission, Bench_RequestFrom, Bench_Read, Bench_Write, Bench_EndTransmission,
+    Bench_MemoryBarrier, NULL
+  )) {
+    fprintf(stderr, "initialize failed\n");
+    return 1;
+  }
+
+  /* both paths must leave the same registers */
+  memset(g_au8Register, 0, sizeof(g_au8Register));
+  oTemplate.initDevice();
+  oTemplate.setClkInvert(1, true);
+  oTemplate.setMS(2, &g_tMS);
+  oTemplate.setPhaseOffset(0, 0x25);
+  oTemplate.setOutputEnable(0x5);
+  memcpy(au8Template, g_au8Register, sizeof(au8Template));
+  memset(g_au8Register, 0, sizeof(g_au8Register));
+  oPointer.initDevice();
+  oPointer.setClkInvert(SI5351_CLK1, true);
+  oPointer.setMS(SI5351_CLK2, &g_tMS);
+  oPointer.setPhaseOffset(SI5351_CLK0, 0x25);
+  oPointer.setOutputEnable(0x5);
+  if(memcmp(au8Template, g_au8Register, sizeof(au8Template))) {
+    fprintf(stderr, "register mismatch\n");
+    return 1;
+  }
+
+  /* C8 descriptor: CLK7 integer divider and CLKIN exist, on A3 they do not */
+  if(!oTemplateC.setMS67(7, 100, SI5351_MS_DIV_BY4) || !oTemplateC.setClkSrc(7, SI5351_INPUT_CLKIN) ||
+    oTemplate.setMS67(7, 100, SI5351_MS_DIV_BY4) || oTemplate.setClkSrc(0, SI5351_INPUT_CLKIN) ||
+    g_au8Register[91] != 100 || g_au8Register[92] != 0x20 || (g_au8Register[23] & 0x0C) != 0x04) {
+    fprintf(stderr, "variant mismatch\n");
+    return 1;
+  }
+
+  printf("Si5351<Transport, Variant> vs Si5351_I2C, %u loops\n", u32Loops);
+
+  BENCH_RUN(u64Template, oTemplate.setClkInvert(u32Loop % 3, (u32Loop & 1) ? true : false));
+  BENCH_RUN(u64Pointer, oPointer.setClkInvert((Si5351_CLKNo_t)(u32Loop % 3), (u32Loop & 1) ? true : false));
+  Bench_Report("setClkInvert", u64Template, u64Pointer, u32Loops);
+  BENCH_RUN(u64Template, oTemplateC.setClkInvert(u32Loop % 8, (u32Loop & 1) ? true : false));
+  Bench_Report("setClkInvert C8", u64Template, u64Pointer, u32Loops);
+
+  BENCH_RUN(u64Template, oTemplate.setMS(u32Loop % 3, &g_tMS));
+  BENCH_RUN(u64Pointer, oPointer.setMS((Si5351_CLKNo_t)(u32Loop % 3), &g_tMS));
+  Bench_Report("setMS", u64Template, u64Pointer, u32Loops);
+
+  BENCH_RUN(u64Template, oTemplate.setPhaseOffset(u32Loop % 3, (uint8_t)u32Loop));
+  BENCH_RUN(u64Pointer, oPointer.setPhaseOffset((Si5351_CLKNo_t)(u32Loop % 3), (uint8_t)u32Loop));
+  Bench_Report("setPhaseOffset", u64Template, u64Pointer, u32Loops);
+
+  BENCH_RUN(u64Template, oTemplate.setOutputEnable(1 << (u32Loop % 3)));
+  BENCH_RUN(u64Pointer, oPointer.setOutputEnable(1 << (u32Loop % 3)));
+  Bench_Report("setOutputEnable", u64Template, u64Pointer, u32Loops);
+
+  return 0;
+}
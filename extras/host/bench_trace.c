@@ -0,0 +1,163 @@
+/* Si5351 register access trace cost and capture (host) */
+/*
+  1. Recording cost: a read-modify-write setter on a zero-latency register
+     array without cache, trace detached / recording / frozen. Built without
+     SI5351_USE_TRACE the core has no trace code at all.
+  2. Capture: start-up, Si5351_SetPlan and frequency hops on Si5351_Model_t,
+     time stamped with the model's virtual time, with a mark between the
+     steps; the dump goes to the file given (default trace.bin) for
+     trace_decode and trace_replay.
+
+  usage: bench_trace [trace.bin]
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "si5351.h"
+#include "si5351_model.h"
+#include "bench_clock.h"
+
+#define BENCH_CALLS 1000000
+#define BENCH_HOPS  20
+#define BENCH_RING  1024
+
+static uint8_t g_au8Register[256];
+static Si5351_Model_t* g_ptModel;
+
+static uint8_t Bench_Read(void* pInstance, const uint8_t u8Reg) {
+  return g_au8Register[u8Reg];
+}
+
+static void Bench_Write(void* pInstance, const uint8_t u8Reg, uint8_t u8Value) {
+  g_au8Register[u8Reg] = u8Value;
+}
+
+static void Bench_MemoryBarrier(void) {
+}
+
+static uint32_t Bench_HostTime(void) {
+  return (uint32_t)Bench_Nanoseconds();
+}
+
+static uint32_t Bench_ModelTime(void) {
+  return (uint32_t)Si5351_Model_GetTime(g_ptModel);
+}
+
+static void Bench_Output(void* pContext, const uint8_t* pu8Data, const uint8_t u8Count) {
+  fwrite(pu8Data, 1, u8Count, (FILE*)pContext);
+}
+
+static double Bench_Setter(Si5351_t* ptSi5351) {
+  uint64_t u64Start;
+  uint32_t u32Index;
+
+  u64Start = Bench_Nanoseconds();
+  for(u32Index = 0; u32Index < BENCH_CALLS; u32Index++) {
+    Si5351_SetClkInvert(ptSi5351, SI5351_CLK0, (u32Index & 1) ? true : false);
+  }
+
+  return (double)(Bench_Nanoseconds() - u64Start) / BENCH_CALLS;
+}
+
+static bool Bench_Capture(const char* pszPath) {
+  static Si5351_TraceEntry_t atEntry[BENCH_RING];
+  Si5351_ModelConfig_t tConfig;
+  Si5351_Model_t tModel;
+  Si5351_Cache_t tCache;
+  Si5351_Trace_t tTrace;
+  Si5351_t tSi5351;
+  Si5351_Status_t tStatus;
+  Si5351_PlanRequest_t atRequest[SI5351_CLKNUM];
+  Si5351_Plan_t tPlan;
+  Si5351_MS_t tMS;
+  FILE* pFile;
+  uint32_t u32Hop;
+
+  memset(atRequest, 0, sizeof(atRequest));
+  atRequest[0].u32Freq = 10000000;
+  atRequest[1].u32Freq = 12288000;
+  atRequest[2].u32Freq = 27000000;
+  Si5351_Model_DefaultConfig(&tConfig);
+  tConfig.u8Type = SI5351_TYPE;
+  tConfig.u8ClkNum = SI5351_CLKNUM;
+  tConfig.u32XTALFreq = SI5351_XTAL_FREQ;
+  g_ptModel = &tModel;
+  if(
+    !Si5351_CalcPlan(&tPlan, SI5351_XTAL_FREQ, atRequest) ||
+    !Si5351_Model_Initialize(&tModel, &tConfig) ||
+    !Si5351_Initialize(&tSi5351, &tModel, Si5351_Model_Read, Si5351_Model_Write, Bench_MemoryBarrier, NULL) ||
+    !Si5351_SetReadBlock(&tSi5351, Si5351_Model_ReadBlock) ||
+    !Si5351_SetWriteBlock(&tSi5351, Si5351_Model_WriteBlock) ||
+    !Si5351_AttachCache(&tSi5351, &tCache) ||
+    !Si5351_InitTrace(&tTrace, atEntry, BENCH_RING, Bench_ModelTime, 1) ||
+    !Si5351_AttachTrace(&tSi5351, &tTrace, 0)
+  ) {
+    fprintf(stderr, "initialize failed\n");
+    return false;
+  }
+
+  do {
+    Si5351_Model_Advance(&tModel, 1000000);
+    Si5351_GetStatus(&tStatus, &tSi5351);
+  } while(tStatus.bSYS_INIT);
+  Si5351_InitDevice(&tSi5351);
+  Si5351_SyncCache(&tSi5351);
+  Si5351_MarkTrace(&tTrace, 0, 0x01);
+  Si5351_SetPlan(&tSi5351, &tPlan);
+  Si5351_Model_Advance(&tModel, tConfig.u32LockNs);
+  Si5351_GetStatus(&tStatus, &tSi5351);
+  Si5351_MarkTrace(&tTrace, 0, 0x02);
+  for(u32Hop = 0; u32Hop < BENCH_HOPS; u32Hop++) {
+#if defined(SI5351_USE_INTEGER_MATH)
+    Si5351_CalcMSClk(&tMS, tPlan.au32VCO[0], 10000000 + u32Hop * 1000);
+#elif defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
+    Si5351_CalcMSClk(&tMS, ui32_to_f64(tPlan.au32VCO[0]), ui32_to_f64(10000000 + u32Hop * 1000));
+#else
+    Si5351_CalcMSClk(&tMS, (double)tPlan.au32VCO[0], (double)(10000000 + u32Hop * 1000));
+#endif
+    Si5351_SetMS(&tSi5351, SI5351_CLK0, &tMS);
+    Si5351_Model_Advance(&tModel, 100000);
+  }
+  Si5351_SetTraceFreeze(&tTrace, true);
+
+  pFile = fopen(pszPath, "wb");
+  if(!pFile) {
+    fprintf(stderr, "%s: cannot open\n", pszPath);
+    return false;
+  }
+  Si5351_DumpTrace(&tTrace, Bench_Output, pFile);
+  fclose(pFile);
+  printf("capture: %u entries (ring %u), %.3f ms virtual time -> %s\n",
+    tTrace.u32Head, BENCH_RING, Si5351_Model_GetTime(&tModel) / 1e6, pszPath);
+
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  static Si5351_TraceEntry_t atEntry[BENCH_RING];
+  Si5351_Trace_t tTrace;
+  Si5351_t tSi5351;
+  double dOff;
+  double dOn;
+  double dFrozen;
+
+  if(
+    !Si5351_Initialize(&tSi5351, g_au8Register, Bench_Read, Bench_Write, Bench_MemoryBarrier, NULL) ||
+    !Si5351_InitTrace(&tTrace, atEntry, BENCH_RING, Bench_HostTime, 1)
+  ) {
+    fprintf(stderr, "initialize failed\n");
+    return 1;
+  }
+  Bench_Setter(&tSi5351);
+  dOff = Bench_Setter(&tSi5351);
+  Si5351_AttachTrace(&tSi5351, &tTrace, 0);
+  dOn = Bench_Setter(&tSi5351);
+  Si5351_SetTraceFreeze(&tTrace, true);
+  dFrozen = Bench_Setter(&tSi5351);
+  printf("SetClkInvert (1 read + 1 write) %u calls, zero-latency bus\n", BENCH_CALLS);
+  printf("  detached %7.1f ns/call\n", dOff);
+  printf("  recording %6.1f ns/call  (+%.1f ns, clock_gettime time stamp)\n", dOn, dOn - dOff);
+  printf("  frozen   %7.1f ns/call  (+%.1f ns)\n", dFrozen, dFrozen - dOff);
+
+  return Bench_Capture((argc > 1) ? argv[1] : "trace.bin") ? 0 : 1;
+}
@@ -0,0 +1,511 @@
+/* Si5351 register-level device model (host) */
+
+#include <stdio.h>
+#include <string.h>
+#include "si5351_model.h"
+
+#define MODEL_VCO_MIN 600000000ULL
+#define MODEL_VCO_MAX 900000000ULL
+
+typedef unsigned __int128 Model_U128_t;
+
+/* Internal */
+
+static Model_U128_t Gcd(Model_U128_t u128A, Model_U128_t u128B) {
+  Model_U128_t u128T;
+
+  while(u128B) {
+    u128T = u128A % u128B;
+    u128A = u128B;
+    u128B = u128T;
+  }
+
+  return u128A;
+}
+
+/* Multisynth / feedback parameter block: ratio = ((P1 + 512) * P3 + P2) / (128 * P3) */
+static bool DecodeRatio(uint64_t* pu64Num, uint64_t* pu64Den, const uint8_t* pu8Value) {
+  bool bValid = false;
+  uint32_t u32P1;
+  uint32_t u32P2;
+  uint32_t u32P3;
+
+  u32P3 = ((uint32_t)(pu8Value[5] >> 4) << 16) | ((uint32_t)pu8Value[0] << 8) | pu8Value[1];
+  u32P1 = ((uint32_t)(pu8Value[2] & 0x3) << 16) | ((uint32_t)pu8Value[3] << 8) | pu8Value[4];
+  u32P2 = ((uint32_t)(pu8Value[5] & 0xF) << 16) | ((uint32_t)pu8Value[6] << 8) | pu8Value[7];
+  if(u32P3) {
+    bValid = true;
+    *pu64Num = ((uint64_t)u32P1 + 512) * u32P3 + u32P2;
+    *pu64Den = (uint64_t)128 * u32P3;
+  }
+
+  return bValid;
+}
+
+static uint32_t ClkinFreq(const Si5351_Model_t* ptModel) {
+  return ptModel->tConfig.u32CLKINFreq >> ((ptModel->au8Register[15] >> 6) & 0x3);
+}
+
+/* PLL reference: XTAL, or CLKIN on a Si5351C with PLLx_SRC set */
+static uint32_t PLLInput(const Si5351_Model_t* ptModel, const uint8_t u8PLL) {
+  if(ptModel->tConfig.u8Type == 2 && ((ptModel->au8Register[15] >> (2 + u8PLL)) & 0x1)) {
+    return ClkinFreq(ptModel);
+  }
+  return ptModel->tConfig.u32XTALFreq;
+}
+
+/* Feedback 15 - 90 and VCO 600 - 900 MHz */
+static bool IsVCOValid(const Si5351_Model_t* ptModel, const uint8_t u8PLL) {
+  uint32_t u32Input;
+  uint64_t u64Num;
+  uint64_t u64Den;
+  Model_U128_t u128VCO;
+
+  if(!Si5351_Model_GetVCO(&u32Input, &u64Num, &u64Den, ptModel, u8PLL) || !u32Input) {
+    return false;
+  }
+  if(u64Num < 15 * u64Den || u64Num > 90 * u64Den) {
+    return false;
+  }
+  u128VCO = (Model_U128_t)u32Input * u64Num;
+
+  return (u128VCO >= (Model_U128_t)MODEL_VCO_MIN * u64Den && u128VCO <= (Model_U128_t)MODEL_VCO_MAX * u64Den) ? true : false;
+}
+
+/* Live status into Reg.0, latched into the sticky Reg.1 */
+static void UpdateStatus(Si5351_Model_t* ptModel) {
+  uint8_t u8Status = 0;
+  uint8_t u8PLL;
+
+  if(ptModel->u64NowNs < ptModel->u64InitDoneNs) {
+    u8Status |= SI5351_MODEL_SYS_INIT;
+  }
+  for(u8PLL = 0; u8PLL < 2; u8PLL++) {
+    if(!IsVCOValid(ptModel, u8PLL) || ptModel->u64NowNs < ptModel->au64LockNs[u8PLL]) {
+      u8Status |= u8PLL ? SI5351_MODEL_LOL_B : SI5351_MODEL_LOL_A;
+    }
+  }
+  if(ptModel->tConfig.u8Type == 2 && !ptModel->tConfig.u32CLKINFreq) {
+    u8Status |= SI5351_MODEL_LOS_CLKIN;
+  }
+  ptModel->au8Register[0] = u8Status;
+  ptModel->au8Register[1] |= u8Status & 0xF0;
+}
+
+static void ApplyWrite(Si5351_Model_t* ptModel, const uint8_t u8Reg, const uint8_t u8Value) {
+  ptModel->tStats.u32RegWrites++;
+  switch(u8Reg) {
+  case 0:
+    /* read only */
+    break;
+  case 1:
+    /* sticky bits clear by writing 0 */
+    ptModel->au8Register[1] &= u8Value;
+    break;
+  case 177:
+    if(u8Value & 0x20) {
+      ptModel->au64LockNs[0] = ptModel->u64NowNs + ptModel->tConfig.u32LockNs;
+      ptModel->au32Resets[0]++;
+    }
+    if(u8Value & 0x80) {
+      ptModel->au64LockNs[1] = ptModel->u64NowNs + ptModel->tConfig.u32LockNs;
+      ptModel->au32Resets[1]++;
+    }
+    /* reset bits clear themselves */
+    ptModel->au8Register[177] = u8Value & 0x5F;
+    break;
+  default:
+    ptModel->au8Register[u8Reg] = u8Value;
+    break;
+  }
+}
+
+/* One START ... STOP of u32Bytes bytes: 9 clocks a byte, START and STOP */
+static void Transaction(Si5351_Model_t* ptModel, const uint32_t u32Bytes) {
+  uint64_t u64Ns;
+
+  u64Ns = ((uint64_t)u32Bytes * 9 + 2) * 1000000000ULL / ptModel->tConfig.u32BusHz;
+  ptModel->tStats.u32Transactions++;
+  ptModel->tStats.u64BusNs += u64Ns;
+  ptModel->u64NowNs += u64Ns;
+}
+
+/* Config */
+
+void Si5351_Model_DefaultConfig(Si5351_ModelConfig_t* ptConfig) {
+  if(ptConfig) {
+    ptConfig->u8Type = 0;
+    ptConfig->u8ClkNum = 3;
+    ptConfig->u32XTALFreq = 25000000;
+    ptConfig->u32CLKINFreq = 0;
+    ptConfig->u8Address = 0x60;
+    ptConfig->u32BusHz = SI5351_MODEL_BUS_400K;
+    ptConfig->u8BlockMax = 16;
+    ptConfig->u32InitNs = 10000000;
+    ptConfig->u32LockNs = 1000000;
+  }
+}
+
+bool Si5351_Model_Initialize(Si5351_Model_t* ptModel, const Si5351_ModelConfig_t* ptConfig) {
+  bool bValid = false;
+
+  if(ptModel && ptConfig) {
+    if(
+      ptConfig->u8Type <= 2 && (ptConfig->u8ClkNum == 8 || (ptConfig->u8Type == 0 && ptConfig->u8ClkNum == 3)) &&
+      ptConfig->u32XTALFreq && ptConfig->u8Address <= 0x7F && ptConfig->u32BusHz
+    ) {
+      bValid = true;
+      memset(ptModel, 0, sizeof(*ptModel));
+      ptModel->tConfig = *ptConfig;
+      Si5351_Model_PowerOn(ptModel);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_Model_PowerOn(Si5351_Model_t* ptModel) {
+  bool bValid = false;
+
+  if(ptModel) {
+    bValid = true;
+    memset(ptModel->au8Register, 0, sizeof(ptModel->au8Register));
+    ptModel->u64InitDoneNs = ptModel->u64NowNs + ptModel->tConfig.u32InitNs;
+    ptModel->au64LockNs[0] = ptModel->u64InitDoneNs + ptModel->tConfig.u32LockNs;
+    ptModel->au64LockNs[1] = ptModel->au64LockNs[0];
+    ptModel->au32Resets[0] = 0;
+    ptModel->au32Resets[1] = 0;
+    ptModel->u16Pending = 0;
+    ptModel->bAddressed = false;
+    ptModel->bRegister = false;
+    UpdateStatus(ptModel);
+  }
+
+  return bValid;
+}
+
+bool Si5351_Model_SetBus(Si5351_Model_t* ptModel, const uint32_t u32BusHz, const uint8_t u8BlockMax) {
+  bool bValid = false;
+
+  if(ptModel && u32BusHz) {
+    bValid = true;
+    ptModel->tConfig.u32BusHz = u32BusHz;
+    ptModel->tConfig.u8BlockMax = u8BlockMax;
+  }
+
+  return bValid;
+}
+
+/* Virtual time */
+
+uint64_t Si5351_Model_GetTime(const Si5351_Model_t* ptModel) {
+  return ptModel ? ptModel->u64NowNs : 0;
+}
+
+bool Si5351_Model_Advance(Si5351_Model_t* ptModel, const uint64_t u64Ns) {
+  bool bValid = false;
+
+  if(ptModel) {
+    bValid = true;
+    ptModel->u64NowNs += u64Ns;
+  }
+
+  return bValid;
+}
+
+/* Statistics */
+
+bool Si5351_Model_GetStats(Si5351_ModelStats_t* ptStats, const Si5351_Model_t* ptModel) {
+  bool bValid = false;
+
+  if(ptStats && ptModel) {
+    bValid = true;
+    *ptStats = ptModel->tStats;
+  }
+
+  return bValid;
+}
+
+bool Si5351_Model_ResetStats(Si5351_Model_t* ptModel) {
+  bool bValid = false;
+
+  if(ptModel) {
+    bValid = true;
+    memset(&ptModel->tStats, 0, sizeof(ptModel->tStats));
+  }
+
+  return bValid;
+}
+
+/* Decoded state */
+
+bool Si5351_Model_GetStatus(uint8_t* pu8Status, Si5351_Model_t* ptModel) {
+  bool bValid = false;
+
+  if(pu8Status && ptModel) {
+    bValid = true;
+    UpdateStatus(ptModel);
+    *pu8Status = ptModel->au8Register[0];
+  }
+
+  return bValid;
+}
+
+bool Si5351_Model_GetVCO(uint32_t* pu32Input, uint64_t* pu64Num, uint64_t* pu64Den, const Si5351_Model_t* ptModel, const uint8_t u8PLL) {
+  bool bValid = false;
+
+  if(pu32Input && pu64Num && pu64Den && ptModel && u8PLL < 2) {
+    bValid = DecodeRatio(pu64Num, pu64Den, &ptModel->au8Register[u8PLL ? 34 : 26]);
+    *pu32Input = PLLInput(ptModel, u8PLL);
+  }
+
+  return bValid;
+}
+
+/*
+  Route of CLK u8CLKNo: CLKx_SRC picks XTAL, CLKIN, MS0/MS4 or its own
+  Multisynth; the Multisynth takes PLLA/PLLB by its MSx_SRC bit; the R
+  divider of the output follows.
+*/
+bool Si5351_Model_GetClk(Si5351_ModelClk_t* ptClk, Si5351_Model_t* ptModel, const uint8_t u8CLKNo) {
+  bool bValid = false;
+  uint8_t u8Control;
+  uint8_t u8Src;
+  uint8_t u8MS;
+  const uint8_t* pu8MS;
+  Model_U128_t u128Num;
+  Model_U128_t u128Den;
+  Model_U128_t u128Gcd;
+  Model_U128_t u128Rem;
+
+  if(ptClk && ptModel && u8CLKNo < ptModel->tConfig.u8ClkNum) {
+    bValid = true;
+    UpdateStatus(ptModel);
+    memset(ptClk, 0, sizeof(*ptClk));
+    ptClk->u8PLL = 0xFF;
+    ptClk->u8MS = 0xFF;
+    ptClk->bLocked = true;
+    ptClk->u64PLLNum = 1;
+    ptClk->u64PLLDen = 1;
+    ptClk->u64MSNum = 1;
+    ptClk->u64MSDen = 1;
+    ptClk->bActive = true;
+
+    u8Control = ptModel->au8Register[16 + u8CLKNo];
+    u8Src = (u8Control >> 2) & 0x3;
+    if(u8CLKNo < 6) {
+      ptClk->u8RDiv = (uint8_t)(1 << ((ptModel->au8Register[42 + 8 * u8CLKNo + 2] >> 4) & 0x7));
+    } else {
+      ptClk->u8RDiv = (uint8_t)(1 << ((ptModel->au8Register[92] >> (4 * (u8CLKNo - 6))) & 0x7));
+    }
+
+    switch(u8Src) {
+    case 0:
+      ptClk->u32Input = ptModel->tConfig.u32XTALFreq;
+      break;
+    case 1:
+      ptClk->u32Input = (ptModel->tConfig.u8Type == 2) ? ClkinFreq(ptModel) : 0;
+      break;
+    default:
+      if(u8Src == 2) {
+        /* MS0 for CLK1-3, MS4 for CLK5-7, reserved for CLK0/CLK4 */
+        u8MS = (u8CLKNo == 0 || u8CLKNo == 4) ? 0xFF : ((u8CLKNo < 4) ? 0 : 4);
+      } else {
+        u8MS = u8CLKNo;
+      }
+      if(u8MS == 0xFF) {
+        ptClk->bActive = false;
+        break;
+      }
+      ptClk->u8MS = u8MS;
+      ptClk->u8PLL = (ptModel->au8Register[16 + u8MS] >> 5) & 0x1;
+      if(!Si5351_Model_GetVCO(&ptClk->u32Input, &ptClk->u64PLLNum, &ptClk->u64PLLDen, ptModel, ptClk->u8PLL)) {
+        ptClk->bActive = false;
+      }
+      ptClk->bLocked = (ptModel->au8Register[0] & (ptClk->u8PLL ? SI5351_MODEL_LOL_B : SI5351_MODEL_LOL_A)) ? false : true;
+      if(u8MS < 6) {
+        pu8MS = &ptModel->au8Register[42 + 8 * u8MS];
+        if(((pu8MS[2] >> 2) & 0x3) == 0x3) {
+          /* MSx_DIVBY4 */
+          ptClk->u64MSNum = 4;
+          ptClk->u64MSDen = 1;
+        } else if(!DecodeRatio(&ptClk->u64MSNum, &ptClk->u64MSDen, pu8MS) ||
+          ptClk->u64MSNum < 6 * ptClk->u64MSDen || ptClk->u64MSNum > 2048 * ptClk->u64MSDen) {
+          ptClk->bActive = false;
+        }
+      } else {
+        /* MS6/MS7 : even integer 6 - 254 */
+        ptClk->u64MSNum = ptModel->au8Register[90 + u8MS - 6];
+        ptClk->u64MSDen = 1;
+        if(ptClk->u64MSNum < 6 || (ptClk->u64MSNum & 0x1)) {
+          ptClk->bActive = false;
+        }
+      }
+      break;
+    }
+
+    /* CLKx_PDN, OE (Reg.3 bit set : disabled), input present */
+    if((u8Control & 0x80) || ((ptModel->au8Register[3] >> u8CLKNo) & 0x1) || !ptClk->u32Input) {
+      ptClk->bActive = false;
+    }
+
+    if(ptClk->bActive) {
+      u128Num = (Model_U128_t)ptClk->u32Input * ptClk->u64PLLNum * ptClk->u64MSDen;
+      u128Den = (Model_U128_t)ptClk->u64PLLDen * ptClk->u64MSNum * ptClk->u8RDiv;
+      u128Gcd = Gcd(u128Num, u128Den);
+      u128Num /= u128Gcd;
+      u128Den /= u128Gcd;
+      u128Rem = u128Num % u128Den;
+      ptClk->u64Hz = (uint64_t)(u128Num / u128Den);
+      if(u128Den <= UINT64_MAX) {
+        ptClk->u64FracNum = (uint64_t)u128Rem;
+        ptClk->u64FracDen = (uint64_t)u128Den;
+      }
+      ptClk->dHz = (double)ptClk->u64Hz + (double)u128Rem / (double)u128Den;
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_Model_FormatClk(char* pszText, const uint32_t u32Size, const Si5351_ModelClk_t* ptClk) {
+  bool bValid = false;
+
+  if(pszText && u32Size && ptClk) {
+    bValid = true;
+    if(!ptClk->bActive) {
+      snprintf(pszText, u32Size, "off");
+    } else if(!ptClk->u64FracDen) {
+      snprintf(pszText, u32Size, "%.6f Hz%s", ptClk->dHz, ptClk->bLocked ? "" : " (unlocked)");
+    } else if(!ptClk->u64FracNum) {
+      snprintf(pszText, u32Size, "%llu Hz%s", (unsigned long long)ptClk->u64Hz, ptClk->bLocked ? "" : " (unlocked)");
+    } else {
+      snprintf(pszText, u32Size, "%llu + %llu/%llu Hz%s",
+        (unsigned long long)ptClk->u64Hz, (unsigned long long)ptClk->u64FracNum,
+        (unsigned long long)ptClk->u64FracDen, ptClk->bLocked ? "" : " (unlocked)");
+    }
+  }
+
+  return bValid;
+}
+
+/* Wire-style byte interface */
+
+void Si5351_Model_BeginTransmission(Si5351_Model_t* ptModel, const uint8_t u8Address) {
+  if(ptModel) {
+    ptModel->bAddressed = (u8Address == ptModel->tConfig.u8Address) ? true : false;
+    ptModel->bRegister = false;
+    ptModel->u16Pending = 1;
+  }
+}
+
+void Si5351_Model_WriteByte(Si5351_Model_t* ptModel, const uint8_t u8Value) {
+  if(ptModel) {
+    if(ptModel->bAddressed) {
+      ptModel->u16Pending++;
+      if(ptModel->bRegister) {
+        ApplyWrite(ptModel, ptModel->u8Pointer++, u8Value);
+      } else {
+        ptModel->bRegister = true;
+        ptModel->u8Pointer = u8Value;
+      }
+    }
+  }
+}
+
+/* Not acknowledged: only the address byte went out */
+void Si5351_Model_EndTransmission(Si5351_Model_t* ptModel) {
+  if(ptModel && ptModel->u16Pending) {
+    if(!ptModel->bAddressed) {
+      ptModel->tStats.u32Nacks++;
+    }
+    ptModel->tStats.u64WriteBytes += ptModel->u16Pending;
+    Transaction(ptModel, ptModel->u16Pending);
+    ptModel->u16Pending = 0;
+  }
+}
+
+void Si5351_Model_RequestFrom(Si5351_Model_t* ptModel, const uint8_t u8Address, const uint8_t u8Count) {
+  if(ptModel) {
+    ptModel->bAddressed = (u8Address == ptModel->tConfig.u8Address) ? true : false;
+    if(ptModel->bAddressed) {
+      ptModel->tStats.u64ReadBytes += 1 + (uint32_t)u8Count;
+      Transaction(ptModel, 1 + (uint32_t)u8Count);
+    } else {
+      ptModel->tStats.u32Nacks++;
+      ptModel->tStats.u64ReadBytes += 1;
+      Transaction(ptModel, 1);
+    }
+    UpdateStatus(ptModel);
+  }
+}
+
+uint8_t Si5351_Model_ReadByte(Si5351_Model_t* ptModel) {
+  uint8_t u8Value = 0xFF;
+
+  if(ptModel && ptModel->bAddressed) {
+    u8Value = ptModel->au8Register[ptModel->u8Pointer++];
+    ptModel->tStats.u32RegReads++;
+  }
+
+  return u8Value;
+}
+
+/* Si5351_t access callbacks, transferred like Si5351_I2C does */
+
+uint8_t Si5351_Model_Read(void* pInstance, const uint8_t u8Reg) {
+  uint8_t u8Value;
+
+  Si5351_Model_ReadBlock(pInstance, u8Reg, &u8Value, 1);
+
+  return u8Value;
+}
+
+void Si5351_Model_Write(void* pInstance, const uint8_t u8Reg, uint8_t u8Value) {
+  Si5351_Model_WriteBlock(pInstance, u8Reg, &u8Value, 1);
+}
+
+void Si5351_Model_ReadBlock(void* pInstance, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count) {
+  Si5351_Model_t* ptModel = (Si5351_Model_t*)pInstance;
+  uint8_t u8Index;
+  uint8_t u8Chunk;
+  uint8_t u8Byte;
+
+  if(ptModel && pu8Value) {
+    for(u8Index = 0; u8Index < u8Count; u8Index += u8Chunk) {
+      u8Chunk = u8Count - u8Index;
+      if(ptModel->tConfig.u8BlockMax && u8Chunk > ptModel->tConfig.u8BlockMax) {
+        u8Chunk = ptModel->tConfig.u8BlockMax;
+      }
+      Si5351_Model_BeginTransmission(ptModel, ptModel->tConfig.u8Address);
+      Si5351_Model_WriteByte(ptModel, u8Reg + u8Index);
+      Si5351_Model_EndTransmission(ptModel);
+      Si5351_Model_RequestFrom(ptModel, ptModel->tConfig.u8Address, u8Chunk);
+      for(u8Byte = 0; u8Byte < u8Chunk; u8Byte++) {
+        pu8Value[u8Index + u8Byte] = Si5351_Model_ReadByte(ptModel);
+      }
+    }
+  }
+}
+
+void Si5351_Model_WriteBlock(void* pInstance, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+  Si5351_Model_t* ptModel = (Si5351_Model_t*)pInstance;
+  uint8_t u8Index;
+  uint8_t u8Chunk;
+  uint8_t u8Byte;
+
+  if(ptModel && pu8Value) {
+    for(u8Index = 0; u8Index < u8Count; u8Index += u8Chunk) {
+      u8Chunk = u8Count - u8Index;
+      if(ptModel->tConfig.u8BlockMax && u8Chunk > ptModel->tConfig.u8BlockMax) {
+        u8Chunk = ptModel->tConfig.u8BlockMax;
+      }
+      Si5351_Model_BeginTransmission(ptModel, ptModel->tConfig.u8Address);
+      Si5351_Model_WriteByte(ptModel, u8Reg + u8Index);
+      for(u8Byte = 0; u8Byte < u8Chunk; u8Byte++) {
+        Si5351_Model_WriteByte(ptModel, pu8Value[u8Index + u8Byte]);
+      }
+      Si5351_Model_EndTransmission(ptModel);
+    }
+  }
+}
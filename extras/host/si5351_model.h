@@ -0,0 +1,145 @@
+#ifndef _SI5351_MODEL_H_
+#define _SI5351_MODEL_H_
+
+/* Si5351 register-level device model (host) */
+/*
+  A software Si5351 behind the driver's access callbacks, so the library
+  runs off-target. It keeps the full 256 byte register map and
+  - serves the Si5351_t callbacks (tRead/tWrite/tReadBlock/tWriteBlock,
+    pInstance = Si5351_Model_t*) and a Wire-style byte interface for
+    Si5351_I2C (BeginTransmission/Write/EndTransmission/RequestFrom/Read),
+  - decodes PLL, Multisynth, R divider and output routing into the exact
+    rational frequency of every CLK,
+  - models SYS_INIT after power-on, LOL_A/LOL_B around PLL reset and
+    invalid VCO settings, LOS_CLKIN, the sticky register and the
+    self-clearing PLL reset bits of Reg.177,
+  - counts bus transactions and bytes (address, register and data) and
+    advances a virtual clock by their wire time at 100k/400k/1M (any) Hz.
+
+  Time is virtual: only bus traffic and Si5351_Model_Advance move it, so
+  runs are deterministic. Timing assumptions (not datasheet values):
+  9 clocks per byte plus one for START and one for STOP, SYS_INIT clears
+  u32InitNs after power-on, a PLL locks u32LockNs after its reset.
+  A PLL stays locked through parameter changes that keep its VCO valid.
+  The register map after power-on is blank (all 0, outputs routed from
+  XTAL), like an unprogrammed part.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define SI5351_MODEL_BUS_100K 100000
+#define SI5351_MODEL_BUS_400K 400000
+#define SI5351_MODEL_BUS_1M   1000000
+
+/* Reg.0 bits */
+#define SI5351_MODEL_SYS_INIT  0x80
+#define SI5351_MODEL_LOL_B     0x40
+#define SI5351_MODEL_LOL_A     0x20
+#define SI5351_MODEL_LOS_CLKIN 0x10
+
+typedef struct Si5351_ModelConfig_t_ {
+  uint8_t  u8Type;        /* 0:A / 1:B / 2:C */
+  uint8_t  u8ClkNum;      /* 3 or 8 */
+  uint32_t u32XTALFreq;   /* Hz */
+  uint32_t u32CLKINFreq;  /* Hz, 0 : no signal (LOS on Si5351C) */
+  uint8_t  u8Address;     /* 7-bit, other addresses are not acknowledged */
+  uint32_t u32BusHz;      /* SCL clock */
+  uint8_t  u8BlockMax;    /* data bytes per block transfer through the Si5351_t callbacks (0: no limit) */
+  uint32_t u32InitNs;     /* SYS_INIT after power-on */
+  uint32_t u32LockNs;     /* PLL lock after reset */
+} Si5351_ModelConfig_t;
+
+typedef struct Si5351_ModelStats_t_ {
+  uint32_t u32Transactions;  /* START to STOP */
+  uint32_t u32Nacks;         /* to other addresses */
+  uint64_t u64WriteBytes;    /* address, register and data bytes sent to the device */
+  uint64_t u64ReadBytes;     /* address byte of a read and data bytes from the device */
+  uint32_t u32RegWrites;     /* registers written */
+  uint32_t u32RegReads;      /* registers read */
+  uint64_t u64BusNs;         /* wire time */
+} Si5351_ModelStats_t;
+
+/*
+  Output of one CLK as an exact rational number
+    f = u32Input * u64PLLNum * u64MSDen / (u64PLLDen * u64MSNum * u8RDiv)
+  PLL 1/1 when the CLK takes XTAL/CLKIN directly. u64Hz + u64FracNum/u64FracDen
+  is the same value reduced (u64FracDen 0 : the fraction needs more than 64 bits).
+*/
+typedef struct Si5351_ModelClk_t_ {
+  bool     bActive;    /* powered up, enabled, divider valid */
+  bool     bLocked;    /* source PLL locked (true for XTAL/CLKIN) */
+  uint8_t  u8PLL;      /* 0:PLLA / 1:PLLB, 0xFF : no PLL */
+  uint8_t  u8MS;       /* Multisynth used, 0xFF : none */
+  uint32_t u32Input;   /* PLL or CLK input (Hz) after CLKIN_DIV */
+  uint64_t u64PLLNum;
+  uint64_t u64PLLDen;
+  uint64_t u64MSNum;
+  uint64_t u64MSDen;
+  uint8_t  u8RDiv;
+  uint64_t u64Hz;
+  uint64_t u64FracNum;
+  uint64_t u64FracDen;
+  double   dHz;
+} Si5351_ModelClk_t;
+
+typedef struct Si5351_Model_t_ {
+  Si5351_ModelConfig_t tConfig;
+  uint8_t  au8Register[256];
+  uint64_t u64NowNs;
+  uint64_t u64InitDoneNs;
+  uint64_t au64LockNs[2];   /* PLL locked from */
+  uint32_t au32Resets[2];   /* PLL resets seen */
+  Si5351_ModelStats_t tStats;
+  /* Wire-style transaction state */
+  uint8_t  u8Pointer;
+  uint16_t u16Pending;      /* bytes of the current write transaction */
+  bool     bAddressed;      /* current transaction is for this device */
+  bool     bRegister;       /* register pointer byte received */
+} Si5351_Model_t;
+
+/* Build defaults: Si5351A-3, 25MHz XTAL, 0x60, 400kHz, 16 byte blocks, 10ms init, 1ms lock */
+void Si5351_Model_DefaultConfig(Si5351_ModelConfig_t* ptConfig);
+bool Si5351_Model_Initialize(Si5351_Model_t* ptModel, const Si5351_ModelConfig_t* ptConfig);
+/* Power cycle: blank map, SYS_INIT set, PLLs unlocked; statistics kept */
+bool Si5351_Model_PowerOn(Si5351_Model_t* ptModel);
+bool Si5351_Model_SetBus(Si5351_Model_t* ptModel, const uint32_t u32BusHz, const uint8_t u8BlockMax);
+
+/* Virtual time */
+uint64_t Si5351_Model_GetTime(const Si5351_Model_t* ptModel);
+bool Si5351_Model_Advance(Si5351_Model_t* ptModel, const uint64_t u64Ns);
+
+/* Statistics */
+bool Si5351_Model_GetStats(Si5351_ModelStats_t* ptStats, const Si5351_Model_t* ptModel);
+bool Si5351_Model_ResetStats(Si5351_Model_t* ptModel);
+
+/* Decoded state */
+bool Si5351_Model_GetStatus(uint8_t* pu8Status, Si5351_Model_t* ptModel);
+/* VCO of PLL u8PLL (0:A / 1:B) as u32Input * Num / Den, false : not configured */
+bool Si5351_Model_GetVCO(uint32_t* pu32Input, uint64_t* pu64Num, uint64_t* pu64Den, const Si5351_Model_t* ptModel, const uint8_t u8PLL);
+bool Si5351_Model_GetClk(Si5351_ModelClk_t* ptClk, Si5351_Model_t* ptModel, const uint8_t u8CLKNo);
+/* "10000000 Hz", "12288000 + 1/3 Hz" or "off" */
+bool Si5351_Model_FormatClk(char* pszText, const uint32_t u32Size, const Si5351_ModelClk_t* ptClk);
+
+/* Si5351_t access callbacks (pInstance : Si5351_Model_t*) */
+uint8_t Si5351_Model_Read(void* pInstance, const uint8_t u8Reg);
+void Si5351_Model_Write(void* pInstance, const uint8_t u8Reg, uint8_t u8Value);
+void Si5351_Model_ReadBlock(void* pInstance, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count);
+void Si5351_Model_WriteBlock(void* pInstance, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count);
+
+/* Wire-style byte interface (wrap it with a global model for Si5351_I2C) */
+void Si5351_Model_BeginTransmission(Si5351_Model_t* ptModel, const uint8_t u8Address);
+void Si5351_Model_WriteByte(Si5351_Model_t* ptModel, const uint8_t u8Value);
+void Si5351_Model_EndTransmission(Si5351_Model_t* ptModel);
+void Si5351_Model_RequestFrom(Si5351_Model_t* ptModel, const uint8_t u8Address, const uint8_t u8Count);
+uint8_t Si5351_Model_ReadByte(Si5351_Model_t* ptModel);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif  /* _SI5351_MODEL_H_ */
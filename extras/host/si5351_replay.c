@@ -0,0 +1,207 @@
+/* Si5351 register access trace replay (host) */
+
+#include <string.h>
+#include <time.h>
+#include "si5351_replay.h"
+
+#define REPLAY_BLOCK_MAX 255
+
+/* Reg.0,1 follow the device, Reg.177 PLL reset bits clear themselves */
+static bool IsImageRegister(const uint8_t u8Reg) {
+  return (u8Reg > 0x01) ? true : false;
+}
+
+static uint8_t ImageMask(const uint8_t u8Reg) {
+  return (u8Reg == 0xB1) ? 0x5F : 0xFF;
+}
+
+static uint64_t HostClock(void* pContext) {
+  struct timespec tTime;
+
+  clock_gettime(CLOCK_MONOTONIC, &tTime);
+  return (uint64_t)tTime.tv_sec * 1000000000 + tTime.tv_nsec;
+}
+
+static void HostWait(void* pContext, const uint64_t u64Ns) {
+  struct timespec tTime;
+
+  tTime.tv_sec = (time_t)(u64Ns / 1000000000);
+  tTime.tv_nsec = (long)(u64Ns % 1000000000);
+  while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tTime, NULL)) {
+  }
+}
+
+static void WaitUntil(const Si5351_ReplayConfig_t* ptConfig, const uint64_t u64Ns) {
+  if(ptConfig->tClock(ptConfig->pContext) >= u64Ns) {
+    return;
+  }
+  if(ptConfig->tWait) {
+    ptConfig->tWait(ptConfig->pContext, u64Ns);
+  } else {
+    while(ptConfig->tClock(ptConfig->pContext) < u64Ns) {
+    }
+  }
+}
+
+static void UpdateImage(Si5351_ReplayResult_t* ptResult, const Si5351_TraceRecord_t* ptRecord, const uint32_t u32Count) {
+  uint32_t u32Index;
+
+  for(u32Index = 0; u32Index < u32Count; u32Index++) {
+    if(IsImageRegister(ptRecord[u32Index].u8Reg)) {
+      ptResult->abCompared[ptRecord[u32Index].u8Reg] = true;
+      ptResult->au8Expected[ptRecord[u32Index].u8Reg] = ptRecord[u32Index].u8Value & ImageMask(ptRecord[u32Index].u8Reg);
+    }
+  }
+}
+
+static void CompareImage(Si5351_ReplayResult_t* ptResult, const Si5351_t* ptSi5351) {
+  uint16_t u16Reg;
+  uint8_t u8Value;
+
+  for(u16Reg = 0; u16Reg < 256; u16Reg++) {
+    if(!ptResult->abCompared[u16Reg]) {
+      continue;
+    }
+    ptResult->u16Compared++;
+    if(!Si5351_ReadRegisters(&u8Value, ptSi5351, (uint8_t)u16Reg, 1)) {
+      ptResult->u32Failed++;
+      u8Value = (uint8_t)~ptResult->au8Expected[u16Reg];
+    }
+    ptResult->au8Actual[u16Reg] = u8Value & ImageMask((uint8_t)u16Reg);
+    if(ptResult->au8Actual[u16Reg] != ptResult->au8Expected[u16Reg]) {
+      ptResult->u16Differ++;
+    }
+  }
+}
+
+void Si5351_Replay_DefaultConfig(Si5351_ReplayConfig_t* ptConfig) {
+  memset(ptConfig, 0, sizeof(Si5351_ReplayConfig_t));
+  ptConfig->tSpeed = SI5351_REPLAY_RECORDED;
+  ptConfig->u8Device = SI5351_REPLAY_ALL_DEVICES;
+  ptConfig->bReads = true;
+  ptConfig->tClock = HostClock;
+  ptConfig->tWait = HostWait;
+}
+
+bool Si5351_Replay_Run(
+  Si5351_ReplayResult_t* ptResult,
+  const Si5351_t* ptSi5351,
+  const Si5351_TraceLog_t* ptLog,
+  const Si5351_ReplayConfig_t* ptConfig
+) {
+  bool bValid = false;
+  /* time the transport took, per direction and size, for pacing */
+  uint64_t au64Duration[2][REPLAY_BLOCK_MAX + 1];
+  uint8_t au8Value[REPLAY_BLOCK_MAX];
+  const Si5351_TraceRecord_t* ptRecord;
+  bool bFirst;
+  bool bWrite;
+  bool bDone;
+  uint64_t u64RunStart;
+  uint64_t u64Run0;
+  uint64_t u64Trace0;
+  uint64_t u64TracePrev;
+  uint64_t u64Duration;
+  uint64_t u64Begin;
+  uint64_t u64End;
+  int64_t i64Drift;
+  uint32_t u32Index;
+  uint32_t u32Size;
+  uint32_t u32Byte;
+
+  if(ptResult && ptSi5351 && ptLog && ptConfig && ptConfig->tClock) {
+    bValid = true;
+    memset(ptResult, 0, sizeof(Si5351_ReplayResult_t));
+    memset(au64Duration, 0, sizeof(au64Duration));
+    bFirst = true;
+    u64RunStart = 0;
+    u64Run0 = 0;
+    u64Trace0 = 0;
+    u64TracePrev = 0;
+    for(u32Index = 0; u32Index < ptLog->u32Count; u32Index += u32Size) {
+      ptRecord = &ptLog->ptRecord[u32Index];
+      u32Size = Si5351_TraceLog_TransferSize(ptLog, u32Index);
+      if(u32Size > REPLAY_BLOCK_MAX) {
+        u32Size = REPLAY_BLOCK_MAX;
+      }
+      if(ptConfig->u8Device != SI5351_REPLAY_ALL_DEVICES && SI5351_TRACE_DEVICE(ptRecord->u8Flags) != ptConfig->u8Device) {
+        ptResult->u32Skipped += u32Size;
+        continue;
+      }
+      if(ptRecord->u8Flags & SI5351_TRACE_MARK) {
+        ptResult->u32Marks++;
+        if(ptConfig->tNotify) {
+          ptConfig->tNotify(ptConfig->pContext, ptRecord, ptRecord->u8Value, bFirst ? 0 : ptConfig->tClock(ptConfig->pContext) - u64Run0);
+        }
+        continue;
+      }
+      bWrite = (ptRecord->u8Flags & SI5351_TRACE_WRITE) ? true : false;
+      UpdateImage(ptResult, ptRecord, u32Size);
+      if(!bWrite && !ptConfig->bReads) {
+        ptResult->u32Skipped += u32Size;
+        continue;
+      }
+
+      if(ptConfig->tSpeed == SI5351_REPLAY_RECORDED && !bFirst && ptRecord->u64Ns >= u64TracePrev) {
+        /* not seen yet: the recorded gap to the previous transfer bounds its duration */
+        u64Duration = au64Duration[bWrite][u32Size] ? au64Duration[bWrite][u32Size] : ptRecord->u64Ns - u64TracePrev;
+        u64End = u64Run0 + (ptRecord->u64Ns - u64Trace0);
+        if(u64End > u64Duration) {
+          WaitUntil(ptConfig, u64End - u64Duration);
+        }
+      }
+
+      u64Begin = ptConfig->tClock(ptConfig->pContext);
+      if(bWrite) {
+        for(u32Byte = 0; u32Byte < u32Size; u32Byte++) {
+          au8Value[u32Byte] = ptRecord[u32Byte].u8Value;
+        }
+        bDone = Si5351_WriteRegisters(ptSi5351, ptRecord->u8Reg, au8Value, (uint8_t)u32Size);
+      } else {
+        bDone = Si5351_ReadRegisters(au8Value, ptSi5351, ptRecord->u8Reg, (uint8_t)u32Size);
+      }
+      u64End = ptConfig->tClock(ptConfig->pContext);
+      au64Duration[bWrite][u32Size] = u64End - u64Begin;
+
+      if(bFirst) {
+        bFirst = false;
+        u64RunStart = u64Begin;
+        u64Run0 = u64End;
+        u64Trace0 = ptRecord->u64Ns;
+      }
+      u64TracePrev = ptRecord->u64Ns;
+      ptResult->u32Transfers++;
+      if(!bDone) {
+        ptResult->u32Failed++;
+      } else if(bWrite) {
+        ptResult->u32Writes++;
+        ptResult->u32WriteBytes += u32Size;
+      } else {
+        ptResult->u32ReadBytes += u32Size;
+        for(u32Byte = 0; u32Byte < u32Size; u32Byte++) {
+          if(au8Value[u32Byte] != ptRecord[u32Byte].u8Value) {
+            ptResult->u32ReadDiffs++;
+            if(ptConfig->tNotify) {
+              ptConfig->tNotify(ptConfig->pContext, &ptRecord[u32Byte], au8Value[u32Byte], u64End - u64Run0);
+            }
+          }
+        }
+      }
+
+      i64Drift = (int64_t)(u64End - u64Run0) - (int64_t)(ptRecord->u64Ns - u64Trace0);
+      ptResult->i64DriftEndNs = i64Drift;
+      ptResult->i64DriftSumNs += i64Drift;
+      if(ptResult->i64DriftMaxNs < i64Drift) {
+        ptResult->i64DriftMaxNs = i64Drift;
+      }
+      if(ptResult->i64DriftMinNs > i64Drift) {
+        ptResult->i64DriftMinNs = i64Drift;
+      }
+      ptResult->u64TraceNs = ptRecord->u64Ns - u64Trace0;
+      ptResult->u64RunNs = u64End - u64RunStart;
+    }
+    CompareImage(ptResult, ptSi5351);
+  }
+
+  return bValid;
+}
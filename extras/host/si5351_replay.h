@@ -0,0 +1,96 @@
+#ifndef _SI5351_REPLAY_H_
+#define _SI5351_REPLAY_H_
+
+/* Si5351 register access trace replay (host) */
+/*
+  Drives a trace read by si5351_tracelog through a Si5351_t, transfer by
+  transfer with Si5351_WriteRegisters / Si5351_ReadRegisters, so it runs
+  against Si5351_Model_t or any real transport. Use a Si5351_t without
+  cache to put the recorded traffic on the bus unchanged.
+
+  Speed
+    SI5351_REPLAY_RECORDED : each transfer is due when its recorded time
+      stamp (taken at the end of the transfer) is due. The wait before it
+      subtracts the time the transport took for the last transfer of the
+      same direction and size (the first time: the recorded gap to the
+      previous transfer), so a transport as fast as the recording one
+      replays with about zero drift.
+    SI5351_REPLAY_MAX : back to back, for throughput.
+  Drift is the end of a transfer in the replay against its recorded time,
+  both counted from the end of the first transfer.
+
+  Reads are replayed and compared with the recorded values (status
+  registers differ when the device state differs). The register image the
+  trace leaves (last value written or read per register, Reg.0/1 left
+  out, Reg.177 reset bits masked) is compared with the registers read
+  back from the target after the run.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "si5351.h"
+#include "si5351_tracelog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define SI5351_REPLAY_ALL_DEVICES 0xFF
+
+typedef enum Si5351_ReplaySpeed_t_ {
+  SI5351_REPLAY_RECORDED = 0,
+  SI5351_REPLAY_MAX
+} Si5351_ReplaySpeed_t;
+
+/* Target clock in ns (model virtual time or a host clock) and wait until u64Ns */
+typedef uint64_t (*Si5351_ReplayClock_t)(void* pContext);
+typedef void (*Si5351_ReplayWait_t)(void* pContext, const uint64_t u64Ns);
+/* A mark (u8Actual : tag) or a read byte different from the recording (u8Actual : value read) */
+typedef void (*Si5351_ReplayNotify_t)(void* pContext, const Si5351_TraceRecord_t* ptRecord, const uint8_t u8Actual, const uint64_t u64RunNs);
+
+typedef struct Si5351_ReplayConfig_t_ {
+  Si5351_ReplaySpeed_t  tSpeed;
+  uint8_t               u8Device;   /* trace device number, SI5351_REPLAY_ALL_DEVICES : every entry */
+  bool                  bReads;     /* replay the reads too */
+  Si5351_ReplayClock_t  tClock;
+  Si5351_ReplayWait_t   tWait;      /* NULL : busy wait on tClock */
+  Si5351_ReplayNotify_t tNotify;    /* may be NULL */
+  void*                 pContext;
+} Si5351_ReplayConfig_t;
+
+typedef struct Si5351_ReplayResult_t_ {
+  uint32_t u32Transfers;
+  uint32_t u32Writes;
+  uint32_t u32WriteBytes;
+  uint32_t u32ReadBytes;
+  uint32_t u32Marks;
+  uint32_t u32Skipped;      /* entries of other devices, reads when bReads is false */
+  uint32_t u32Failed;       /* transfers the driver refused */
+  uint32_t u32ReadDiffs;    /* read bytes different from the recording */
+  uint64_t u64TraceNs;      /* recorded span, first to last replayed transfer */
+  uint64_t u64RunNs;        /* replay, start of the first to end of the last transfer */
+  int64_t  i64DriftEndNs;   /* last transfer */
+  int64_t  i64DriftMaxNs;   /* largest late */
+  int64_t  i64DriftMinNs;   /* largest early */
+  int64_t  i64DriftSumNs;   /* over u32Transfers */
+  /* final register image */
+  uint16_t u16Compared;
+  uint16_t u16Differ;
+  bool     abCompared[256];
+  uint8_t  au8Expected[256];
+  uint8_t  au8Actual[256];
+} Si5351_ReplayResult_t;
+
+void Si5351_Replay_DefaultConfig(Si5351_ReplayConfig_t* ptConfig);
+bool Si5351_Replay_Run(
+  Si5351_ReplayResult_t* ptResult,
+  const Si5351_t* ptSi5351,
+  const Si5351_TraceLog_t* ptLog,
+  const Si5351_ReplayConfig_t* ptConfig
+);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif  /* _SI5351_REPLAY_H_ */
@@ -0,0 +1,114 @@
+/* Si5351 register access trace reader (host) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "si5351.h"
+#include "si5351_tracelog.h"
+
+static uint32_t GetU32(const uint8_t* pu8Data) {
+  return (uint32_t)pu8Data[0] | ((uint32_t)pu8Data[1] << 8) | ((uint32_t)pu8Data[2] << 16) | ((uint32_t)pu8Data[3] << 24);
+}
+
+bool Si5351_TraceLog_Parse(Si5351_TraceLog_t* ptLog, const uint8_t* pu8Data, const size_t uSize) {
+  bool bValid = false;
+  const uint8_t* pu8Entry;
+  uint64_t u64Ticks;
+  uint32_t u32Prev;
+  uint32_t u32Time;
+  uint32_t u32Delta;
+  uint32_t u32Index;
+
+  if(
+    ptLog && pu8Data && uSize >= SI5351_TRACE_HEADER &&
+    !memcmp(pu8Data, "S5TR", 4) && pu8Data[4] == SI5351_TRACE_VERSION && pu8Data[5] == SI5351_TRACE_ENTRY_SIZE
+  ) {
+    memset(ptLog, 0, sizeof(Si5351_TraceLog_t));
+    ptLog->u32TickNs = GetU32(&pu8Data[8]);
+    ptLog->u32First = GetU32(&pu8Data[12]);
+    ptLog->u32Count = GetU32(&pu8Data[16]);
+    if((uSize - SI5351_TRACE_HEADER) / SI5351_TRACE_ENTRY_SIZE >= ptLog->u32Count) {
+      ptLog->ptRecord = (Si5351_TraceRecord_t*)calloc(ptLog->u32Count ? ptLog->u32Count : 1, sizeof(Si5351_TraceRecord_t));
+    }
+    if(ptLog->ptRecord) {
+      bValid = true;
+      u64Ticks = 0;
+      u32Prev = 0;
+      for(u32Index = 0; u32Index < ptLog->u32Count; u32Index++) {
+        pu8Entry = &pu8Data[SI5351_TRACE_HEADER + (size_t)u32Index * SI5351_TRACE_ENTRY_SIZE];
+        u32Time = GetU32(pu8Entry);
+        if(u32Index) {
+          /* forward within half the range, otherwise a step back */
+          u32Delta = u32Time - u32Prev;
+          if(u32Delta < 0x80000000) {
+            u64Ticks += u32Delta;
+            u32Prev = u32Time;
+          }
+        } else {
+          u32Prev = u32Time;
+        }
+        ptLog->ptRecord[u32Index].u64Ns = ptLog->u32TickNs ? u64Ticks * ptLog->u32TickNs : u64Ticks;
+        ptLog->ptRecord[u32Index].u32Seq = ptLog->u32First + u32Index;
+        ptLog->ptRecord[u32Index].u8Reg = pu8Entry[4];
+        ptLog->ptRecord[u32Index].u8Value = pu8Entry[5];
+        ptLog->ptRecord[u32Index].u8Api = pu8Entry[6];
+        ptLog->ptRecord[u32Index].u8Flags = pu8Entry[7];
+      }
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_TraceLog_Load(Si5351_TraceLog_t* ptLog, const char* pszPath) {
+  bool bValid = false;
+  FILE* pFile;
+  uint8_t* pu8Data;
+  long lSize;
+
+  pFile = fopen(pszPath, "rb");
+  if(pFile) {
+    if(!fseek(pFile, 0, SEEK_END) && (lSize = ftell(pFile)) > 0 && !fseek(pFile, 0, SEEK_SET)) {
+      pu8Data = (uint8_t*)malloc((size_t)lSize);
+      if(pu8Data) {
+        if(fread(pu8Data, 1, (size_t)lSize, pFile) == (size_t)lSize) {
+          bValid = Si5351_TraceLog_Parse(ptLog, pu8Data, (size_t)lSize);
+        }
+        free(pu8Data);
+      }
+    }
+    fclose(pFile);
+  }
+
+  return bValid;
+}
+
+void Si5351_TraceLog_Free(Si5351_TraceLog_t* ptLog) {
+  if(ptLog) {
+    free(ptLog->ptRecord);
+    memset(ptLog, 0, sizeof(Si5351_TraceLog_t));
+  }
+}
+
+uint32_t Si5351_TraceLog_TransferSize(const Si5351_TraceLog_t* ptLog, const uint32_t u32Index) {
+  uint32_t u32End;
+  uint8_t u8Flags;
+
+  if(u32Index >= ptLog->u32Count) {
+    return 0;
+  }
+  u8Flags = ptLog->ptRecord[u32Index].u8Flags;
+  u32End = u32Index + 1;
+  if(!(u8Flags & SI5351_TRACE_MARK)) {
+    /* continues while the same device transfers in the same direction without a new START */
+    while(
+      u32End < ptLog->u32Count &&
+      !(ptLog->ptRecord[u32End].u8Flags & (SI5351_TRACE_START | SI5351_TRACE_MARK)) &&
+      (ptLog->ptRecord[u32End].u8Flags & 0xF1) == (u8Flags & 0xF1)
+    ) {
+      u32End++;
+    }
+  }
+
+  return u32End - u32Index;
+}
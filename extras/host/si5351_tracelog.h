@@ -0,0 +1,47 @@
+#ifndef _SI5351_TRACELOG_H_
+#define _SI5351_TRACELOG_H_
+
+/* Si5351 register access trace reader (host) */
+/*
+  Reads the binary dump of Si5351_DumpTrace (format in si5351.h) into
+  records with the 32-bit time stamps unwrapped to nanoseconds from the
+  first entry. Entries recorded by preempting contexts may be slightly out
+  of time order, a step back is taken as no time passed.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct Si5351_TraceRecord_t_ {
+  uint64_t u64Ns;     /* since the first entry */
+  uint32_t u32Seq;    /* sequence number in the recording ring */
+  uint8_t  u8Reg;
+  uint8_t  u8Value;
+  uint8_t  u8Api;     /* Si5351_Api_t */
+  uint8_t  u8Flags;   /* SI5351_TRACE_x, device in the upper 4 bits */
+} Si5351_TraceRecord_t;
+
+typedef struct Si5351_TraceLog_t_ {
+  uint32_t u32TickNs;   /* 0 : unknown, times are raw ticks */
+  uint32_t u32First;    /* sequence number of the first record */
+  uint32_t u32Count;
+  Si5351_TraceRecord_t* ptRecord;
+} Si5351_TraceLog_t;
+
+bool Si5351_TraceLog_Parse(Si5351_TraceLog_t* ptLog, const uint8_t* pu8Data, const size_t uSize);
+bool Si5351_TraceLog_Load(Si5351_TraceLog_t* ptLog, const char* pszPath);
+void Si5351_TraceLog_Free(Si5351_TraceLog_t* ptLog);
+
+/* Records of the bus transfer starting at u32Index (marks count as one transfer) */
+uint32_t Si5351_TraceLog_TransferSize(const Si5351_TraceLog_t* ptLog, const uint32_t u32Index);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif  /* _SI5351_TRACELOG_H_ */
@@ -0,0 +1,62 @@
+/* Si5351 code size comparison app (host) */
+/*
+  The same setup sequence (PLLA, CLK0 at 10 MHz, output enable) built with
+  -DSIZE_TEMPLATE against Si5351<Transport, Variant>, or without against
+  Si5351_I2C and the C core. Linked with --gc-sections, compare with size(1).
+  The bus functions are out of line and identical in both builds.
+*/
+
+#include <stddef.h>
+#include "si5351_i2c.h"
+#include "si5351_template.h"
+
+volatile uint8_t g_u8Bus;
+
+__attribute__((noinline)) static void Size_BeginTransmission(const uint8_t u8Address) { g_u8Bus = u8Address; }
+__attribute__((noinline)) static void Size_RequestFrom(const uint8_t u8Address, const uint8_t u8Count) { g_u8Bus = u8Address + u8Count; }
+__attribute__((noinline)) static uint8_t Size_Read(const uint8_t u8Address) { (void)u8Address; return g_u8Bus; }
+__attribute__((noinline)) static void Size_Write(const uint8_t u8Value) { g_u8Bus = u8Value; }
+__attribute__((noinline)) static void Size_EndTransmission(void) { g_u8Bus = 0; }
+
+#if defined(SIZE_TEMPLATE)
+struct Size_Transport {
+  static void beginTransmission(const uint8_t u8Address) { Size_BeginTransmission(u8Address); }
+  static void requestFrom(const uint8_t u8Address, const uint8_t u8Count) { Size_RequestFrom(u8Address, u8Count); }
+  static uint8_t read(const uint8_t u8Address) { return Size_Read(u8Address); }
+  static void write(const uint8_t u8Value) { Size_Write(u8Value); }
+  static void endTransmission(void) { Size_EndTransmission(); }
+};
+
+static Si5351<Size_Transport, Si5351_VariantA3> g_oSi5351;
+#else
+static Si5351_I2C g_oSi5351;
+
+static void Size_MemoryBarrier(void) {
+}
+#endif  /* SIZE_TEMPLATE */
+
+int main(void) {
+  Si5351_MS_t tMSPLL, tMSClk;
+
+#if !defined(SIZE_TEMPLATE)
+  g_oSi5351.initialize(
+    Size_BeginTransmission, Size_RequestFrom, Size_Read, Size_Write, Size_EndTransmission,
+    Size_MemoryBarrier, NULL
+  );
+#endif  /* SIZE_TEMPLATE */
+  g_oSi5351.initDevice();
+  g_oSi5351.setPLLA_SRC(SI5351_PLL_SRC_XTAL);
+  if(Si5351_CalcMSPLL(&tMSPLL, SI5351_XTAL_FREQ, 500000000)) {
+    g_oSi5351.setMSA(&tMSPLL);
+    g_oSi5351.PLLSoftReset();
+    g_oSi5351.setClkPowerDown(SI5351_CLK0, false);
+    g_oSi5351.setClkMSSource(SI5351_CLK0, SI5351_CLK_MS_SRC_PLLA);
+    g_oSi5351.setClkSrc(SI5351_CLK0, SI5351_CLK_SRC_MS);
+    if(Si5351_CalcMSClk(&tMSClk, 500000000, 10000000)) {
+      g_oSi5351.setMS(SI5351_CLK0, &tMSClk);
+      g_oSi5351.setOutputEnable(1 << SI5351_CLK0);
+    }
+  }
+
+  return 0;
+}
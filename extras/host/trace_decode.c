@@ -0,0 +1,143 @@
+/* Si5351 register access trace decoder (host) */
+/*
+  trace_decode [text|csv] trace.bin
+  text : one line per bus transfer with time, device, direction, register
+         block and data bytes, and the public call it belongs to
+  csv  : one row per register byte
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "si5351.h"
+#include "si5351_tracelog.h"
+
+/* Register block of u8Reg, "" when none */
+static const char* RegName(char* pszName, const size_t uSize, const uint8_t u8Reg) {
+  static const char* const apszFixed[] = {
+    "status", "sticky", "mask", "OEB", NULL, NULL, NULL, NULL, NULL, "OEB_pin"
+  };
+
+  if(u8Reg < sizeof(apszFixed) / sizeof(apszFixed[0]) && apszFixed[u8Reg]) {
+    snprintf(pszName, uSize, "%s", apszFixed[u8Reg]);
+  } else if(u8Reg == 15) {
+    snprintf(pszName, uSize, "PLL_SRC");
+  } else if(u8Reg >= 16 && u8Reg <= 23) {
+    snprintf(pszName, uSize, "CLK%u_CTRL", u8Reg - 16);
+  } else if(u8Reg == 24 || u8Reg == 25) {
+    snprintf(pszName, uSize, "CLK_DIS");
+  } else if(u8Reg >= 26 && u8Reg <= 33) {
+    snprintf(pszName, uSize, "MSNA+%u", u8Reg - 26);
+  } else if(u8Reg >= 34 && u8Reg <= 41) {
+    snprintf(pszName, uSize, "MSNB+%u", u8Reg - 34);
+  } else if(u8Reg >= 42 && u8Reg <= 89) {
+    snprintf(pszName, uSize, "MS%u+%u", (u8Reg - 42) / 8, (u8Reg - 42) % 8);
+  } else if(u8Reg >= 90 && u8Reg <= 92) {
+    snprintf(pszName, uSize, "MS67+%u", u8Reg - 90);
+  } else if(u8Reg >= 149 && u8Reg <= 161) {
+    snprintf(pszName, uSize, "SSP+%u", u8Reg - 149);
+  } else if(u8Reg >= 162 && u8Reg <= 164) {
+    snprintf(pszName, uSize, "VCXO+%u", u8Reg - 162);
+  } else if(u8Reg >= 165 && u8Reg <= 170) {
+    snprintf(pszName, uSize, "CLK%u_PHOFF", u8Reg - 165);
+  } else if(u8Reg == 177) {
+    snprintf(pszName, uSize, "PLL_RST");
+  } else if(u8Reg == 183) {
+    snprintf(pszName, uSize, "XTAL_CL");
+  } else if(u8Reg == 187) {
+    snprintf(pszName, uSize, "FANOUT");
+  } else {
+    pszName[0] = '\0';
+  }
+
+  return pszName;
+}
+
+static const char* ApiName(const uint8_t u8Api) {
+  const char* pszName = Si5351_GetApiName((Si5351_Api_t)u8Api);
+
+  return pszName ? pszName : "?";
+}
+
+static void DecodeText(const Si5351_TraceLog_t* ptLog) {
+  const Si5351_TraceRecord_t* ptRecord;
+  uint32_t u32Index;
+  uint32_t u32Size;
+  uint32_t u32Byte;
+  uint32_t u32Transfers;
+  uint32_t u32Writes;
+  char szName[16];
+
+  printf("%u entries from #%u, %u ns per tick\n", ptLog->u32Count, ptLog->u32First, ptLog->u32TickNs);
+  printf("%12s %3s %3s %-4s %-11s %-26s %s\n", "time_us", "dev", "dir", "reg", "block", "call", "data");
+  u32Transfers = 0;
+  u32Writes = 0;
+  for(u32Index = 0; u32Index < ptLog->u32Count; u32Index += u32Size) {
+    ptRecord = &ptLog->ptRecord[u32Index];
+    u32Size = Si5351_TraceLog_TransferSize(ptLog, u32Index);
+    if(ptRecord->u8Flags & SI5351_TRACE_MARK) {
+      printf("%12.3f %3u --- mark 0x%02X\n", ptRecord->u64Ns / 1e3, SI5351_TRACE_DEVICE(ptRecord->u8Flags), ptRecord->u8Value);
+      continue;
+    }
+    u32Transfers++;
+    if(ptRecord->u8Flags & SI5351_TRACE_WRITE) {
+      u32Writes++;
+    }
+    printf("%12.3f %3u %3s 0x%02X %-11s %-26s", ptRecord->u64Ns / 1e3, SI5351_TRACE_DEVICE(ptRecord->u8Flags),
+      (ptRecord->u8Flags & SI5351_TRACE_WRITE) ? "W" : "R", ptRecord->u8Reg, RegName(szName, sizeof(szName), ptRecord->u8Reg),
+      ApiName(ptRecord->u8Api));
+    for(u32Byte = 0; u32Byte < u32Size; u32Byte++) {
+      if(u32Byte && !(u32Byte % 16)) {
+        printf("\n%64s", "");
+      }
+      printf(" %02X", ptLog->ptRecord[u32Index + u32Byte].u8Value);
+    }
+    printf("\n");
+  }
+  printf("%u transfers (%u write, %u read)\n", u32Transfers, u32Writes, u32Transfers - u32Writes);
+}
+
+static void DecodeCsv(const Si5351_TraceLog_t* ptLog) {
+  const Si5351_TraceRecord_t* ptRecord;
+  uint32_t u32Index;
+
+  printf("seq,time_ns,device,kind,start,reg,value,call\n");
+  for(u32Index = 0; u32Index < ptLog->u32Count; u32Index++) {
+    ptRecord = &ptLog->ptRecord[u32Index];
+    printf("%u,%llu,%u,%s,%u,%u,%u,%s\n", ptRecord->u32Seq, (unsigned long long)ptRecord->u64Ns,
+      SI5351_TRACE_DEVICE(ptRecord->u8Flags),
+      (ptRecord->u8Flags & SI5351_TRACE_MARK) ? "mark" : ((ptRecord->u8Flags & SI5351_TRACE_WRITE) ? "write" : "read"),
+      (ptRecord->u8Flags & SI5351_TRACE_START) ? 1 : 0, ptRecord->u8Reg, ptRecord->u8Value, ApiName(ptRecord->u8Api));
+  }
+}
+
+int main(int argc, char* argv[]) {
+  Si5351_TraceLog_t tLog;
+  const char* pszMode = "text";
+  const char* pszPath;
+
+  if(argc == 3) {
+    pszMode = argv[1];
+    pszPath = argv[2];
+  } else if(argc == 2) {
+    pszPath = argv[1];
+  } else {
+    fprintf(stderr, "usage: trace_decode [text|csv] trace.bin\n");
+    return 2;
+  }
+  if(strcmp(pszMode, "text") && strcmp(pszMode, "csv")) {
+    fprintf(stderr, "unknown mode %s\n", pszMode);
+    return 2;
+  }
+  if(!Si5351_TraceLog_Load(&tLog, pszPath)) {
+    fprintf(stderr, "%s: not a Si5351 trace dump\n", pszPath);
+    return 1;
+  }
+  if(!strcmp(pszMode, "csv")) {
+    DecodeCsv(&tLog);
+  } else {
+    DecodeText(&tLog);
+  }
+  Si5351_TraceLog_Free(&tLog);
+
+  return 0;
+}
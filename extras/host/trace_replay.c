@@ -0,0 +1,274 @@
+/* Si5351 register access trace replay tool (host) */
+/*
+  Replays a Si5351_DumpTrace capture (e.g. build/trace.bin of bench_trace)
+  against Si5351_Model_t, or a real device on Linux i2c-dev, and reports
+  throughput, timing drift against the recording, read values that differ
+  and the final register image differences.
+
+  usage: trace_replay [-s recorded|max] [-d device] [-w] [-v]
+                      [-b scl_hz] [-i /dev/i2c-N [-a address]] trace.bin
+    -s  speed, recorded (default) or max
+    -d  replay only this trace device number (default: all entries)
+    -w  writes only, reads are not replayed
+    -v  print marks and read differences as they happen
+    -b  model SCL clock (default 400000), model block size stays 16
+    -i  real transport instead of the model, -a 7-bit address (default 0x60)
+
+  On the model the clock is its virtual time: waiting advances it, so a
+  recorded-speed run finishes at once and PLL lock / SYS_INIT follow the
+  recorded timing.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "si5351.h"
+#include "si5351_model.h"
+#include "si5351_tracelog.h"
+#include "si5351_replay.h"
+#include "bench_clock.h"
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#endif
+
+typedef struct Replay_Target_t_ {
+  Si5351_Model_t tModel;
+#if defined(__linux__)
+  int iFd;
+  uint8_t u8Address;
+  uint32_t u32Errors;
+#endif
+} Replay_Target_t;
+
+static void Replay_MemoryBarrier(void) {
+}
+
+static uint64_t Replay_ModelClock(void* pContext) {
+  return Si5351_Model_GetTime(&((Replay_Target_t*)pContext)->tModel);
+}
+
+static void Replay_ModelWait(void* pContext, const uint64_t u64Ns) {
+  Si5351_Model_t* ptModel = &((Replay_Target_t*)pContext)->tModel;
+  uint64_t u64Now = Si5351_Model_GetTime(ptModel);
+
+  if(u64Ns > u64Now) {
+    Si5351_Model_Advance(ptModel, u64Ns - u64Now);
+  }
+}
+
+#if defined(__linux__)
+/* i2c-dev transport: one combined message per transfer */
+static void Replay_I2CReadBlock(void* pInstance, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count) {
+  Replay_Target_t* ptTarget = (Replay_Target_t*)pInstance;
+  uint8_t u8Pointer = u8Reg;
+  struct i2c_msg atMsg[2];
+  struct i2c_rdwr_ioctl_data tData;
+
+  atMsg[0].addr = ptTarget->u8Address;
+  atMsg[0].flags = 0;
+  atMsg[0].len = 1;
+  atMsg[0].buf = &u8Pointer;
+  atMsg[1].addr = ptTarget->u8Address;
+  atMsg[1].flags = I2C_M_RD;
+  atMsg[1].len = u8Count;
+  atMsg[1].buf = pu8Value;
+  tData.msgs = atMsg;
+  tData.nmsgs = 2;
+  if(ioctl(ptTarget->iFd, I2C_RDWR, &tData) < 0) {
+    ptTarget->u32Errors++;
+    memset(pu8Value, 0, u8Count);
+  }
+}
+
+static void Replay_I2CWriteBlock(void* pInstance, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+  Replay_Target_t* ptTarget = (Replay_Target_t*)pInstance;
+  uint8_t au8Buffer[256];
+  struct i2c_msg tMsg;
+  struct i2c_rdwr_ioctl_data tData;
+
+  au8Buffer[0] = u8Reg;
+  memcpy(&au8Buffer[1], pu8Value, u8Count);
+  tMsg.addr = ptTarget->u8Address;
+  tMsg.flags = 0;
+  tMsg.len = (uint16_t)(u8Count + 1);
+  tMsg.buf = au8Buffer;
+  tData.msgs = &tMsg;
+  tData.nmsgs = 1;
+  if(ioctl(ptTarget->iFd, I2C_RDWR, &tData) < 0) {
+    ptTarget->u32Errors++;
+  }
+}
+
+static uint8_t Replay_I2CRead(void* pInstance, const uint8_t u8Reg) {
+  uint8_t u8Value;
+
+  Replay_I2CReadBlock(pInstance, u8Reg, &u8Value, 1);
+  return u8Value;
+}
+
+static void Replay_I2CWrite(void* pInstance, const uint8_t u8Reg, uint8_t u8Value) {
+  Replay_I2CWriteBlock(pInstance, u8Reg, &u8Value, 1);
+}
+#endif
+
+static void Replay_Notify(void* pContext, const Si5351_TraceRecord_t* ptRecord, const uint8_t u8Actual, const uint64_t u64RunNs) {
+  const char* pszApi = Si5351_GetApiName((Si5351_Api_t)ptRecord->u8Api);
+
+  if(ptRecord->u8Flags & SI5351_TRACE_MARK) {
+    printf("  %12.3f us  mark 0x%02X (recorded %.3f us)\n", u64RunNs / 1e3, u8Actual, ptRecord->u64Ns / 1e3);
+  } else {
+    printf("  %12.3f us  read #%u reg 0x%02X recorded %02X replay %02X  %s\n", u64RunNs / 1e3,
+      ptRecord->u32Seq, ptRecord->u8Reg, ptRecord->u8Value, u8Actual, pszApi ? pszApi : "?");
+  }
+}
+
+static void Replay_Usage(void) {
+  fprintf(stderr,
+    "usage: trace_replay [-s recorded|max] [-d device] [-w] [-v]\n"
+    "                    [-b scl_hz] [-i /dev/i2c-N [-a address]] trace.bin\n");
+}
+
+int main(int argc, char* argv[]) {
+  static Replay_Target_t tTarget;
+  static Si5351_ReplayResult_t tResult;
+  Si5351_ModelConfig_t tConfig;
+  Si5351_ReplayConfig_t tReplay;
+  Si5351_TraceLog_t tLog;
+  Si5351_t tSi5351;
+  const char* pszDevice = NULL;
+  uint32_t u32BusHz = SI5351_MODEL_BUS_400K;
+  uint32_t u32Address = 0x60;
+  bool bVerbose = false;
+  uint64_t u64Wall;
+  uint32_t u32Reg;
+  int iOption;
+
+  Si5351_Replay_DefaultConfig(&tReplay);
+  while((iOption = getopt(argc, argv, "s:d:wvb:i:a:")) != -1) {
+    switch(iOption) {
+      case 's':
+        if(!strcmp(optarg, "max")) {
+          tReplay.tSpeed = SI5351_REPLAY_MAX;
+        } else if(!strcmp(optarg, "recorded")) {
+          tReplay.tSpeed = SI5351_REPLAY_RECORDED;
+        } else {
+          Replay_Usage();
+          return 2;
+        }
+        break;
+      case 'd':
+        tReplay.u8Device = (uint8_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'w':
+        tReplay.bReads = false;
+        break;
+      case 'v':
+        bVerbose = true;
+        break;
+      case 'b':
+        u32BusHz = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'i':
+        pszDevice = optarg;
+        break;
+      case 'a':
+        u32Address = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      default:
+        Replay_Usage();
+        return 2;
+    }
+  }
+  if(optind != argc - 1) {
+    Replay_Usage();
+    return 2;
+  }
+  if(!Si5351_TraceLog_Load(&tLog, argv[optind])) {
+    fprintf(stderr, "%s: not a Si5351 trace dump\n", argv[optind]);
+    return 1;
+  }
+
+  if(pszDevice) {
+#if defined(__linux__)
+    tTarget.iFd = open(pszDevice, O_RDWR);
+    tTarget.u8Address = (uint8_t)u32Address;
+    if(
+      tTarget.iFd < 0 ||
+      !Si5351_Initialize(&tSi5351, &tTarget, Replay_I2CRead, Replay_I2CWrite, Replay_MemoryBarrier, NULL) ||
+      !Si5351_SetReadBlock(&tSi5351, Replay_I2CReadBlock) ||
+      !Si5351_SetWriteBlock(&tSi5351, Replay_I2CWriteBlock)
+    ) {
+      fprintf(stderr, "%s: cannot open\n", pszDevice);
+      return 1;
+    }
+    printf("target: %s address 0x%02X\n", pszDevice, tTarget.u8Address);
+#else
+    fprintf(stderr, "-i needs Linux i2c-dev\n");
+    return 1;
+#endif
+  } else {
+    Si5351_Model_DefaultConfig(&tConfig);
+    tConfig.u8Type = SI5351_TYPE;
+    tConfig.u8ClkNum = SI5351_CLKNUM;
+    tConfig.u32XTALFreq = SI5351_XTAL_FREQ;
+    tConfig.u32BusHz = u32BusHz;
+    if(
+      !Si5351_Model_Initialize(&tTarget.tModel, &tConfig) ||
+      !Si5351_Initialize(&tSi5351, &tTarget.tModel, Si5351_Model_Read, Si5351_Model_Write, Replay_MemoryBarrier, NULL) ||
+      !Si5351_SetReadBlock(&tSi5351, Si5351_Model_ReadBlock) ||
+      !Si5351_SetWriteBlock(&tSi5351, Si5351_Model_WriteBlock)
+    ) {
+      fprintf(stderr, "model initialize failed\n");
+      return 1;
+    }
+    tReplay.tClock = Replay_ModelClock;
+    tReplay.tWait = Replay_ModelWait;
+    printf("target: model, SCL %u Hz, virtual time\n", tConfig.u32BusHz);
+  }
+  tReplay.pContext = &tTarget;
+  tReplay.tNotify = bVerbose ? Replay_Notify : NULL;
+
+  printf("trace: %u entries from #%u%s, speed %s\n", tLog.u32Count, tLog.u32First,
+    tLog.u32First ? " (ring wrapped, earlier state unknown)" : "",
+    (tReplay.tSpeed == SI5351_REPLAY_MAX) ? "max" : "recorded");
+  u64Wall = Bench_Nanoseconds();
+  Si5351_Replay_Run(&tResult, &tSi5351, &tLog, &tReplay);
+  u64Wall = Bench_Nanoseconds() - u64Wall;
+
+  printf("transfers  %u (%u write, %u read), %u + %u bytes, %u marks, %u skipped, %u failed\n",
+    tResult.u32Transfers, tResult.u32Writes, tResult.u32Transfers - tResult.u32Writes - tResult.u32Failed,
+    tResult.u32WriteBytes, tResult.u32ReadBytes, tResult.u32Marks, tResult.u32Skipped, tResult.u32Failed);
+  if(tResult.u64RunNs) {
+    printf("throughput %.0f transfers/s, %.0f bytes/s over %.3f ms (host %.3f ms)\n",
+      tResult.u32Transfers * 1e9 / tResult.u64RunNs,
+      (tResult.u32WriteBytes + tResult.u32ReadBytes) * 1e9 / tResult.u64RunNs,
+      tResult.u64RunNs / 1e6, u64Wall / 1e6);
+  }
+  if(tResult.u32Transfers) {
+    printf("drift      end %+.3f us, late max %+.3f us, early max %+.3f us, mean %+.3f us (trace span %.3f ms)\n",
+      tResult.i64DriftEndNs / 1e3, tResult.i64DriftMaxNs / 1e3, tResult.i64DriftMinNs / 1e3,
+      (double)tResult.i64DriftSumNs / tResult.u32Transfers / 1e3, tResult.u64TraceNs / 1e6);
+  }
+  printf("reads      %u bytes differ from the recording\n", tResult.u32ReadDiffs);
+  printf("image      %u registers compared, %u differ\n", tResult.u16Compared, tResult.u16Differ);
+  for(u32Reg = 0; u32Reg < 256; u32Reg++) {
+    if(tResult.abCompared[u32Reg] && tResult.au8Expected[u32Reg] != tResult.au8Actual[u32Reg]) {
+      printf("  reg 0x%02X expected %02X actual %02X\n", u32Reg, tResult.au8Expected[u32Reg], tResult.au8Actual[u32Reg]);
+    }
+  }
+#if defined(__linux__)
+  if(pszDevice) {
+    if(tTarget.u32Errors) {
+      printf("i2c errors %u\n", tTarget.u32Errors);
+    }
+    close(tTarget.iFd);
+  }
+#endif
+  Si5351_TraceLog_Free(&tLog);
+
+  return (tResult.u32Failed || tResult.u16Differ) ? 1 : 0;
+}
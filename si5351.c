@@ -1,7 +1,17 @@
 /* Si5351 Driver by AZO */
 
 #include <stdio.h>
+#include <string.h>
 #include "si5351.h"
+#if defined(SI5351_USE_ATOMIC_LOCK)
+#include <stdatomic.h>
+#endif
+#if defined(SI5351_USE_PTHREAD_LOCK)
+#include <pthread.h>
+#endif
+#if defined(SI5351_CONTEXT_ID)
+#include <assert.h>
+#endif
 
 /*
   1. PLL Selection
@@ -170,308 +180,1558 @@ extern "C" {
 
 #define MAX_DENO 1048574
 
-static void Lock(Si5351_t* ptSi5351) {
-  ptSi5351->tMemoryBarrier();
-  while(*ptSi5351->ppLock != ptSi5351) {
-    if(!*ptSi5351->ppLock) {
-      *ptSi5351->ppLock = ptSi5351;
-      ptSi5351->tMemoryBarrier();
-    }
-  }
+static bool InTransaction(const Si5351_t* ptSi5351) {
+  return (ptSi5351->ptCache && ptSi5351->ptCache->bTransaction) ? true : false;
 }
 
-static void Unlock(Si5351_t* ptSi5351) {
-  *ptSi5351->ppLock = NULL;
-  ptSi5351->tMemoryBarrier();
+#if defined(SI5351_USE_ATOMIC_LOCK)
+/*
+  *ppLock as a ticket lock word: upper half the next ticket, lower half the
+  ticket being served (NULL: free). Both halves count modulo their width.
+*/
+#define LOCK_PTR(ptSi5351) ((volatile _Atomic(uintptr_t)*)(ptSi5351)->ppLock)
+#define LOCK_HALF          (sizeof(uintptr_t) * 4)
+#define LOCK_SERVING_MASK  (((uintptr_t)1 << LOCK_HALF) - 1)
+#define LOCK_TICKET        ((uintptr_t)1 << LOCK_HALF)
+#endif
+
+/* Lock policies */
+const Si5351_LockPolicy_t Si5351_LockPolicyNone = { NULL, NULL, NULL };
+
+#if defined(SI5351_USE_PTHREAD_LOCK)
+static void PthreadLock(void* pContext) {
+  pthread_mutex_lock((pthread_mutex_t*)pContext);
 }
 
-/* Initialize */
+static bool PthreadTryLock(void* pContext) {
+  return (pthread_mutex_trylock((pthread_mutex_t*)pContext) == 0) ? true : false;
+}
 
-bool Si5351_Initialize(
-  Si5351_t* ptSi5351,
-  void* pInstance,
-  const Si5351_Read_t tRead,
-  const Si5351_Write_t tWrite,
-  const Si5351_MemoryBarrier_t tMemoryBarrier,
-  void** ppLock
-) {
+static void PthreadUnlock(void* pContext) {
+  pthread_mutex_unlock((pthread_mutex_t*)pContext);
+}
+
+const Si5351_LockPolicy_t Si5351_LockPolicyPthread = { PthreadLock, PthreadTryLock, PthreadUnlock };
+#endif
+
+#if defined(SI5351_USE_ATOMIC_LOCK)
+#define TICKET_PTR(pu32Ticket) ((volatile _Atomic(uint32_t)*)(pu32Ticket))
+
+bool Si5351_InitArbiter(Si5351_Arbiter_t* ptArbiter, const Si5351_MemoryBarrier_t tWait) {
   bool bValid = false;
 
-  if(ptSi5351 && pInstance && tRead && tWrite && tMemoryBarrier && ppLock) {
+  if(ptArbiter) {
     bValid = true;
-    ptSi5351->pInstance = pInstance;
-    ptSi5351->tRead  = tRead;
-    ptSi5351->tWrite = tWrite;
-    ptSi5351->tMemoryBarrier = tMemoryBarrier;
-    ptSi5351->ppLock = ppLock;
+    atomic_store_explicit(TICKET_PTR(&ptArbiter->u32Next), 0, memory_order_relaxed);
+    atomic_store_explicit(TICKET_PTR(&ptArbiter->u32Serving), 0, memory_order_release);
+    ptArbiter->tWait = tWait;
   }
 
   return bValid;
 }
 
-bool Si5351_InitDevice(const Si5351_t* ptSi5351) {
-  bool bValid = false;
-  uint8_t u8Reg;
-
-  if(ptSi5351) {
-    if(ptSi5351->tRead && ptSi5351->tWrite) {
-      bValid = true;
-
-      /* Disable Outputs */
-      /* Set CLKx_DIS high; Reg.3 = 0xFF */
-      Lock(ptSi5351);
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x03, 0xFF);
-
-      /* Powerdown all output drivers */
-      /* Reg.16,17,18,19,20,21,22,23 = 0x80 */
-      for(u8Reg = 0x10; u8Reg <= 0x17; u8Reg++) {
-        ptSi5351->tWrite(ptSi5351->pInstance, u8Reg, 0x80);
-      }
+static void ArbiterLock(void* pContext) {
+  Si5351_Arbiter_t* ptArbiter = (Si5351_Arbiter_t*)pContext;
+  uint32_t u32Ticket = atomic_fetch_add_explicit(TICKET_PTR(&ptArbiter->u32Next), 1, memory_order_relaxed);
 
-      /* Set interrupt masks */
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x02, 0xF0);
-      Unlock(ptSi5351);
+  while(atomic_load_explicit(TICKET_PTR(&ptArbiter->u32Serving), memory_order_acquire) != u32Ticket) {
+    if(ptArbiter->tWait) {
+      ptArbiter->tWait();
     }
   }
+}
 
-/*
-Write new configuration to device using
-the contents of the register map. This
-step also powers up the output drivers.
-(Registers 15-92 and 149-170)
-Apply PLLA and PLLB soft reset
-Reg. 177 = 0xAC
-Enable desired outputs
-*/
+/* Takes a ticket only when nobody holds or waits for the bus */
+static bool ArbiterTryLock(void* pContext) {
+  Si5351_Arbiter_t* ptArbiter = (Si5351_Arbiter_t*)pContext;
+  uint32_t u32Serving = atomic_load_explicit(TICKET_PTR(&ptArbiter->u32Serving), memory_order_acquire);
 
-  return bValid;
+  return atomic_compare_exchange_strong_explicit(
+    TICKET_PTR(&ptArbiter->u32Next), &u32Serving, u32Serving + 1, memory_order_acquire, memory_order_relaxed
+  ) ? true : false;
 }
 
-/* Status */
-
-bool Si5351_GetStatus(Si5351_Status_t* ptStatus, const Si5351_t* ptSi5351) {
-  bool bValid = false;
-  uint8_t u8Value;
+static void ArbiterUnlock(void* pContext) {
+  Si5351_Arbiter_t* ptArbiter = (Si5351_Arbiter_t*)pContext;
 
-  if(ptStatus && ptSi5351) {
-    if(ptSi5351->tRead) {
-      bValid = true;
-      Lock(ptSi5351);
-      u8Value = ptSi5351->tRead(ptSi5351->pInstance, 0x00);
-      Unlock(ptSi5351);
+  atomic_fetch_add_explicit(TICKET_PTR(&ptArbiter->u32Serving), 1, memory_order_release);
+}
 
-      ptStatus->bSYS_INIT = ((u8Value >> 7) & 0x1) ? true : false;
-#if SI5351_TYPE == 2
-      ptStatus->bLOL_B    = ((u8Value >> 6) & 0x1) ? true : false;
-      ptStatus->bLOL_A    = ((u8Value >> 5) & 0x1) ? true : false;
-      ptStatus->bLOS      = ((u8Value >> 4) & 0x1) ? true : false;
+const Si5351_LockPolicy_t Si5351_LockPolicyArbiter = { ArbiterLock, ArbiterTryLock, ArbiterUnlock };
 #endif
-    }
-  }
 
-  return bValid;
+/* With a lock policy or the ticket lock, ownership is per instance: held while u8LockDepth > 0 */
+static bool IsLockOwner(const Si5351_t* ptSi5351) {
+#if defined(SI5351_USE_ATOMIC_LOCK)
+  return ptSi5351->u8LockDepth ? true : false;
+#else
+  if(ptSi5351->ptLockPolicy) {
+    return ptSi5351->u8LockDepth ? true : false;
+  }
+  ptSi5351->tMemoryBarrier();
+  return (*ptSi5351->ppLock == ptSi5351) ? true : false;
+#endif
 }
 
-bool Si5351_GetStickyStatus(Si5351_Status_t* ptStatus, const Si5351_t* ptSi5351) {
-  bool bValid = false;
-  uint8_t u8Value;
-
-  if(ptStatus && ptSi5351) {
-    if(ptSi5351->tRead) {
-      bValid = true;
-      Lock(ptSi5351);
-      u8Value = ptSi5351->tRead(ptSi5351->pInstance, 0x01);
-      Unlock(ptSi5351);
+/* Lock that can wait without polling attempts: a policy with tLock, the ticket lock */
+static bool CanBlock(const Si5351_t* ptSi5351) {
+  if(ptSi5351->ptLockPolicy) {
+    return ptSi5351->ptLockPolicy->tLock ? true : false;
+  }
+#if defined(SI5351_USE_ATOMIC_LOCK)
+  return true;
+#else
+  return false;
+#endif
+}
 
-      ptStatus->bSYS_INIT = ((u8Value >> 7) & 0x1) ? true : false;
-#if SI5351_TYPE == 2
-      ptStatus->bLOL_B    = ((u8Value >> 6) & 0x1) ? true : false;
-      ptStatus->bLOL_A    = ((u8Value >> 5) & 0x1) ? true : false;
-      ptStatus->bLOS      = ((u8Value >> 4) & 0x1) ? true : false;
+static void BlockLock(Si5351_t* ptSi5351) {
+#if defined(SI5351_USE_ATOMIC_LOCK)
+  uintptr_t uTicket;
 #endif
-    }
-  }
 
-  return bValid;
+  if(ptSi5351->ptLockPolicy) {
+    ptSi5351->ptLockPolicy->tLock(ptSi5351->pLockContext);
+    return;
+  }
+#if defined(SI5351_USE_ATOMIC_LOCK)
+  /* served in arrival order */
+  uTicket = atomic_fetch_add_explicit(LOCK_PTR(ptSi5351), LOCK_TICKET, memory_order_relaxed) >> LOCK_HALF;
+  while((atomic_load_explicit(LOCK_PTR(ptSi5351), memory_order_acquire) & LOCK_SERVING_MASK) != uTicket) {
+    ptSi5351->tMemoryBarrier();
+  }
+#endif
 }
 
-bool Si5351_SetStickyStatus(const Si5351_t* ptSi5351, const Si5351_Status_t* ptStatus) {
-  bool bValid = false;
-
-  if(ptSi5351 && ptStatus) {
-    if(ptSi5351->tWrite) {
-      bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x01,
-#if SI5351_TYPE != 2
-        (uint8_t)(ptStatus->bSYS_INIT ? 1 : 0) << 7
+#if defined(SI5351_CONTEXT_ID)
+#define OwnerSet(ptSi5351) ((ptSi5351)->uOwner = (uintptr_t)SI5351_CONTEXT_ID())
+/* another thread / ISR on an instance whose lock is held */
+#define OwnerCheck(ptSi5351) assert((ptSi5351)->uOwner == (uintptr_t)SI5351_CONTEXT_ID())
 #else
-        (uint8_t)(ptStatus->bSYS_INIT ? 1 : 0) << 7 |
-        (uint8_t)(ptStatus->bLOL_B    ? 1 : 0) << 6 |
-        (uint8_t)(ptStatus->bLOL_A    ? 1 : 0) << 5 |
-        (uint8_t)(ptStatus->bLOS      ? 1 : 0) << 4
+#define OwnerSet(ptSi5351)
+#define OwnerCheck(ptSi5351)
 #endif
-      );
-      Unlock(ptSi5351);
+
+/* One attempt to take a free lock */
+static bool TakeLock(Si5351_t* ptSi5351) {
+#if defined(SI5351_USE_ATOMIC_LOCK)
+  uintptr_t uWord;
+#endif
+
+  if(ptSi5351->ptLockPolicy) {
+    if(ptSi5351->ptLockPolicy->tTryLock) {
+      return ptSi5351->ptLockPolicy->tTryLock(ptSi5351->pLockContext);
+    }
+    if(ptSi5351->ptLockPolicy->tLock) {
+      ptSi5351->ptLockPolicy->tLock(ptSi5351->pLockContext);
     }
+    return true;
   }
-
-  return bValid;
+#if defined(SI5351_USE_ATOMIC_LOCK)
+  /* a ticket only when it is served at once */
+  uWord = atomic_load_explicit(LOCK_PTR(ptSi5351), memory_order_relaxed);
+  if((uWord >> LOCK_HALF) != (uWord & LOCK_SERVING_MASK)) {
+    return false;
+  }
+  return atomic_compare_exchange_strong_explicit(
+    LOCK_PTR(ptSi5351), &uWord, uWord + LOCK_TICKET, memory_order_acquire, memory_order_relaxed
+  ) ? true : false;
+#else
+  ptSi5351->tMemoryBarrier();
+  if(!*ptSi5351->ppLock) {
+    *ptSi5351->ppLock = ptSi5351;
+    ptSi5351->tMemoryBarrier();
+  }
+  return (*ptSi5351->ppLock == ptSi5351) ? true : false;
+#endif
 }
 
-bool Si5351_GetStatusMask(Si5351_Status_t* ptStatus, const Si5351_t* ptSi5351) {
-  bool bValid = false;
-  uint8_t u8Value;
-
-  if(ptStatus && ptSi5351) {
-    if(ptSi5351->tRead) {
-      bValid = true;
-      Lock(ptSi5351);
-      u8Value = ptSi5351->tRead(ptSi5351->pInstance, 0x02);
-      Unlock(ptSi5351);
-
-      ptStatus->bSYS_INIT = ((u8Value >> 7) & 0x1) ? true : false;
-#if SI5351_TYPE == 2
-      ptStatus->bLOL_B    = ((u8Value >> 6) & 0x1) ? true : false;
-      ptStatus->bLOL_A    = ((u8Value >> 5) & 0x1) ? true : false;
-      ptStatus->bLOS      = ((u8Value >> 4) & 0x1) ? true : false;
+static void ReleaseLock(Si5351_t* ptSi5351) {
+#if defined(SI5351_USE_ATOMIC_LOCK)
+  uintptr_t uWord;
 #endif
+
+  if(ptSi5351->ptLockPolicy) {
+    if(ptSi5351->ptLockPolicy->tUnlock) {
+      ptSi5351->ptLockPolicy->tUnlock(ptSi5351->pLockContext);
     }
+    return;
   }
-
-  return bValid;
+#if defined(SI5351_USE_ATOMIC_LOCK)
+  /* serve the next ticket; the lower half must not carry into the upper */
+  uWord = atomic_load_explicit(LOCK_PTR(ptSi5351), memory_order_relaxed);
+  while(!atomic_compare_exchange_weak_explicit(
+    LOCK_PTR(ptSi5351), &uWord, (uWord & ~LOCK_SERVING_MASK) | ((uWord + 1) & LOCK_SERVING_MASK),
+    memory_order_release, memory_order_relaxed
+  )) {
+  }
+#else
+  *ptSi5351->ppLock = NULL;
+  ptSi5351->tMemoryBarrier();
+#endif
 }
 
-bool Si5351_SetStatusMask(const Si5351_t* ptSi5351, const Si5351_Status_t* ptStatus) {
+/* u32Tries attempts (0: no limit), backoff doubles up to SI5351_LOCK_BACKOFF_MAX */
+static bool AcquireLock(Si5351_t* ptSi5351, const uint32_t u32Tries) {
   bool bValid = false;
+  uint32_t u32Try;
+  uint16_t u16Backoff = 1;
+  uint16_t u16Spin;
 
-  if(ptSi5351 && ptStatus) {
-    if(ptSi5351->tWrite) {
-      bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x02,
-#if SI5351_TYPE != 2
-        (uint8_t)(ptStatus->bSYS_INIT ? 1 : 0) << 7
-#else
-        (uint8_t)(ptStatus->bSYS_INIT ? 1 : 0) << 7 |
-        (uint8_t)(ptStatus->bLOL_B    ? 1 : 0) << 6 |
-        (uint8_t)(ptStatus->bLOL_A    ? 1 : 0) << 5 |
-        (uint8_t)(ptStatus->bLOS      ? 1 : 0) << 4
-#endif
-      );
-      Unlock(ptSi5351);
+  if(IsLockOwner(ptSi5351)) {
+    OwnerCheck(ptSi5351);
+    bValid = true;
+    ptSi5351->u8LockDepth++;
+  } else if(!u32Tries && CanBlock(ptSi5351)) {
+    /* blocking policy sleeps, the ticket lock queues, instead of polling */
+    bValid = true;
+    BlockLock(ptSi5351);
+    ptSi5351->u8LockDepth = 1;
+    OwnerSet(ptSi5351);
+  } else {
+    for(u32Try = 0; !bValid && (!u32Tries || u32Try < u32Tries); u32Try++) {
+      if(TakeLock(ptSi5351)) {
+        bValid = true;
+        ptSi5351->u8LockDepth = 1;
+        OwnerSet(ptSi5351);
+      } else {
+        for(u16Spin = 0; u16Spin < u16Backoff; u16Spin++) {
+          ptSi5351->tMemoryBarrier();
+        }
+        if(u16Backoff < SI5351_LOCK_BACKOFF_MAX) {
+          u16Backoff <<= 1;
+        }
+      }
     }
   }
 
   return bValid;
 }
 
-/* Control */
-
-/* Reg.3 Output Enable Control */
-bool Si5351_GetOutputEnable(uint8_t* pu8Disable, const Si5351_t* ptSi5351) {
-  bool bValid = false;
-
-  if(pu8Disable && ptSi5351) {
-    if(ptSi5351->tRead) {
-      bValid = true;
-      Lock(ptSi5351);
-      *pu8Disable = ptSi5351->tRead(ptSi5351->pInstance, 0x03);
-      Unlock(ptSi5351);
+static void DropLock(Si5351_t* ptSi5351) {
+  if(ptSi5351->u8LockDepth) {
+    OwnerCheck(ptSi5351);
+    if(!--ptSi5351->u8LockDepth) {
+      ReleaseLock(ptSi5351);
     }
   }
+}
 
-  return bValid;
+/*
+  Operation tracking for statistics and trace: the outermost public call
+  owns the bus traffic of the calls it makes.
+*/
+#if defined(SI5351_USE_STATS) || defined(SI5351_USE_TRACE)
+#define SI5351_USE_OP
+#endif
+
+#if defined(SI5351_USE_STATS)
+static uint32_t OpTime(const Si5351_Stats_t* ptStats) {
+  return ptStats->tTimestamp ? ptStats->tTimestamp() : 0;
 }
 
-bool Si5351_SetOutputEnable(const Si5351_t* ptSi5351, const uint8_t u8Enable) {
-  bool bValid = false;
-  uint8_t u8Value;
+static bool IsMeasured(const Si5351_t* ptSi5351) {
+  return (ptSi5351->ptStats && ptSi5351->u8Api != SI5351_API_NONE) ? true : false;
+}
+#endif
 
-  if(ptSi5351) {
-    if(ptSi5351->tWrite) {
-      bValid = Si5351_GetOutputEnable(&u8Value, ptSi5351);
-      if(bValid) {
-        Lock(ptSi5351);
-#if SI5351_CLKNUM <= 3
-        ptSi5351->tWrite(ptSi5351->pInstance, 0x03, (u8Value & ~(u8Enable & 0x7)));
+#if defined(SI5351_USE_TRACE)
+/* u8Count consecutive entries, also when another context records at the same time */
+static uint32_t TraceReserve(Si5351_Trace_t* ptTrace, const uint8_t u8Count) {
+#if defined(SI5351_USE_ATOMIC_LOCK)
+  return atomic_fetch_add_explicit(TICKET_PTR(&ptTrace->u32Head), u8Count, memory_order_relaxed);
 #else
-        ptSi5351->tWrite(ptSi5351->pInstance, 0x03, (u8Value & ~u8Enable));
-#endif
-        Unlock(ptSi5351);
-      }
-    }
-  }
+  uint32_t u32Head = ptTrace->u32Head;
 
-  return bValid;
+  ptTrace->u32Head = u32Head + u8Count;
+  return u32Head;
+#endif
 }
 
-bool Si5351_SetOutputDisable(const Si5351_t* ptSi5351, const uint8_t u8Disable) {
-  bool bValid = false;
-  uint8_t u8Value;
+static void TraceRecord(
+  Si5351_Trace_t* ptTrace, const uint8_t u8Flags, const uint8_t u8Api,
+  const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count
+) {
+  Si5351_TraceEntry_t* ptEntry;
+  uint32_t u32Time;
+  uint32_t u32Index;
+  uint8_t u8Index;
 
-  if(ptSi5351) {
-    if(ptSi5351->tWrite) {
-      bValid = Si5351_GetOutputEnable(&u8Value, ptSi5351);
-      if(bValid) {
-        Lock(ptSi5351);
-#if SI5351_CLKNUM <= 3
-        ptSi5351->tWrite(ptSi5351->pInstance, 0x03, (u8Value | (u8Disable & 0x7)));
-#else
-        ptSi5351->tWrite(ptSi5351->pInstance, 0x03, (u8Value | u8Disable));
+  if(ptTrace->bFrozen) {
+    return;
+  }
+  u32Time = ptTrace->tTimestamp ? ptTrace->tTimestamp() : 0;
+  u32Index = TraceReserve(ptTrace, u8Count);
+  for(u8Index = 0; u8Index < u8Count; u8Index++) {
+    ptEntry = &ptTrace->ptEntry[(u32Index + u8Index) & ptTrace->u32Mask];
+    ptEntry->u32Time = u32Time;
+    ptEntry->u8Reg = u8Reg + u8Index;
+    ptEntry->u8Value = pu8Value[u8Index];
+    ptEntry->u8Api = u8Api;
+    ptEntry->u8Flags = u8Flags | (!u8Index ? SI5351_TRACE_START : 0);
+  }
+}
 #endif
-        Unlock(ptSi5351);
-      }
+
+#if defined(SI5351_USE_OP)
+static void OpBegin(Si5351_t* ptSi5351, const Si5351_Api_t tApi) {
+  if(!ptSi5351->u8ApiDepth++) {
+    ptSi5351->u8Api = (uint8_t)tApi;
+#if defined(SI5351_USE_STATS)
+    if(IsMeasured(ptSi5351)) {
+      ptSi5351->ptStats->atOp[tApi].u32Calls++;
+      ptSi5351->ptStats->u32Start = OpTime(ptSi5351->ptStats);
     }
+#endif
   }
-
-  return bValid;
 }
 
-/* Reg.9 OEB Pin Enable Control Mask */
-bool Si5351_GetOutputControlMask(uint8_t* pu8ControlMask, const Si5351_t* ptSi5351) {
-  bool bValid = false;
-
-  if(pu8ControlMask && ptSi5351) {
-    if(ptSi5351->tRead) {
-      bValid = true;
-      Lock(ptSi5351);
-#if SI5351_CLKNUM <= 3
-      *pu8ControlMask = (ptSi5351->tRead(ptSi5351->pInstance, 0x09) & 0x7);
-#else
-      *pu8ControlMask =  ptSi5351->tRead(ptSi5351->pInstance, 0x09);
+static void OpEnd(Si5351_t* ptSi5351) {
+#if defined(SI5351_USE_STATS)
+  Si5351_OpStats_t* ptOp;
+  uint32_t u32Time;
 #endif
-      Unlock(ptSi5351);
+
+  if(ptSi5351->u8ApiDepth && !--ptSi5351->u8ApiDepth) {
+#if defined(SI5351_USE_STATS)
+    if(IsMeasured(ptSi5351)) {
+      ptOp = &ptSi5351->ptStats->atOp[ptSi5351->u8Api];
+      u32Time = OpTime(ptSi5351->ptStats) - ptSi5351->ptStats->u32Start;
+      ptOp->u64Time += u32Time;
+      if(ptOp->u32TimeMax < u32Time) {
+        ptOp->u32TimeMax = u32Time;
+      }
     }
+#endif
+    ptSi5351->u8Api = SI5351_API_NONE;
   }
-
-  return bValid;
 }
 
-bool Si5351_SetOutputControlMask(const Si5351_t* ptSi5351, const uint8_t u8ControlMask) {
-  bool bValid = false;
+/* One bus transfer of u8Count bytes done */
+static void OpBus(
+  const Si5351_t* ptSi5351, const bool bWrite, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count
+) {
+#if defined(SI5351_USE_STATS)
+  Si5351_OpStats_t* ptOp;
 
-  if(ptSi5351) {
-    if(ptSi5351->tWrite) {
-      bValid = true;
-      Lock(ptSi5351);
-#if SI5351_CLKNUM <= 3
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x09, (u8ControlMask & 0x7));
-#else
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x09,  u8ControlMask);
+#if !defined(SI5351_USE_TRACE)
+  (void)u8Reg;
+  (void)pu8Value;
 #endif
-      Unlock(ptSi5351);
+  if(IsMeasured(ptSi5351)) {
+    ptOp = &ptSi5351->ptStats->atOp[ptSi5351->u8Api];
+    ptOp->u32Transfers++;
+    if(bWrite) {
+      ptOp->u32WriteBytes += u8Count;
+    } else {
+      ptOp->u32ReadBytes += u8Count;
     }
   }
-
-  return bValid;
+#endif
+#if defined(SI5351_USE_TRACE)
+  if(ptSi5351->ptTrace) {
+    TraceRecord(
+      ptSi5351->ptTrace, (uint8_t)((ptSi5351->u8Device << 4) | (bWrite ? SI5351_TRACE_WRITE : 0)),
+      ptSi5351->u8Api, u8Reg, pu8Value, u8Count
+    );
+  }
+#endif
 }
+#else
+#define OpBegin(ptSi5351, tApi) ((void)(tApi))
+#define OpEnd(ptSi5351)
+#define OpBus(ptSi5351, bWrite, u8Reg, pu8Value, u8Count)
+#endif
 
-/* Reg.15 PLL Input Source */
+#if defined(SI5351_USE_STATS)
+static uint32_t OpWaitBegin(const Si5351_t* ptSi5351) {
+  return ptSi5351->ptStats ? OpTime(ptSi5351->ptStats) : 0;
+}
 
-#if SI5351_TYPE == 2
+static void OpWaitEnd(const Si5351_t* ptSi5351, const uint32_t u32WaitStart) {
+  if(IsMeasured(ptSi5351)) {
+    ptSi5351->ptStats->atOp[ptSi5351->u8Api].u64LockWait += OpTime(ptSi5351->ptStats) - u32WaitStart;
+  }
+}
+#else
+#define OpWaitBegin(ptSi5351) 0
+#define OpWaitEnd(ptSi5351, u32WaitStart) ((void)(u32WaitStart))
+#endif
+
+/*
+  Always through AcquireLock: the owner of an open transaction nests, any
+  other context waits, so the transaction state is only read with the lock
+  held. Operation state is only touched with the lock held.
+*/
+/* Getters lock a const handle too, only the lock and stats state changes */
+static void Lock(const Si5351_t* ptSi5351, const Si5351_Api_t tApi) {
+  Si5351_t* ptLock = (Si5351_t*)ptSi5351;
+  uint32_t u32WaitStart;
+
+  u32WaitStart = OpWaitBegin(ptLock);
+  AcquireLock(ptLock, 0);
+  OpBegin(ptLock, tApi);
+  OpWaitEnd(ptLock, u32WaitStart);
+}
+
+static void Unlock(const Si5351_t* ptSi5351) {
+  Si5351_t* ptLock = (Si5351_t*)ptSi5351;
+
+  OpEnd(ptLock);
+  DropLock(ptLock);
+}
+
+/* Register access (call with lock) */
+/*
+  Reg.0,1 are status registers updated by the device itself, never cached.
+  Reg.177 PLLA_RST/PLLB_RST bits are self-clearing, cached as 0.
+*/
+static bool IsCacheable(const uint8_t u8Reg) {
+  return (u8Reg > 0x01) ? true : false;
+}
+
+static uint8_t CacheMask(const uint8_t u8Reg) {
+  return (u8Reg == 0xB1) ? 0x5F : 0xFF;
+}
+
+static bool IsCached(const Si5351_Cache_t* ptCache, const uint8_t u8Reg) {
+  return (ptCache->au8Valid[u8Reg >> 3] >> (u8Reg & 0x7)) & 0x1 ? true : false;
+}
+
+static bool IsDirty(const Si5351_Cache_t* ptCache, const uint16_t u16Reg) {
+  return (ptCache->au8Dirty[u16Reg >> 3] >> (u16Reg & 0x7)) & 0x1 ? true : false;
+}
+
+static void StoreCache(Si5351_Cache_t* ptCache, const uint8_t u8Reg, const uint8_t u8Value) {
+  ptCache->au8Value[u8Reg] = u8Value & CacheMask(u8Reg);
+  ptCache->au8Valid[u8Reg >> 3] |= (uint8_t)(1 << (u8Reg & 0x7));
+}
+
+static uint8_t ReadReg(const Si5351_t* ptSi5351, const uint8_t u8Reg) {
+  Si5351_Cache_t* ptCache = ptSi5351->ptCache;
+  uint8_t u8Value;
+
+  if(ptCache && IsCacheable(u8Reg) && IsCached(ptCache, u8Reg)) {
+    u8Value = ptCache->au8Value[u8Reg];
+  } else {
+    u8Value = ptSi5351->tRead(ptSi5351->pInstance, u8Reg);
+    OpBus(ptSi5351, false, u8Reg, &u8Value, 1);
+    if(ptCache && IsCacheable(u8Reg)) {
+      StoreCache(ptCache, u8Reg, u8Value);
+    }
+  }
+
+  return u8Value;
+}
+
+static void FetchBlock(const Si5351_t* ptSi5351, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count) {
+  uint8_t u8Index;
+
+  if(ptSi5351->tReadBlock) {
+    ptSi5351->tReadBlock(ptSi5351->pInstance, u8Reg, pu8Value, u8Count);
+    OpBus(ptSi5351, false, u8Reg, pu8Value, u8Count);
+  } else {
+    for(u8Index = 0; u8Index < u8Count; u8Index++) {
+      pu8Value[u8Index] = ptSi5351->tRead(ptSi5351->pInstance, u8Reg + u8Index);
+      OpBus(ptSi5351, false, u8Reg + u8Index, &pu8Value[u8Index], 1);
+    }
+  }
+  if(ptSi5351->ptCache) {
+    for(u8Index = 0; u8Index < u8Count; u8Index++) {
+      if(IsCacheable(u8Reg + u8Index)) {
+        if(IsDirty(ptSi5351->ptCache, u8Reg + u8Index)) {
+          /* Staged in a transaction, not yet on the device */
+          pu8Value[u8Index] = ptSi5351->ptCache->au8Value[u8Reg + u8Index];
+        } else {
+          StoreCache(ptSi5351->ptCache, u8Reg + u8Index, pu8Value[u8Index]);
+        }
+      }
+    }
+  }
+}
+
+static void ReadBlock(const Si5351_t* ptSi5351, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count) {
+  Si5351_Cache_t* ptCache = ptSi5351->ptCache;
+  uint8_t u8Index;
+
+  if(ptCache) {
+    for(u8Index = 0; u8Index < u8Count; u8Index++) {
+      if(!IsCacheable(u8Reg + u8Index) || !IsCached(ptCache, u8Reg + u8Index)) {
+        break;
+      }
+      pu8Value[u8Index] = ptCache->au8Value[u8Reg + u8Index];
+    }
+    if(u8Index == u8Count) {
+      return;
+    }
+  }
+  FetchBlock(ptSi5351, u8Reg, pu8Value, u8Count);
+}
+
+/* Bus only */
+static void FlushBlock(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+  uint8_t u8Index;
+
+  if(ptSi5351->tWriteBlock && u8Count > 1) {
+    ptSi5351->tWriteBlock(ptSi5351->pInstance, u8Reg, pu8Value, u8Count);
+    OpBus(ptSi5351, true, u8Reg, pu8Value, u8Count);
+  } else {
+    for(u8Index = 0; u8Index < u8Count; u8Index++) {
+      ptSi5351->tWrite(ptSi5351->pInstance, u8Reg + u8Index, pu8Value[u8Index]);
+      OpBus(ptSi5351, true, u8Reg + u8Index, &pu8Value[u8Index], 1);
+    }
+  }
+}
+
+/*
+  With a cache every write is staged in the image and marked dirty first.
+  In write-elision mode a byte equal to the known device value is dropped.
+*/
+static void StageReg(Si5351_Cache_t* ptCache, const uint8_t u8Reg, const uint8_t u8Value) {
+  if(
+    ptCache->bElide && IsCacheable(u8Reg) && IsCached(ptCache, u8Reg) &&
+    !IsDirty(ptCache, u8Reg) && ptCache->au8Value[u8Reg] == u8Value
+  ) {
+    ptCache->tWriteStats.u32Elided++;
+    return;
+  }
+  ptCache->au8Value[u8Reg] = u8Value;
+  if(IsCacheable(u8Reg)) {
+    ptCache->au8Valid[u8Reg >> 3] |= (uint8_t)(1 << (u8Reg & 0x7));
+  }
+  ptCache->au8Dirty[u8Reg >> 3] |= (uint8_t)(1 << (u8Reg & 0x7));
+}
+
+/* A clean register with a known value may be rewritten to join two runs */
+static bool IsBridgeable(const Si5351_Cache_t* ptCache, const uint16_t u16Reg) {
+  return (IsCacheable((uint8_t)u16Reg) && IsCached(ptCache, (uint8_t)u16Reg)) ? true : false;
+}
+
+/*
+  Write dirty registers of [u16First, u16End) in address order.
+  Contiguous runs become one block; runs separated by up to
+  SI5351_BRIDGE_GAP known registers are merged, since resending a few
+  bytes is cheaper than another START/address/register phase.
+*/
+#define SI5351_BRIDGE_GAP 2
+
+static void CommitRange(const Si5351_t* ptSi5351, const uint16_t u16First, const uint16_t u16End) {
+  Si5351_Cache_t* ptCache = ptSi5351->ptCache;
+  uint16_t u16Reg;
+  uint16_t u16RunEnd;
+  uint16_t u16Next;
+
+  for(u16Reg = u16First; u16Reg < u16End; u16Reg = u16RunEnd) {
+    if(!IsDirty(ptCache, u16Reg)) {
+      u16RunEnd = u16Reg + 1;
+      continue;
+    }
+    u16RunEnd = u16Reg + 1;
+    for(;;) {
+      for(; u16RunEnd < u16End && IsDirty(ptCache, u16RunEnd); u16RunEnd++);
+      for(u16Next = u16RunEnd; u16Next < u16End && u16Next - u16RunEnd < SI5351_BRIDGE_GAP; u16Next++) {
+        if(IsDirty(ptCache, u16Next) || !IsBridgeable(ptCache, u16Next)) {
+          break;
+        }
+      }
+      if(u16Next < u16End && u16Next > u16RunEnd && IsDirty(ptCache, u16Next)) {
+        u16RunEnd = u16Next;
+      } else {
+        break;
+      }
+    }
+    FlushBlock(ptSi5351, (uint8_t)u16Reg, &ptCache->au8Value[u16Reg], (uint8_t)(u16RunEnd - u16Reg));
+    ptCache->tWriteStats.u32Issued += u16RunEnd - u16Reg;
+    for(u16Next = u16Reg; u16Next < u16RunEnd; u16Next++) {
+      ptCache->au8Value[u16Next] &= CacheMask((uint8_t)u16Next);
+      ptCache->au8Dirty[u16Next >> 3] &= (uint8_t)~(1 << (u16Next & 0x7));
+    }
+  }
+}
+
+static void WriteBlock(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+  uint8_t u8Index;
+
+  if(ptSi5351->ptCache) {
+    for(u8Index = 0; u8Index < u8Count; u8Index++) {
+      StageReg(ptSi5351->ptCache, u8Reg + u8Index, pu8Value[u8Index]);
+    }
+    if(!InTransaction(ptSi5351)) {
+      CommitRange(ptSi5351, u8Reg, (uint16_t)u8Reg + u8Count);
+    }
+  } else {
+    FlushBlock(ptSi5351, u8Reg, pu8Value, u8Count);
+  }
+}
+
+static void WriteReg(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Value) {
+  WriteBlock(ptSi5351, u8Reg, &u8Value, 1);
+}
+
+/* Replace the u8Mask bits of a register, the read is served from the cache when present */
+static void ModifyReg(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Mask, const uint8_t u8Value) {
+  WriteReg(ptSi5351, u8Reg, (ReadReg(ptSi5351, u8Reg) & ~u8Mask) | (u8Value & u8Mask));
+}
+
+/*
+  Multisynth parameter block (8 registers)
+    [0] P3[15:8]  [1] P3[7:0]  [2] P1[17:16] (R_DIV, DIVBY4 in upper bits)
+    [3] P1[15:8]  [4] P1[7:0]  [5] P3[19:16],P2[19:16]  [6] P2[15:8]  [7] P2[7:0]
+*/
+static void EncodeMS(uint8_t* pu8Value, const Si5351_MS_t* ptMS) {
+  pu8Value[0] = (uint8_t)((ptMS->u32MSX_P3 >>  8) & 0xFF);
+  pu8Value[1] = (uint8_t)( ptMS->u32MSX_P3        & 0xFF);
+  pu8Value[2] = (uint8_t)((ptMS->u32MSX_P1 >> 16) & 0x3);
+  pu8Value[3] = (uint8_t)((ptMS->u32MSX_P1 >>  8) & 0xFF);
+  pu8Value[4] = (uint8_t)( ptMS->u32MSX_P1        & 0xFF);
+  pu8Value[5] = (uint8_t)(((ptMS->u32MSX_P3 >> 12) & 0xF0) | ((ptMS->u32MSX_P2 >> 16) & 0xF));
+  pu8Value[6] = (uint8_t)((ptMS->u32MSX_P2 >>  8) & 0xFF);
+  pu8Value[7] = (uint8_t)( ptMS->u32MSX_P2        & 0xFF);
+}
+
+#if SI5351_CLKNUM > 3
+/* MS6/MS7 divider: even integer 6 - 254 */
+static bool IsMS67Divider(const uint32_t u32MS) {
+  return (u32MS >= 6 && u32MS <= 254 && !(u32MS & 0x1)) ? true : false;
+}
+
+/* Si5351_MS_t (P2 = 0, integer a) to MS6/MS7 divider */
+static bool MS67Divider(uint8_t* pu8MS, const Si5351_MS_t* ptMS) {
+  bool bValid = false;
+
+  if(!ptMS->bDivBy4 && ptMS->u32MSX_P2 == 0 && !((ptMS->u32MSX_P1 + 512) & 0x7F)) {
+    if(IsMS67Divider((ptMS->u32MSX_P1 + 512) >> 7)) {
+      bValid = true;
+      *pu8MS = (uint8_t)((ptMS->u32MSX_P1 + 512) >> 7);
+    }
+  }
+
+  return bValid;
+}
+#endif
+
+/*
+  Frequency hop: write only the span of an 8-register parameter block
+  that differs from the last programmed one.
+  u8Keep is the mask of reserved bits kept from the device in byte 2.
+*/
+static void RetuneBlock(const Si5351_t* ptSi5351, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t* pu8Last, const uint8_t u8Keep) {
+  uint8_t u8First;
+  uint8_t u8Last;
+
+  for(u8First = 0; u8First < 8 && pu8Value[u8First] == pu8Last[u8First]; u8First++);
+  if(u8First < 8) {
+    for(u8Last = 7; pu8Value[u8Last] == pu8Last[u8Last]; u8Last--);
+    if(u8First <= 2 && u8Last >= 2) {
+      pu8Value[2] |= ReadReg(ptSi5351, u8Reg + 2) & u8Keep;
+    }
+    WriteBlock(ptSi5351, u8Reg + u8First, &pu8Value[u8First], u8Last - u8First + 1);
+  }
+}
+
+/* Initialize */
+
+bool Si5351_Initialize(
+  Si5351_t* ptSi5351,
+  void* pInstance,
+  const Si5351_Read_t tRead,
+  const Si5351_Write_t tWrite,
+  const Si5351_MemoryBarrier_t tMemoryBarrier,
+  void** ppLock
+) {
+  bool bValid = false;
+
+  if(ptSi5351 && pInstance && tRead && tWrite && tMemoryBarrier) {
+    bValid = true;
+    ptSi5351->pInstance = pInstance;
+    ptSi5351->tRead  = tRead;
+    ptSi5351->tWrite = tWrite;
+    ptSi5351->tMemoryBarrier = tMemoryBarrier;
+    ptSi5351->ppLock = ppLock;
+    ptSi5351->ptLockPolicy = ppLock ? NULL : &Si5351_LockPolicyNone;
+    ptSi5351->pLockContext = NULL;
+    ptSi5351->tReadBlock = NULL;
+    ptSi5351->tWriteBlock = NULL;
+    ptSi5351->ptCache = NULL;
+    ptSi5351->u8LockDepth = 0;
+#if defined(SI5351_USE_OP)
+    ptSi5351->u8Api = SI5351_API_NONE;
+    ptSi5351->u8ApiDepth = 0;
+#endif
+#if defined(SI5351_USE_STATS)
+    ptSi5351->ptStats = NULL;
+#endif
+#if defined(SI5351_USE_TRACE)
+    ptSi5351->ptTrace = NULL;
+    ptSi5351->u8Device = 0;
+#endif
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetReadBlock(Si5351_t* ptSi5351, const Si5351_ReadBlock_t tReadBlock) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    bValid = true;
+    Lock(ptSi5351, SI5351_API_NONE);
+    ptSi5351->tReadBlock = tReadBlock;
+    Unlock(ptSi5351);
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetWriteBlock(Si5351_t* ptSi5351, const Si5351_WriteBlock_t tWriteBlock) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    bValid = true;
+    Lock(ptSi5351, SI5351_API_NONE);
+    ptSi5351->tWriteBlock = tWriteBlock;
+    Unlock(ptSi5351);
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetLockPolicy(Si5351_t* ptSi5351, const Si5351_LockPolicy_t* ptPolicy, void* pContext) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    /* not while this instance holds the old lock */
+    if(!ptSi5351->u8LockDepth && !InTransaction(ptSi5351)) {
+      bValid = true;
+      if(ptPolicy) {
+        ptSi5351->ptLockPolicy = ptPolicy;
+        ptSi5351->pLockContext = pContext;
+      } else {
+        ptSi5351->ptLockPolicy = ptSi5351->ppLock ? NULL : &Si5351_LockPolicyNone;
+        ptSi5351->pLockContext = NULL;
+      }
+    }
+  }
+
+  return bValid;
+}
+
+/* Register Cache */
+
+bool Si5351_AttachCache(Si5351_t* ptSi5351, Si5351_Cache_t* ptCache) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    Lock(ptSi5351, SI5351_API_NONE);
+    if(!InTransaction(ptSi5351)) {
+      bValid = true;
+      ptSi5351->ptCache = ptCache;
+      if(ptCache) {
+        memset(ptCache->au8Valid, 0, sizeof(ptCache->au8Valid));
+        memset(ptCache->au8Dirty, 0, sizeof(ptCache->au8Dirty));
+        ptCache->bTransaction = false;
+        ptCache->bElide = false;
+        ptCache->tWriteStats.u32Issued = 0;
+        ptCache->tWriteStats.u32Elided = 0;
+      }
+    }
+    Unlock(ptSi5351);
+  }
+
+  return bValid;
+}
+
+bool Si5351_InvalidateCache(const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->ptCache) {
+      Lock(ptSi5351, SI5351_API_NONE);
+      if(!InTransaction(ptSi5351)) {
+        bValid = true;
+        memset(ptSi5351->ptCache->au8Valid, 0, sizeof(ptSi5351->ptCache->au8Valid));
+      }
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_SyncCache(const Si5351_t* ptSi5351) {
+  bool bValid = false;
+  uint8_t au8Value[SI5351_REG_LAST - 0x02 + 1];
+
+  if(ptSi5351) {
+    if(ptSi5351->tRead && ptSi5351->ptCache) {
+      Lock(ptSi5351, SI5351_API_SYNCCACHE);
+      if(!InTransaction(ptSi5351)) {
+        bValid = true;
+        FetchBlock(ptSi5351, 0x02, au8Value, sizeof(au8Value));
+      }
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+/* Write Elision */
+
+bool Si5351_SetWriteElision(const Si5351_t* ptSi5351, const bool bElide) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->ptCache) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_NONE);
+      ptSi5351->ptCache->bElide = bElide;
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_GetWriteStats(Si5351_WriteStats_t* ptWriteStats, const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(ptWriteStats && ptSi5351) {
+    if(ptSi5351->ptCache) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_NONE);
+      *ptWriteStats = ptSi5351->ptCache->tWriteStats;
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_ResetWriteStats(const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->ptCache) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_NONE);
+      ptSi5351->ptCache->tWriteStats.u32Issued = 0;
+      ptSi5351->ptCache->tWriteStats.u32Elided = 0;
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+#if defined(SI5351_USE_OP)
+/* Operation Statistics / Trace */
+
+static const char* const apszApiName[SI5351_API_COUNT] = {
+  "none",
+  "Si5351_InitDevice",
+  "Si5351_SyncCache",
+  "Si5351_Transaction",
+  "Si5351_ReadRegisters",
+  "Si5351_WriteRegisters",
+  "Si5351_UpdateRegister",
+  "Si5351_SetRegisterBits",
+  "Si5351_ClearRegisterBits",
+  "Si5351_ToggleRegisterBits",
+  "Si5351_GetStatus",
+  "Si5351_GetStickyStatus",
+  "Si5351_SetStickyStatus",
+  "Si5351_GetStatusMask",
+  "Si5351_SetStatusMask",
+  "Si5351_GetOutputEnable",
+  "Si5351_SetOutputEnable",
+  "Si5351_SetOutputDisable",
+  "Si5351_GetOutputControlMask",
+  "Si5351_SetOutputControlMask",
+  "Si5351_GetCLKIN_DIV",
+  "Si5351_SetCLKIN_DIV",
+  "Si5351_GetPLLA_SRC",
+  "Si5351_SetPLLA_SRC",
+  "Si5351_GetPLLB_SRC",
+  "Si5351_SetPLLB_SRC",
+  "Si5351_GetClkPowerDown",
+  "Si5351_SetClkPowerDown",
+  "Si5351_GetClkMSSource",
+  "Si5351_SetClkMSSource",
+  "Si5351_GetClkInvert",
+  "Si5351_SetClkInvert",
+  "Si5351_GetClkSrc",
+  "Si5351_SetClkSrc",
+  "Si5351_GetClkIDrive",
+  "Si5351_SetClkIDrive",
+  "Si5351_GetClkDisableState",
+  "Si5351_SetClkDisableState",
+  "Si5351_GetMSA",
+  "Si5351_SetMSA",
+  "Si5351_GetMSB",
+  "Si5351_SetMSB",
+  "Si5351_GetMS",
+  "Si5351_SetMS",
+  "Si5351_GetMS67",
+  "Si5351_SetMS67",
+  "Si5351_SetMS67Divider",
+  "Si5351_RetuneMSA",
+  "Si5351_RetuneMSB",
+  "Si5351_RetuneMS",
+  "Si5351_GetSSPEnable",
+  "Si5351_SetSSPEnable",
+  "Si5351_SetSSPDisable",
+  "Si5351_GetSSP",
+  "Si5351_SetSSP",
+  "Si5351_GetVCXO",
+  "Si5351_SetVCXO",
+  "Si5351_GetPhaseOffset",
+  "Si5351_SetPhaseOffset",
+  "Si5351_PLLSoftReset",
+  "Si5351_GetXTALLoadCap",
+  "Si5351_SetXTALLoadCap",
+  "Si5351_SetPlan"
+};
+
+const char* Si5351_GetApiName(const Si5351_Api_t tApi) {
+  return ((uint32_t)tApi < SI5351_API_COUNT) ? apszApiName[tApi] : NULL;
+}
+#endif
+
+#if defined(SI5351_USE_STATS)
+bool Si5351_AttachStats(Si5351_t* ptSi5351, Si5351_Stats_t* ptStats, const Si5351_Timestamp_t tTimestamp) {
+  bool bValid = false;
+
+  /* not while a call or transaction of this instance is measured */
+  if(ptSi5351 && !InTransaction(ptSi5351) && !ptSi5351->u8ApiDepth) {
+    bValid = true;
+    if(ptStats) {
+      memset(ptStats, 0, sizeof(Si5351_Stats_t));
+      ptStats->tTimestamp = tTimestamp;
+    }
+    ptSi5351->ptStats = ptStats;
+  }
+
+  return bValid;
+}
+
+bool Si5351_GetStats(Si5351_OpStats_t* ptOpStats, const Si5351_t* ptSi5351, const Si5351_Api_t tApi) {
+  bool bValid = false;
+  const Si5351_OpStats_t* ptOp;
+  uint8_t u8Api;
+
+  if(ptOpStats && ptSi5351 && (uint32_t)tApi < SI5351_API_COUNT) {
+    if(ptSi5351->ptStats) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_NONE);
+      if(tApi != SI5351_API_NONE) {
+        *ptOpStats = ptSi5351->ptStats->atOp[tApi];
+      } else {
+        memset(ptOpStats, 0, sizeof(Si5351_OpStats_t));
+        for(u8Api = SI5351_API_NONE + 1; u8Api < SI5351_API_COUNT; u8Api++) {
+          ptOp = &ptSi5351->ptStats->atOp[u8Api];
+          ptOpStats->u32Calls += ptOp->u32Calls;
+          ptOpStats->u32Transfers += ptOp->u32Transfers;
+          ptOpStats->u32ReadBytes += ptOp->u32ReadBytes;
+          ptOpStats->u32WriteBytes += ptOp->u32WriteBytes;
+          ptOpStats->u64LockWait += ptOp->u64LockWait;
+          ptOpStats->u64Time += ptOp->u64Time;
+          if(ptOpStats->u32TimeMax < ptOp->u32TimeMax) {
+            ptOpStats->u32TimeMax = ptOp->u32TimeMax;
+          }
+        }
+      }
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_ResetStats(const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->ptStats) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_NONE);
+      memset(ptSi5351->ptStats->atOp, 0, sizeof(ptSi5351->ptStats->atOp));
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+#endif
+
+#if defined(SI5351_USE_TRACE)
+/* Register Access Trace */
+
+bool Si5351_InitTrace(
+  Si5351_Trace_t* ptTrace,
+  Si5351_TraceEntry_t* ptEntry,
+  const uint16_t u16Size,
+  const Si5351_Timestamp_t tTimestamp,
+  const uint32_t u32TickNs
+) {
+  bool bValid = false;
+
+  if(ptTrace && ptEntry && u16Size > 1 && !(u16Size & (u16Size - 1))) {
+    bValid = true;
+    ptTrace->ptEntry = ptEntry;
+    ptTrace->u32Mask = (uint32_t)u16Size - 1;
+    ptTrace->u32Head = 0;
+    ptTrace->bFrozen = false;
+    ptTrace->tTimestamp = tTimestamp;
+    ptTrace->u32TickNs = u32TickNs;
+  }
+
+  return bValid;
+}
+
+bool Si5351_AttachTrace(Si5351_t* ptSi5351, Si5351_Trace_t* ptTrace, const uint8_t u8Device) {
+  bool bValid = false;
+
+  /* not in the middle of a call or transaction of this instance */
+  if(ptSi5351 && u8Device < 16 && !InTransaction(ptSi5351) && !ptSi5351->u8ApiDepth) {
+    bValid = true;
+    ptSi5351->ptTrace = ptTrace;
+    ptSi5351->u8Device = u8Device;
+  }
+
+  return bValid;
+}
+
+bool Si5351_ClearTrace(Si5351_Trace_t* ptTrace) {
+  bool bValid = false;
+
+  if(ptTrace) {
+    bValid = true;
+    ptTrace->u32Head = 0;
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetTraceFreeze(Si5351_Trace_t* ptTrace, const bool bFreeze) {
+  bool bValid = false;
+
+  if(ptTrace) {
+    bValid = true;
+    ptTrace->bFrozen = bFreeze;
+  }
+
+  return bValid;
+}
+
+bool Si5351_MarkTrace(Si5351_Trace_t* ptTrace, const uint8_t u8Device, const uint8_t u8Tag) {
+  bool bValid = false;
+
+  if(ptTrace && u8Device < 16) {
+    bValid = true;
+    TraceRecord(ptTrace, (uint8_t)((u8Device << 4) | SI5351_TRACE_MARK), SI5351_API_NONE, 0x00, &u8Tag, 1);
+  }
+
+  return bValid;
+}
+
+static void PutU32(uint8_t* pu8Data, const uint32_t u32Value) {
+  pu8Data[0] = (uint8_t)u32Value;
+  pu8Data[1] = (uint8_t)(u32Value >> 8);
+  pu8Data[2] = (uint8_t)(u32Value >> 16);
+  pu8Data[3] = (uint8_t)(u32Value >> 24);
+}
+
+bool Si5351_DumpTrace(const Si5351_Trace_t* ptTrace, const Si5351_TraceOutput_t tOutput, void* pContext) {
+  bool bValid = false;
+  uint8_t au8Data[SI5351_TRACE_ENTRY_SIZE * 8];
+  const Si5351_TraceEntry_t* ptEntry;
+  uint32_t u32Head;
+  uint32_t u32Count;
+  uint32_t u32Index;
+  uint8_t u8Fill;
+
+  if(ptTrace && tOutput) {
+    bValid = true;
+    u32Head = ptTrace->u32Head;
+    u32Count = (u32Head > ptTrace->u32Mask) ? ptTrace->u32Mask + 1 : u32Head;
+    au8Data[0] = 'S';
+    au8Data[1] = '5';
+    au8Data[2] = 'T';
+    au8Data[3] = 'R';
+    au8Data[4] = SI5351_TRACE_VERSION;
+    au8Data[5] = SI5351_TRACE_ENTRY_SIZE;
+    au8Data[6] = 0;
+    au8Data[7] = 0;
+    PutU32(&au8Data[8], ptTrace->u32TickNs);
+    PutU32(&au8Data[12], u32Head - u32Count);
+    PutU32(&au8Data[16], u32Count);
+    tOutput(pContext, au8Data, SI5351_TRACE_HEADER);
+    u8Fill = 0;
+    for(u32Index = u32Head - u32Count; u32Index != u32Head; u32Index++) {
+      ptEntry = &ptTrace->ptEntry[u32Index & ptTrace->u32Mask];
+      PutU32(&au8Data[u8Fill], ptEntry->u32Time);
+      au8Data[u8Fill + 4] = ptEntry->u8Reg;
+      au8Data[u8Fill + 5] = ptEntry->u8Value;
+      au8Data[u8Fill + 6] = ptEntry->u8Api;
+      au8Data[u8Fill + 7] = ptEntry->u8Flags;
+      u8Fill += SI5351_TRACE_ENTRY_SIZE;
+      if(u8Fill == sizeof(au8Data)) {
+        tOutput(pContext, au8Data, u8Fill);
+        u8Fill = 0;
+      }
+    }
+    if(u8Fill) {
+      tOutput(pContext, au8Data, u8Fill);
+    }
+  }
+
+  return bValid;
+}
+#endif
+
+/* Transaction */
+
+bool Si5351_BeginTransaction(const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->tWrite && ptSi5351->ptCache) {
+      /* held until Si5351_Commit/Si5351_AbortTransaction */
+      Lock(ptSi5351, SI5351_API_TRANSACTION);
+      if(!InTransaction(ptSi5351)) {
+        bValid = true;
+        ptSi5351->ptCache->bTransaction = true;
+      } else {
+        Unlock(ptSi5351);
+      }
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_Commit(const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    Lock(ptSi5351, SI5351_API_NONE);
+    if(InTransaction(ptSi5351)) {
+      bValid = true;
+      CommitRange(ptSi5351, 0x00, 0x100);
+      ptSi5351->ptCache->bTransaction = false;
+      Unlock(ptSi5351);
+    }
+    Unlock(ptSi5351);
+  }
+
+  return bValid;
+}
+
+bool Si5351_AbortTransaction(const Si5351_t* ptSi5351) {
+  bool bValid = false;
+  uint8_t u8Index;
+
+  if(ptSi5351) {
+    Lock(ptSi5351, SI5351_API_NONE);
+    if(InTransaction(ptSi5351)) {
+      bValid = true;
+      /* Staged values never reached the device */
+      for(u8Index = 0; u8Index < sizeof(ptSi5351->ptCache->au8Dirty); u8Index++) {
+        ptSi5351->ptCache->au8Valid[u8Index] &= ~ptSi5351->ptCache->au8Dirty[u8Index];
+        ptSi5351->ptCache->au8Dirty[u8Index] = 0;
+      }
+      ptSi5351->ptCache->bTransaction = false;
+      Unlock(ptSi5351);
+    }
+    Unlock(ptSi5351);
+  }
+
+  return bValid;
+}
+
+/* Lock */
+bool Si5351_TryLock(const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    bValid = AcquireLock((Si5351_t*)ptSi5351, 1);
+  }
+
+  return bValid;
+}
+
+bool Si5351_LockWait(const Si5351_t* ptSi5351, const uint32_t u32Tries) {
+  bool bValid = false;
+
+  if(ptSi5351 && u32Tries > 0) {
+    bValid = AcquireLock((Si5351_t*)ptSi5351, u32Tries);
+  }
+
+  return bValid;
+}
+
+bool Si5351_Unlock(const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->u8LockDepth && IsLockOwner(ptSi5351)) {
+      bValid = true;
+      DropLock((Si5351_t*)ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+/* Register Access */
+
+bool Si5351_ReadRegisters(uint8_t* pu8Value, const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Count) {
+  bool bValid = false;
+
+  if(pu8Value && ptSi5351 && u8Count > 0 && (uint16_t)u8Reg + u8Count <= 0x100) {
+    if(ptSi5351->tRead) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_READREGISTERS);
+      ReadBlock(ptSi5351, u8Reg, pu8Value, u8Count);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_WriteRegisters(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+  bool bValid = false;
+
+  if(pu8Value && ptSi5351 && u8Count > 0 && (uint16_t)u8Reg + u8Count <= 0x100) {
+    if(ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_WRITEREGISTERS);
+      WriteBlock(ptSi5351, u8Reg, pu8Value, u8Count);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_UpdateRegister(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Mask, const uint8_t u8Value) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_UPDATEREGISTER);
+      ModifyReg(ptSi5351, u8Reg, u8Mask, u8Value);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetRegisterBits(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Bits) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETREGISTERBITS);
+      ModifyReg(ptSi5351, u8Reg, u8Bits, 0xFF);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_ClearRegisterBits(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Bits) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_CLEARREGISTERBITS);
+      ModifyReg(ptSi5351, u8Reg, u8Bits, 0x00);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_ToggleRegisterBits(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Bits) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_TOGGLEREGISTERBITS);
+      WriteReg(ptSi5351, u8Reg, ReadReg(ptSi5351, u8Reg) ^ u8Bits);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_InitDevice(const Si5351_t* ptSi5351) {
+  bool bValid = false;
+  uint8_t au8Value[8];
+
+  if(ptSi5351) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+
+      /* Disable Outputs */
+      /* Set CLKx_DIS high; Reg.3 = 0xFF */
+      Lock(ptSi5351, SI5351_API_INITDEVICE);
+      WriteReg(ptSi5351, 0x03, 0xFF);
+
+      /* Powerdown all output drivers */
+      /* Reg.16,17,18,19,20,21,22,23 = 0x80 */
+      memset(au8Value, 0x80, sizeof(au8Value));
+      WriteBlock(ptSi5351, 0x10, au8Value, 8);
+
+      /* Set interrupt masks */
+      WriteReg(ptSi5351, 0x02, 0xF0);
+      Unlock(ptSi5351);
+    }
+  }
+
+/*
+Write new configuration to device using
+the contents of the register map. This
+step also powers up the output drivers.
+(Registers 15-92 and 149-170)
+Apply PLLA and PLLB soft reset
+Reg. 177 = 0xAC
+Enable desired outputs
+*/
+
+  return bValid;
+}
+
+/* Status */
+
+bool Si5351_GetStatus(Si5351_Status_t* ptStatus, const Si5351_t* ptSi5351) {
+  bool bValid = false;
+  uint8_t u8Value;
+
+  if(ptStatus && ptSi5351) {
+    if(ptSi5351->tRead) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_GETSTATUS);
+      u8Value = ReadReg(ptSi5351, 0x00);
+      Unlock(ptSi5351);
+
+      ptStatus->bSYS_INIT = ((u8Value >> 7) & 0x1) ? true : false;
+#if SI5351_TYPE == 2
+      ptStatus->bLOL_B    = ((u8Value >> 6) & 0x1) ? true : false;
+      ptStatus->bLOL_A    = ((u8Value >> 5) & 0x1) ? true : false;
+      ptStatus->bLOS      = ((u8Value >> 4) & 0x1) ? true : false;
+#endif
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_GetStickyStatus(Si5351_Status_t* ptStatus, const Si5351_t* ptSi5351) {
+  bool bValid = false;
+  uint8_t u8Value;
+
+  if(ptStatus && ptSi5351) {
+    if(ptSi5351->tRead) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_GETSTICKYSTATUS);
+      u8Value = ReadReg(ptSi5351, 0x01);
+      Unlock(ptSi5351);
+
+      ptStatus->bSYS_INIT = ((u8Value >> 7) & 0x1) ? true : false;
+#if SI5351_TYPE == 2
+      ptStatus->bLOL_B    = ((u8Value >> 6) & 0x1) ? true : false;
+      ptStatus->bLOL_A    = ((u8Value >> 5) & 0x1) ? true : false;
+      ptStatus->bLOS      = ((u8Value >> 4) & 0x1) ? true : false;
+#endif
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetStickyStatus(const Si5351_t* ptSi5351, const Si5351_Status_t* ptStatus) {
+  bool bValid = false;
+
+  if(ptSi5351 && ptStatus) {
+    if(ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETSTICKYSTATUS);
+      WriteReg(
+        ptSi5351, 0x01,
+#if SI5351_TYPE != 2
+        (uint8_t)(ptStatus->bSYS_INIT ? 1 : 0) << 7
+#else
+        (uint8_t)(ptStatus->bSYS_INIT ? 1 : 0) << 7 |
+        (uint8_t)(ptStatus->bLOL_B    ? 1 : 0) << 6 |
+        (uint8_t)(ptStatus->bLOL_A    ? 1 : 0) << 5 |
+        (uint8_t)(ptStatus->bLOS      ? 1 : 0) << 4
+#endif
+      );
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_GetStatusMask(Si5351_Status_t* ptStatus, const Si5351_t* ptSi5351) {
+  bool bValid = false;
+  uint8_t u8Value;
+
+  if(ptStatus && ptSi5351) {
+    if(ptSi5351->tRead) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_GETSTATUSMASK);
+      u8Value = ReadReg(ptSi5351, 0x02);
+      Unlock(ptSi5351);
+
+      ptStatus->bSYS_INIT = ((u8Value >> 7) & 0x1) ? true : false;
+#if SI5351_TYPE == 2
+      ptStatus->bLOL_B    = ((u8Value >> 6) & 0x1) ? true : false;
+      ptStatus->bLOL_A    = ((u8Value >> 5) & 0x1) ? true : false;
+      ptStatus->bLOS      = ((u8Value >> 4) & 0x1) ? true : false;
+#endif
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetStatusMask(const Si5351_t* ptSi5351, const Si5351_Status_t* ptStatus) {
+  bool bValid = false;
+
+  if(ptSi5351 && ptStatus) {
+    if(ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETSTATUSMASK);
+      WriteReg(
+        ptSi5351, 0x02,
+#if SI5351_TYPE != 2
+        (uint8_t)(ptStatus->bSYS_INIT ? 1 : 0) << 7
+#else
+        (uint8_t)(ptStatus->bSYS_INIT ? 1 : 0) << 7 |
+        (uint8_t)(ptStatus->bLOL_B    ? 1 : 0) << 6 |
+        (uint8_t)(ptStatus->bLOL_A    ? 1 : 0) << 5 |
+        (uint8_t)(ptStatus->bLOS      ? 1 : 0) << 4
+#endif
+      );
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+/* Control */
+
+/* Reg.3 Output Enable Control */
+bool Si5351_GetOutputEnable(uint8_t* pu8Disable, const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(pu8Disable && ptSi5351) {
+    if(ptSi5351->tRead) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_GETOUTPUTENABLE);
+      *pu8Disable = ReadReg(ptSi5351, 0x03);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetOutputEnable(const Si5351_t* ptSi5351, const uint8_t u8Enable) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETOUTPUTENABLE);
+#if SI5351_CLKNUM <= 3
+      ModifyReg(ptSi5351, 0x03, u8Enable & 0x7, 0x00);
+#else
+      ModifyReg(ptSi5351, 0x03, u8Enable, 0x00);
+#endif
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetOutputDisable(const Si5351_t* ptSi5351, const uint8_t u8Disable) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETOUTPUTDISABLE);
+#if SI5351_CLKNUM <= 3
+      ModifyReg(ptSi5351, 0x03, u8Disable & 0x7, 0xFF);
+#else
+      ModifyReg(ptSi5351, 0x03, u8Disable, 0xFF);
+#endif
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+/* Reg.9 OEB Pin Enable Control Mask */
+bool Si5351_GetOutputControlMask(uint8_t* pu8ControlMask, const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(pu8ControlMask && ptSi5351) {
+    if(ptSi5351->tRead) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_GETOUTPUTCONTROLMASK);
+#if SI5351_CLKNUM <= 3
+      *pu8ControlMask = (ReadReg(ptSi5351, 0x09) & 0x7);
+#else
+      *pu8ControlMask =  ReadReg(ptSi5351, 0x09);
+#endif
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetOutputControlMask(const Si5351_t* ptSi5351, const uint8_t u8ControlMask) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETOUTPUTCONTROLMASK);
+#if SI5351_CLKNUM <= 3
+      WriteReg(ptSi5351, 0x09, (u8ControlMask & 0x7));
+#else
+      WriteReg(ptSi5351, 0x09,  u8ControlMask);
+#endif
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+/* Reg.15 PLL Input Source */
+
+#if SI5351_TYPE == 2
 /* CLKIN_DIV : CLKIN Input Divider */
 bool Si5351_GetCLKIN_DIV(Si5351_CLKIN_DIV_t* ptCLKIN_DIV, const Si5351_t* ptSi5351) {
   bool bValid = false;
@@ -479,8 +1739,8 @@ bool Si5351_GetCLKIN_DIV(Si5351_CLKIN_DIV_t* ptCLKIN_DIV, const Si5351_t* ptSi53
   if(ptCLKIN_DIV && ptSi5351) {
     if(ptSi5351->tRead) {
       bValid = true;
-      Lock(ptSi5351);
-      *ptCLKIN_DIV = ((ptSi5351->tRead(ptSi5351->pInstance, 0x0F) >> 6) & 0x3);
+      Lock(ptSi5351, SI5351_API_GETCLKIN_DIV);
+      *ptCLKIN_DIV = ((ReadReg(ptSi5351, 0x0F) >> 6) & 0x3);
       Unlock(ptSi5351);
     }
   }
@@ -494,11 +1754,8 @@ bool Si5351_SetCLKIN_DIV(const Si5351_t* ptSi5351, const Si5351_CLKIN_DIV_t tCLK
   if(ptSi5351) {
     if(ptSi5351->tRead && ptSi5351->tWrite) {
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x0F,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0x0F) & ~(0x3 << 6)) | (((uint8_t)tCLKIN_DIV & 0x3) << 6)
-      );
+      Lock(ptSi5351, SI5351_API_SETCLKIN_DIV);
+      ModifyReg(ptSi5351, 0x0F, 0x3 << 6, ((uint8_t)tCLKIN_DIV & 0x3) << 6);
       Unlock(ptSi5351);
     }
   }
@@ -514,8 +1771,8 @@ bool Si5351_GetPLLA_SRC(Si5351_PLL_SRC_t* ptSrc, const Si5351_t* ptSi5351) {
   if(ptSrc && ptSi5351) {
     if(ptSi5351->tRead) {
       bValid = true;
-      Lock(ptSi5351);
-      *ptSrc = (Si5351_PLL_SRC_t)((ptSi5351->tRead(ptSi5351->pInstance, 0x0F) >> 2) & 0x1);
+      Lock(ptSi5351, SI5351_API_GETPLLA_SRC);
+      *ptSrc = (Si5351_PLL_SRC_t)((ReadReg(ptSi5351, 0x0F) >> 2) & 0x1);
       Unlock(ptSi5351);
     }
   }
@@ -529,11 +1786,8 @@ bool Si5351_SetPLLA_SRC(const Si5351_t* ptSi5351, const Si5351_PLL_SRC_t tSrc) {
   if(ptSi5351) {
     if(ptSi5351->tRead && ptSi5351->tWrite) {
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x0F,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0x0F) & ~(0x1 << 2)) | (((uint8_t)tSrc & 0x1) << 2)
-      );
+      Lock(ptSi5351, SI5351_API_SETPLLA_SRC);
+      ModifyReg(ptSi5351, 0x0F, 0x1 << 2, ((uint8_t)tSrc & 0x1) << 2);
       Unlock(ptSi5351);
     }
   }
@@ -547,8 +1801,8 @@ bool Si5351_GetPLLB_SRC(Si5351_PLL_SRC_t* ptSrc, const Si5351_t* ptSi5351) {
   if(ptSrc && ptSi5351) {
     if(ptSi5351->tRead) {
       bValid = true;
-      Lock(ptSi5351);
-      *ptSrc = (Si5351_PLL_SRC_t)((ptSi5351->tRead(ptSi5351->pInstance, 0x0F) >> 3) & 0x1);
+      Lock(ptSi5351, SI5351_API_GETPLLB_SRC);
+      *ptSrc = (Si5351_PLL_SRC_t)((ReadReg(ptSi5351, 0x0F) >> 3) & 0x1);
       Unlock(ptSi5351);
     }
   }
@@ -562,11 +1816,8 @@ bool Si5351_SetPLLB_SRC(const Si5351_t* ptSi5351, const Si5351_PLL_SRC_t tSrc) {
   if(ptSi5351) {
     if(ptSi5351->tRead && ptSi5351->tWrite) {
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x0F,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0x0F) & ~(0x1 << 3)) | (((uint8_t)tSrc & 0x1) << 3)
-      );
+      Lock(ptSi5351, SI5351_API_SETPLLB_SRC);
+      ModifyReg(ptSi5351, 0x0F, 0x1 << 3, ((uint8_t)tSrc & 0x1) << 3);
       Unlock(ptSi5351);
     }
   }
@@ -587,8 +1838,8 @@ bool Si5351_GetClkPowerDown(bool* pbPowerDown, const Si5351_t* ptSi5351, const S
     if(ptSi5351->tRead && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      *pbPowerDown = ((ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) >> 7) & 0x1) ? true : false;
+      Lock(ptSi5351, SI5351_API_GETCLKPOWERDOWN);
+      *pbPowerDown = ((ReadReg(ptSi5351, 0x10 + tCLKNo) >> 7) & 0x1) ? true : false;
       Unlock(ptSi5351);
     }
   }
@@ -606,11 +1857,8 @@ bool Si5351_SetClkPowerDown(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKN
     if(ptSi5351->tRead && ptSi5351->tWrite && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x10 + tCLKNo,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) & ~(0x1 << 7)) | ((uint8_t)(bPowerDown ? 1 : 0) << 7)
-      );
+      Lock(ptSi5351, SI5351_API_SETCLKPOWERDOWN);
+      ModifyReg(ptSi5351, 0x10 + tCLKNo, 0x1 << 7, (uint8_t)(bPowerDown ? 1 : 0) << 7);
       Unlock(ptSi5351);
     }
   }
@@ -629,8 +1877,8 @@ bool Si5351_GetClkMSSource(Si5351_CLK_MS_SRC_t* ptSrc, const Si5351_t* ptSi5351,
     if(ptSi5351->tRead && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      *ptSrc = (Si5351_CLK_MS_SRC_t)((ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) >> 5) & 0x1);
+      Lock(ptSi5351, SI5351_API_GETCLKMSSOURCE);
+      *ptSrc = (Si5351_CLK_MS_SRC_t)((ReadReg(ptSi5351, 0x10 + tCLKNo) >> 5) & 0x1);
       Unlock(ptSi5351);
     }
   }
@@ -648,11 +1896,8 @@ bool Si5351_SetClkMSSource(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo
     if(ptSi5351->tRead && ptSi5351->tWrite && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x10 + tCLKNo,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) & ~(0x1 << 5)) | (((uint8_t)tSrc & 0x1) << 5)
-      );
+      Lock(ptSi5351, SI5351_API_SETCLKMSSOURCE);
+      ModifyReg(ptSi5351, 0x10 + tCLKNo, 0x1 << 5, ((uint8_t)tSrc & 0x1) << 5);
       Unlock(ptSi5351);
     }
   }
@@ -671,8 +1916,8 @@ bool Si5351_GetClkInvert(bool* pbInvert, const Si5351_t* ptSi5351, const Si5351_
     if(ptSi5351->tRead && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      *pbInvert = ((ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) >> 4) & 0x1) ? true : false;
+      Lock(ptSi5351, SI5351_API_GETCLKINVERT);
+      *pbInvert = ((ReadReg(ptSi5351, 0x10 + tCLKNo) >> 4) & 0x1) ? true : false;
       Unlock(ptSi5351);
     }
   }
@@ -690,11 +1935,8 @@ bool Si5351_SetClkInvert(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo,
     if(ptSi5351->tRead && ptSi5351->tWrite && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x10 + tCLKNo,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) & ~(0x1 << 4)) | ((uint8_t)(bInvert ? 1 : 0) << 4)
-      );
+      Lock(ptSi5351, SI5351_API_SETCLKINVERT);
+      ModifyReg(ptSi5351, 0x10 + tCLKNo, 0x1 << 4, (uint8_t)(bInvert ? 1 : 0) << 4);
       Unlock(ptSi5351);
     }
   }
@@ -713,8 +1955,8 @@ bool Si5351_GetClkSrc(Si5351_CLK_SRC_t* ptSrc, const Si5351_t* ptSi5351, const S
     if(ptSi5351->tRead && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      *ptSrc = (Si5351_CLK_SRC_t)((ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) >> 2) & 0x3);
+      Lock(ptSi5351, SI5351_API_GETCLKSRC);
+      *ptSrc = (Si5351_CLK_SRC_t)((ReadReg(ptSi5351, 0x10 + tCLKNo) >> 2) & 0x3);
       Unlock(ptSi5351);
     }
   }
@@ -732,11 +1974,8 @@ bool Si5351_SetClkSrc(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, con
     if(ptSi5351->tRead && ptSi5351->tWrite && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x10 + tCLKNo,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) & ~(0x3 << 2)) | (((uint8_t)tSrc & 0x3) << 2)
-      );
+      Lock(ptSi5351, SI5351_API_SETCLKSRC);
+      ModifyReg(ptSi5351, 0x10 + tCLKNo, 0x3 << 2, ((uint8_t)tSrc & 0x3) << 2);
       Unlock(ptSi5351);
     }
   }
@@ -755,8 +1994,8 @@ bool Si5351_GetClkIDrive(Si5351_CLK_IDRV_t* ptIDrv, const Si5351_t* ptSi5351, co
     if(ptSi5351->tRead && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      *ptIDrv = (Si5351_CLK_IDRV_t)(ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) & 0x3);
+      Lock(ptSi5351, SI5351_API_GETCLKIDRIVE);
+      *ptIDrv = (Si5351_CLK_IDRV_t)(ReadReg(ptSi5351, 0x10 + tCLKNo) & 0x3);
       Unlock(ptSi5351);
     }
   }
@@ -774,11 +2013,8 @@ bool Si5351_SetClkIDrive(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo,
     if(ptSi5351->tRead && ptSi5351->tWrite && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x10 + tCLKNo,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) & ~0x3) | (tIDrv & 0x3)
-      );
+      Lock(ptSi5351, SI5351_API_SETCLKIDRIVE);
+      ModifyReg(ptSi5351, 0x10 + tCLKNo, 0x3, tIDrv & 0x3);
       Unlock(ptSi5351);
     }
   }
@@ -798,8 +2034,8 @@ bool Si5351_GetClkDisableState(Si5351_CLK_DIS_STATE_t* ptDisState, const Si5351_
     if(ptSi5351->tRead && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      *ptDisState = (Si5351_CLK_DIS_STATE_t)((ptSi5351->tRead(ptSi5351->pInstance, 0x18 + tCLKNo / 4) >> (2 * (tCLKNo % 4))) & 0x3);
+      Lock(ptSi5351, SI5351_API_GETCLKDISABLESTATE);
+      *ptDisState = (Si5351_CLK_DIS_STATE_t)((ReadReg(ptSi5351, 0x18 + tCLKNo / 4) >> (2 * (tCLKNo % 4))) & 0x3);
       Unlock(ptSi5351);
     }
   }
@@ -817,11 +2053,8 @@ bool Si5351_SetClkDisableState(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tC
     if(ptSi5351->tRead && ptSi5351->tWrite && tCLKNo < 8) {
 #endif
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x18 + tCLKNo / 4,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0x18 + tCLKNo / 4) & ~(0x3 << (2 * (tCLKNo % 4)))) | (((uint8_t)tDisState & 0x3) << (2 * (tDisState % 4)))
-      );
+      Lock(ptSi5351, SI5351_API_SETCLKDISABLESTATE);
+      ModifyReg(ptSi5351, 0x18 + tCLKNo / 4, 0x3 << (2 * (tCLKNo % 4)), ((uint8_t)tDisState & 0x3) << (2 * (tCLKNo % 4)));
       Unlock(ptSi5351);
     }
   }
@@ -861,17 +2094,14 @@ bool Si5351_SetClkDisableState(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tC
 /* Reg.22,26-33 Multisynth NA Parameters */
 bool Si5351_GetMSA(Si5351_MS_t* ptMS, const Si5351_t* ptSi5351) {
   bool bValid = false;
-  uint8_t u8Reg;
   uint8_t u8Value[8];
 
   if(ptMS && ptSi5351) {
     if(ptSi5351->tRead) {
       bValid = true;
-      Lock(ptSi5351);
-      ptMS->bInteger = ((ptSi5351->tRead(ptSi5351->pInstance, 0x16) >> 6) & 0x1) ? true : false;
-      for(u8Reg = 0; u8Reg < 8; u8Reg++) {
-        u8Value[u8Reg] = ptSi5351->tRead(ptSi5351->pInstance, 0x1A + u8Reg);
-      }
+      Lock(ptSi5351, SI5351_API_GETMSA);
+      ptMS->bInteger = ((ReadReg(ptSi5351, 0x16) >> 6) & 0x1) ? true : false;
+      ReadBlock(ptSi5351, 0x1A, u8Value, 8);
       Unlock(ptSi5351);
       ptMS->u32MSX_P1 = ((uint32_t)(u8Value[2] & 0x03) << 16) | ((uint32_t)u8Value[3] << 8) | u8Value[4];
       ptMS->u32MSX_P2 = ((uint32_t)(u8Value[5] & 0x0F) << 16) | ((uint32_t)u8Value[6] << 8) | u8Value[7];
@@ -886,25 +2116,16 @@ bool Si5351_GetMSA(Si5351_MS_t* ptMS, const Si5351_t* ptSi5351) {
 
 bool Si5351_SetMSA(const Si5351_t* ptSi5351, const Si5351_MS_t* ptMS) {
   bool bValid = false;
-  uint8_t u8Value;
+  uint8_t au8Value[8];
 
   if(ptSi5351 && ptMS) {
     if(ptSi5351->tRead && ptSi5351->tWrite) {
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x16,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0x16) & ~(0x1 << 6)) | ((uint8_t)(ptMS->bInteger ? 1 : 0) << 6)
-      );
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x1A, ((ptMS->u32MSX_P3 >>  8) & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x1B, ( ptMS->u32MSX_P3        & 0xFF));
-      u8Value = ptSi5351->tRead(ptSi5351->pInstance, 0x1C);
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x1C, (u8Value & ~0x3) | ((ptMS->u32MSX_P1 >> 16) & 0x3));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x1D, ((ptMS->u32MSX_P1 >>  8) & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x1E, ( ptMS->u32MSX_P1        & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x1F, ((ptMS->u32MSX_P3 >> 12) & 0xF0) | ((ptMS->u32MSX_P2 >> 16) & 0xF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x20, ((ptMS->u32MSX_P2 >>  8) & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x21, ( ptMS->u32MSX_P2        & 0xFF));
+      Lock(ptSi5351, SI5351_API_SETMSA);
+      ModifyReg(ptSi5351, 0x16, 0x1 << 6, (uint8_t)(ptMS->bInteger ? 1 : 0) << 6);
+      EncodeMS(au8Value, ptMS);
+      au8Value[2] |= ReadReg(ptSi5351, 0x1C) & ~0x3;
+      WriteBlock(ptSi5351, 0x1A, au8Value, 8);
       Unlock(ptSi5351);
     }
   }
@@ -915,17 +2136,14 @@ bool Si5351_SetMSA(const Si5351_t* ptSi5351, const Si5351_MS_t* ptMS) {
 /* Reg.23,34-41 Multisynth NB Parameters */
 bool Si5351_GetMSB(Si5351_MS_t* ptMS, const Si5351_t* ptSi5351) {
   bool bValid = false;
-  uint8_t u8Reg;
   uint8_t u8Value[8];
 
   if(ptMS && ptSi5351) {
     if(ptSi5351->tRead) {
       bValid = true;
-      Lock(ptSi5351);
-      ptMS->bInteger = ((ptSi5351->tRead(ptSi5351->pInstance, 0x17) >> 6) & 0x1) ? true : false;
-      for(u8Reg = 0; u8Reg < 8; u8Reg++) {
-        u8Value[u8Reg] = ptSi5351->tRead(ptSi5351->pInstance, 0x22 + u8Reg);
-      }
+      Lock(ptSi5351, SI5351_API_GETMSB);
+      ptMS->bInteger = ((ReadReg(ptSi5351, 0x17) >> 6) & 0x1) ? true : false;
+      ReadBlock(ptSi5351, 0x22, u8Value, 8);
       Unlock(ptSi5351);
       ptMS->u32MSX_P1 = ((uint32_t)(u8Value[2] & 0x03) << 16) | ((uint32_t)u8Value[3] << 8) | u8Value[4];
       ptMS->u32MSX_P2 = ((uint32_t)(u8Value[5] & 0x0F) << 16) | ((uint32_t)u8Value[6] << 8) | u8Value[7];
@@ -940,25 +2158,16 @@ bool Si5351_GetMSB(Si5351_MS_t* ptMS, const Si5351_t* ptSi5351) {
 
 bool Si5351_SetMSB(const Si5351_t* ptSi5351, const Si5351_MS_t* ptMS) {
   bool bValid = false;
-  uint8_t u8Value;
+  uint8_t au8Value[8];
 
   if(ptSi5351 && ptMS) {
     if(ptSi5351->tRead && ptSi5351->tWrite) {
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x17,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0x17) & ~(0x1 << 6)) | ((uint8_t)(ptMS->bInteger ? 1 : 0) << 6)
-      );
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x22, ((ptMS->u32MSX_P3 >>  8) & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x23, ( ptMS->u32MSX_P3        & 0xFF));
-      u8Value = ptSi5351->tRead(ptSi5351->pInstance, 0x24);
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x24, (u8Value & ~0x3) | ((ptMS->u32MSX_P1 >> 16) & 0x3));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x25, ((ptMS->u32MSX_P1 >>  8) & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x26, ( ptMS->u32MSX_P1        & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x27, ((ptMS->u32MSX_P3 >> 12) & 0xF0) | ((ptMS->u32MSX_P2 >> 16) & 0xF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x28, ((ptMS->u32MSX_P2 >>  8) & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x29, ( ptMS->u32MSX_P2        & 0xFF));
+      Lock(ptSi5351, SI5351_API_SETMSB);
+      ModifyReg(ptSi5351, 0x17, 0x1 << 6, (uint8_t)(ptMS->bInteger ? 1 : 0) << 6);
+      EncodeMS(au8Value, ptMS);
+      au8Value[2] |= ReadReg(ptSi5351, 0x24) & ~0x3;
+      WriteBlock(ptSi5351, 0x22, au8Value, 8);
       Unlock(ptSi5351);
     }
   }
@@ -969,25 +2178,18 @@ bool Si5351_SetMSB(const Si5351_t* ptSi5351, const Si5351_MS_t* ptMS) {
 /* Reg.16-21,42-92 Multisynthx Parameters */
 bool Si5351_GetMS(Si5351_MS_t* ptMS, const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo) {
   bool bValid = false;
-  uint8_t u8Reg;
   uint8_t u8Value[8];
 
 #if SI5351_CLKNUM <= 3
   if(ptMS && ptSi5351 && tCLKNo < 3) {
 #else
-  if(ptMS && ptSi5351 && tCLKNo < 8) {
+  if(ptMS && ptSi5351 && tCLKNo < 6) {
 #endif
     if(ptSi5351->tRead) {
       bValid = true;
-      Lock(ptSi5351);
-      if(tCLKNo < 6) {
-        ptMS->bInteger = ((ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) >> 6) & 0x1) ? true : false;
-      } else {
-        ptMS->bInteger = true;
-      }
-      for(u8Reg = 0; u8Reg < 8; u8Reg++) {
-        u8Value[u8Reg] = ptSi5351->tRead(ptSi5351->pInstance, 0x2A + 8 * tCLKNo + u8Reg);
-      }
+      Lock(ptSi5351, SI5351_API_GETMS);
+      ptMS->bInteger = ((ReadReg(ptSi5351, 0x10 + tCLKNo) >> 6) & 0x1) ? true : false;
+      ReadBlock(ptSi5351, 0x2A + 8 * tCLKNo, u8Value, 8);
       Unlock(ptSi5351);
       ptMS->u32MSX_P1 = ((uint32_t)(u8Value[2] & 0x03) << 16) | ((uint32_t)u8Value[3] << 8) | u8Value[4];
       ptMS->u32MSX_P2 = ((uint32_t)(u8Value[5] & 0x0F) << 16) | ((uint32_t)u8Value[6] << 8) | u8Value[7];
@@ -995,6 +2197,18 @@ bool Si5351_GetMS(Si5351_MS_t* ptMS, const Si5351_t* ptSi5351, const Si5351_CLKN
       ptMS->tDIV = (Si5351_MS_DIV_t)((u8Value[2] >> 4) & 0x7);
       ptMS->bDivBy4 = (((u8Value[2] >> 2) & 0x3) == 0x3) ? true : false;
     }
+#if SI5351_CLKNUM > 3
+  } else if(ptMS && tCLKNo < 8) {
+    /* MS6/MS7 as integer a (P2 = 0, P3 = 1) */
+    if(Si5351_GetMS67(&u8Value[0], &ptMS->tDIV, ptSi5351, tCLKNo) && u8Value[0] >= 4) {
+      bValid = true;
+      ptMS->bInteger = true;
+      ptMS->u32MSX_P1 = ((uint32_t)u8Value[0] << 7) - 512;
+      ptMS->u32MSX_P2 = 0;
+      ptMS->u32MSX_P3 = 1;
+      ptMS->bDivBy4 = false;
+    }
+#endif
   }
 
   return bValid;
@@ -1002,36 +2216,175 @@ bool Si5351_GetMS(Si5351_MS_t* ptMS, const Si5351_t* ptSi5351, const Si5351_CLKN
 
 bool Si5351_SetMS(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS) {
   bool bValid = false;
-  uint8_t u8Value;
+  uint8_t au8Value[8];
 
 #if SI5351_CLKNUM <= 3
   if(ptSi5351 && ptMS && tCLKNo < 3) {
 #else
-  if(ptSi5351 && ptMS && tCLKNo < 8) {
+  if(ptSi5351 && ptMS && tCLKNo < 6) {
 #endif
     if(ptSi5351->tRead && ptSi5351->tWrite) {
       bValid = true;
-      Lock(ptSi5351);
-      if(tCLKNo < 6) {
-        ptSi5351->tWrite(
-          ptSi5351->pInstance, 0x10,
-          (ptSi5351->tRead(ptSi5351->pInstance, 0x10 + tCLKNo) & ~(0x1 << 6)) | ((uint8_t)(ptMS->bInteger ? 1 : 0) << 6)
-        );
-      }
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x2A + 8 * tCLKNo, ((ptMS->u32MSX_P3 >>  8) & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x2B + 8 * tCLKNo, ( ptMS->u32MSX_P3        & 0xFF));
-      u8Value = ptSi5351->tRead(ptSi5351->pInstance, 0x2C + 8 * tCLKNo);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x2C + 8 * tCLKNo,
-        (u8Value & ~0x7F) | ((ptMS->tDIV & 0x7) << 4) | ((ptMS->bDivBy4 ? 3 : 0) << 2) | ((ptMS->u32MSX_P1 >> 16) & 0x3)
-      );
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x2D + 8 * tCLKNo, ((ptMS->u32MSX_P1 >>  8) & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x2E + 8 * tCLKNo, ( ptMS->u32MSX_P1        & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x2F + 8 * tCLKNo, ((ptMS->u32MSX_P3 >> 12) & 0xF0) | ((ptMS->u32MSX_P2 >> 16) & 0xF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x30 + 8 * tCLKNo, ((ptMS->u32MSX_P2 >>  8) & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x31 + 8 * tCLKNo, ( ptMS->u32MSX_P2        & 0xFF));
+      Lock(ptSi5351, SI5351_API_SETMS);
+      ModifyReg(ptSi5351, 0x10 + tCLKNo, 0x1 << 6, (uint8_t)(ptMS->bInteger ? 1 : 0) << 6);
+      EncodeMS(au8Value, ptMS);
+      au8Value[2] |= (ReadReg(ptSi5351, 0x2C + 8 * tCLKNo) & ~0x7F) | ((ptMS->tDIV & 0x7) << 4) | ((ptMS->bDivBy4 ? 3 : 0) << 2);
+      WriteBlock(ptSi5351, 0x2A + 8 * tCLKNo, au8Value, 8);
+      Unlock(ptSi5351);
+    }
+#if SI5351_CLKNUM > 3
+  } else if(ptMS && tCLKNo < 8) {
+    if(MS67Divider(&au8Value[0], ptMS)) {
+      bValid = Si5351_SetMS67(ptSi5351, tCLKNo, au8Value[0], ptMS->tDIV);
+    }
+#endif
+  }
+
+  return bValid;
+}
+
+#if SI5351_CLKNUM > 3
+/* Reg.90,91 MS6_P1/MS7_P1 (integer divider), Reg.92 R6_DIV[2:0] / R7_DIV[6:4] */
+bool Si5351_GetMS67(uint8_t* pu8MS, Si5351_MS_DIV_t* ptDIV, const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo) {
+  bool bValid = false;
+  uint8_t u8Value;
+
+  if(pu8MS && ptDIV && ptSi5351 && (tCLKNo == SI5351_CLK6 || tCLKNo == SI5351_CLK7)) {
+    if(ptSi5351->tRead) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_GETMS67);
+      *pu8MS = ReadReg(ptSi5351, 90 + tCLKNo - SI5351_CLK6);
+      u8Value = ReadReg(ptSi5351, 92);
+      Unlock(ptSi5351);
+      *ptDIV = (Si5351_MS_DIV_t)((u8Value >> (4 * (tCLKNo - SI5351_CLK6))) & 0x7);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetMS67(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, const uint8_t u8MS, const Si5351_MS_DIV_t tDIV) {
+  bool bValid = false;
+  uint8_t u8Shift;
+
+  if(ptSi5351 && (tCLKNo == SI5351_CLK6 || tCLKNo == SI5351_CLK7) && IsMS67Divider(u8MS)) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      u8Shift = 4 * (tCLKNo - SI5351_CLK6);
+      Lock(ptSi5351, SI5351_API_SETMS67);
+      WriteReg(ptSi5351, 90 + tCLKNo - SI5351_CLK6, u8MS);
+      ModifyReg(ptSi5351, 92, 0x7 << u8Shift, (tDIV & 0x7) << u8Shift);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+/* Divider only, one register write (no read) */
+bool Si5351_SetMS67Divider(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, const uint8_t u8MS) {
+  bool bValid = false;
+
+  if(ptSi5351 && (tCLKNo == SI5351_CLK6 || tCLKNo == SI5351_CLK7) && IsMS67Divider(u8MS)) {
+    if(ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETMS67DIVIDER);
+      WriteReg(ptSi5351, 90 + tCLKNo - SI5351_CLK6, u8MS);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+#endif
+
+/* Frequency hop */
+/*
+  Same as Si5351_SetMSA/SetMSB/SetMS but ptLastMS is the setting programmed
+  before, and only the registers that changed between the two are written
+  (as one block). A small frequency step usually touches only P2[7:0].
+*/
+bool Si5351_RetuneMSA(const Si5351_t* ptSi5351, const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS) {
+  bool bValid = false;
+  uint8_t au8Value[8];
+  uint8_t au8Last[8];
+
+  if(ptSi5351 && ptMS && ptLastMS) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_RETUNEMSA);
+      if(ptMS->bInteger != ptLastMS->bInteger) {
+        ModifyReg(ptSi5351, 0x16, 0x1 << 6, (uint8_t)(ptMS->bInteger ? 1 : 0) << 6);
+      }
+      EncodeMS(au8Value, ptMS);
+      EncodeMS(au8Last, ptLastMS);
+      RetuneBlock(ptSi5351, 0x1A, au8Value, au8Last, ~0x3);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_RetuneMSB(const Si5351_t* ptSi5351, const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS) {
+  bool bValid = false;
+  uint8_t au8Value[8];
+  uint8_t au8Last[8];
+
+  if(ptSi5351 && ptMS && ptLastMS) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_RETUNEMSB);
+      if(ptMS->bInteger != ptLastMS->bInteger) {
+        ModifyReg(ptSi5351, 0x17, 0x1 << 6, (uint8_t)(ptMS->bInteger ? 1 : 0) << 6);
+      }
+      EncodeMS(au8Value, ptMS);
+      EncodeMS(au8Last, ptLastMS);
+      RetuneBlock(ptSi5351, 0x22, au8Value, au8Last, ~0x3);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+/* Output MS: only the changed registers of MS0-5, MS6/MS7 through their 8-bit divider */
+bool Si5351_RetuneMS(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS) {
+  bool bValid = false;
+  uint8_t au8Value[8];
+  uint8_t au8Last[8];
+
+#if SI5351_CLKNUM <= 3
+  if(ptSi5351 && ptMS && ptLastMS && tCLKNo < 3) {
+#else
+  if(ptSi5351 && ptMS && ptLastMS && tCLKNo < 6) {
+#endif
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_RETUNEMS);
+      if(ptMS->bInteger != ptLastMS->bInteger) {
+        ModifyReg(ptSi5351, 0x10 + tCLKNo, 0x1 << 6, (uint8_t)(ptMS->bInteger ? 1 : 0) << 6);
+      }
+      EncodeMS(au8Value, ptMS);
+      au8Value[2] |= ((ptMS->tDIV & 0x7) << 4) | ((ptMS->bDivBy4 ? 3 : 0) << 2);
+      EncodeMS(au8Last, ptLastMS);
+      au8Last[2] |= ((ptLastMS->tDIV & 0x7) << 4) | ((ptLastMS->bDivBy4 ? 3 : 0) << 2);
+      RetuneBlock(ptSi5351, 0x2A + 8 * tCLKNo, au8Value, au8Last, ~0x7F);
       Unlock(ptSi5351);
     }
+#if SI5351_CLKNUM > 3
+  } else if(ptMS && ptLastMS && tCLKNo < 8) {
+    /* MS6/MS7: one register write when only the divider changed */
+    if(MS67Divider(&au8Value[0], ptMS) && MS67Divider(&au8Last[0], ptLastMS)) {
+      if(ptMS->tDIV != ptLastMS->tDIV) {
+        bValid = Si5351_SetMS67(ptSi5351, tCLKNo, au8Value[0], ptMS->tDIV);
+      } else if(au8Value[0] != au8Last[0]) {
+        bValid = Si5351_SetMS67Divider(ptSi5351, tCLKNo, au8Value[0]);
+      } else {
+        bValid = (ptSi5351 && ptSi5351->tWrite) ? true : false;
+      }
+    }
+#endif
   }
 
   return bValid;
@@ -1059,12 +2412,12 @@ bool Si5351_SetMS(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, const S
 
 bool Si5351_GetSSPEnable(bool* pbEnable, const Si5351_t* ptSi5351) {
   bool bValid = false;
-  uint8_t u8Value;
 
   if(pbEnable && ptSi5351) {
     if(ptSi5351->tRead) {
-      Lock(ptSi5351);
-      *pbEnable = (ptSi5351->tRead(ptSi5351->pInstance, 0x95) & 0x80) ? true : false;
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_GETSSPENABLE);
+      *pbEnable = (ReadReg(ptSi5351, 0x95) & 0x80) ? true : false;
       Unlock(ptSi5351);
     }
   }
@@ -1077,11 +2430,9 @@ bool Si5351_SetSSPEnable(const Si5351_t* ptSi5351) {
 
   if(ptSi5351) {
     if(ptSi5351->tRead && ptSi5351->tWrite) {
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x95,
-        ptSi5351->tRead(ptSi5351->pInstance, 0x95) | 0x80
-      );
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETSSPENABLE);
+      ModifyReg(ptSi5351, 0x95, 0x80, 0x80);
       Unlock(ptSi5351);
     }
   }
@@ -1094,11 +2445,9 @@ bool Si5351_SetSSPDisable(const Si5351_t* ptSi5351) {
 
   if(ptSi5351) {
     if(ptSi5351->tRead && ptSi5351->tWrite) {
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x95,
-        ptSi5351->tRead(ptSi5351->pInstance, 0x95) & ~0x80
-      );
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETSSPDISABLE);
+      ModifyReg(ptSi5351, 0x95, 0x80, 0x00);
       Unlock(ptSi5351);
     }
   }
@@ -1108,16 +2457,13 @@ bool Si5351_SetSSPDisable(const Si5351_t* ptSi5351) {
 
 bool Si5351_GetSSP(Si5351_SSP_t* ptSSP, const Si5351_t* ptSi5351) {
   bool bValid = false;
-  uint8_t u8Reg;
   uint8_t au8Value[13];
 
   if(ptSSP && ptSi5351) {
     if(ptSi5351->tRead) {
       bValid = true;
-      Lock(ptSi5351);
-      for(u8Reg = 0; u8Reg < 13; u8Reg++) {
-        au8Value[u8Reg] = ptSi5351->tRead(ptSi5351->pInstance, 0x95 + u8Reg);
-      }
+      Lock(ptSi5351, SI5351_API_GETSSP);
+      ReadBlock(ptSi5351, 0x95, au8Value, 13);
       Unlock(ptSi5351);
 
       ptSSP->tSSC_MODE = (Si5351_SSP_Mode_t)((au8Value[2] >> 7) & 0x1);
@@ -1136,29 +2482,155 @@ bool Si5351_GetSSP(Si5351_SSP_t* ptSSP, const Si5351_t* ptSi5351) {
 
 bool Si5351_SetSSP(const Si5351_t* ptSi5351, const Si5351_SSP_t* ptSSP) {
   bool bValid = false;
+  uint8_t au8Value[12];
 
   if(ptSi5351 && ptSSP) {
     if(ptSi5351->tWrite) {
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x96, (uint8_t)(ptSSP->u16SSDN_P2 & 0xFF));
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x97,
-        (uint8_t)(((ptSSP->tSSC_MODE & 0x1) << 7) | ((ptSSP->u16SSDN_P3 >> 8) & 0x7F))
-      );
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x98, (uint8_t)(ptSSP->u16SSDN_P3 & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x99, (uint8_t)(ptSSP->u16SSDN_P1 & 0xFF));
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0x9A,
-        (uint8_t)(((ptSSP->u16SSUDP >> 4) & 0xF0) | ((ptSSP->u16SSDN_P1 >> 8) & 0x0F))
-      );
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x9B, (uint8_t)(ptSSP->u16SSUDP & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x9C, (uint8_t)((ptSSP->u16SSUP_P2 >> 8) & 0x7F));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x9D, (uint8_t)(ptSSP->u16SSUP_P2 & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x9E, (uint8_t)((ptSSP->u16SSUP_P3 >> 8) & 0x7F));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0x9F, (uint8_t)(ptSSP->u16SSUP_P3 & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0xA0, (uint8_t)(ptSSP->u16SSUP_P1 & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0xA1, (uint8_t)((ptSSP->u16SSUP_P1 >> 8) & 0x0F));
+      Lock(ptSi5351, SI5351_API_SETSSP);
+      au8Value[ 0] = (uint8_t)(ptSSP->u16SSDN_P2 & 0xFF);
+      au8Value[ 1] = (uint8_t)(((ptSSP->tSSC_MODE & 0x1) << 7) | ((ptSSP->u16SSDN_P3 >> 8) & 0x7F));
+      au8Value[ 2] = (uint8_t)(ptSSP->u16SSDN_P3 & 0xFF);
+      au8Value[ 3] = (uint8_t)(ptSSP->u16SSDN_P1 & 0xFF);
+      au8Value[ 4] = (uint8_t)(((ptSSP->u16SSUDP >> 4) & 0xF0) | ((ptSSP->u16SSDN_P1 >> 8) & 0x0F));
+      au8Value[ 5] = (uint8_t)(ptSSP->u16SSUDP & 0xFF);
+      au8Value[ 6] = (uint8_t)((ptSSP->u16SSUP_P2 >> 8) & 0x7F);
+      au8Value[ 7] = (uint8_t)(ptSSP->u16SSUP_P2 & 0xFF);
+      au8Value[ 8] = (uint8_t)((ptSSP->u16SSUP_P3 >> 8) & 0x7F);
+      au8Value[ 9] = (uint8_t)(ptSSP->u16SSUP_P3 & 0xFF);
+      au8Value[10] = (uint8_t)(ptSSP->u16SSUP_P1 & 0xFF);
+      au8Value[11] = (uint8_t)((ptSSP->u16SSUP_P1 >> 8) & 0x0F);
+      WriteBlock(ptSi5351, 0x96, au8Value, 12);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+#if SI5351_TYPE == 1
+/* Reg.162-164 VCXO Parameter */
+/* VCXO_Param : VCXO Parameter */
+bool Si5351_GetVCXO(uint32_t* pu32VCXO, const Si5351_t* ptSi5351) {
+  bool bValid = false;
+  uint8_t au8Value[3];
+
+  if(pu32VCXO && ptSi5351) {
+    if(ptSi5351->tRead) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_GETVCXO);
+      ReadBlock(ptSi5351, 0xA2, au8Value, 3);
+      Unlock(ptSi5351);
+
+      *pu32VCXO = (((uint32_t)au8Value[2] & 0x3F) << 16) | ((uint32_t)au8Value[1] << 8) | au8Value[0];
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetVCXO(const Si5351_t* ptSi5351, const uint32_t u32VCXO) {
+  bool bValid = false;
+  uint8_t au8Value[3];
+
+  if(ptSi5351) {
+    if(ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETVCXO);
+      au8Value[0] = (uint8_t)( u32VCXO        & 0xFF);
+      au8Value[1] = (uint8_t)((u32VCXO >>  8) & 0xFF);
+      au8Value[2] = (uint8_t)((u32VCXO >> 16) & 0x3F);
+      WriteBlock(ptSi5351, 0xA2, au8Value, 3);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+#endif
+
+/* Reg.165-172 CLKx Initial Phase Offset */
+/* CLK0-5_PHOFF : Clock 0-5 Initial Phase Offset */
+bool Si5351_GetPhaseOffset(uint8_t* pu8PhOff, const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo) {
+  bool bValid = false;
+
+#if SI5351_CLKNUM <= 3
+  if(pu8PhOff && ptSi5351 && tCLKNo < 3) {
+#else
+  if(pu8PhOff && ptSi5351 && tCLKNo < 6) {
+#endif
+    if(ptSi5351->tRead) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_GETPHASEOFFSET);
+      *pu8PhOff = (uint8_t)(ReadReg(ptSi5351, 0xA5 + tCLKNo) & 0x7F);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetPhaseOffset(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, const uint8_t u8PhOff) {
+  bool bValid = false;
+
+#if SI5351_CLKNUM <= 3
+  if(ptSi5351 && tCLKNo < 3) {
+#else
+  if(ptSi5351 && tCLKNo < 6) {
+#endif
+    if(ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETPHASEOFFSET);
+      WriteReg(ptSi5351, 0xA5 + tCLKNo, (u8PhOff & 0x7F));
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+/* PLL soft reset */
+/* Reg.177 PLL soft reset */
+bool Si5351_PLLSoftReset(const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_PLLSOFTRESET);
+      ModifyReg(ptSi5351, 0xB1, 0xF0, 0xA0);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+/* Crystal Internal Load Capacitance */
+/* Reg.183 Crystal Internal Load Capacitance */
+bool Si5351_GetXTALLoadCap(Si5351_XTALLoadCap_t* ptXTALLoadCap, const Si5351_t* ptSi5351) {
+  bool bValid = false;
+
+  if(ptXTALLoadCap && ptSi5351) {
+    if(ptSi5351->tRead) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_GETXTALLOADCAP);
+      *ptXTALLoadCap = (Si5351_XTALLoadCap_t)((ReadReg(ptSi5351, 0xB7) >> 6) & 0x3);
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_SetXTALLoadCap(const Si5351_t* ptSi5351, const Si5351_XTALLoadCap_t tXTALLoadCap) {
+  bool bValid = false;
+
+  if(ptSi5351) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETXTALLOADCAP);
+      ModifyReg(ptSi5351, 0xB7, 0x3 << 6, ((uint8_t)tXTALLoadCap & 0x3) << 6);
       Unlock(ptSi5351);
     }
   }
@@ -1166,173 +2638,449 @@ bool Si5351_SetSSP(const Si5351_t* ptSi5351, const Si5351_SSP_t* ptSSP) {
   return bValid;
 }
 
-#if SI5351_TYPE == 1
-/* Reg.162-164 VCXO Parameter */
-/* VCXO_Param : VCXO Parameter */
-bool Si5351_GetVCXO(uint32_t* pu32VCXO, const Si5351_t* ptSi5351) {
+/* Utility */
+
+/*
+  Best rational approximation
+
+  Continued fraction expansion of the fractional part of u64Num/u64Den.
+  Each convergent is the closest fraction for its denominator, and the last
+  step also tries the semiconvergent that still fits, so the result is the
+  closest b/c with c <= 0xFFFFF. The search stops early once |error| <= u32PPB
+  (0: closest b/c), tested without division. At most about 30 steps of one
+  division each.
+*/
+#define MAX_RATIO_DENO 0xFFFFF
+#define MAX_RATIO_BASE 0xFFFFFFFFFFFULL  /* u64Den limit, c * u64Den fits in 64 bits */
+#define RATIO_SCALE    1024  /* floating frequencies to integer 1/1024 Hz */
+
+/* 32-bit division when both operands fit (cheap on small MCUs) */
+static uint64_t DivU64(const uint64_t u64Num, const uint64_t u64Den) {
+  if(!((u64Num | u64Den) >> 32)) {
+    return (uint32_t)u64Num / (uint32_t)u64Den;
+  }
+  return u64Num / u64Den;
+}
+
+/* |b * u64Den - c * u64Rem|, c times the distance of b/c from u64Rem/u64Den */
+static uint64_t RatioDiff(const uint32_t u32b, const uint32_t u32c, const uint64_t u64Den, const uint64_t u64Rem) {
+  if((uint64_t)u32b * u64Den >= (uint64_t)u32c * u64Rem) {
+    return (uint64_t)u32b * u64Den - (uint64_t)u32c * u64Rem;
+  }
+  return (uint64_t)u32c * u64Rem - (uint64_t)u32b * u64Den;
+}
+
+/* (b/c - u64Rem/u64Den) / (u64Num/u64Den) in ppb */
+static int32_t RatioErrPPB(const uint32_t u32b, const uint32_t u32c, const uint64_t u64Num, const uint64_t u64Den, const uint64_t u64Rem) {
+  bool bNegative;
+  uint64_t u64Diff;
+  uint64_t u64Base;
+
+  bNegative = ((uint64_t)u32b * u64Den < (uint64_t)u32c * u64Rem) ? true : false;
+  u64Diff = RatioDiff(u32b, u32c, u64Den, u64Rem);
+  u64Base = u64Num;
+  while(u64Diff >> 34) {
+    u64Diff >>= 1;
+    u64Base >>= 1;
+  }
+  if(!u64Base) {
+    u64Base = 1;
+  }
+  u64Diff = DivU64(DivU64(u64Diff * 1000000000, u32c), u64Base);
+  if(u64Diff > 0x7FFFFFFF) {
+    u64Diff = 0x7FFFFFFF;
+  }
+
+  return bNegative ? -(int32_t)u64Diff : (int32_t)u64Diff;
+}
+
+static uint32_t AbsPPB(const int32_t i32Err) {
+  return (uint32_t)(i32Err < 0 ? -i32Err : i32Err);
+}
+
+/* u64A * u64B as 128 bits */
+static void MulU64(uint64_t* pu64Hi, uint64_t* pu64Lo, const uint64_t u64A, const uint64_t u64B) {
+  uint64_t u64LL = (uint64_t)(uint32_t)u64A * (uint32_t)u64B;
+  uint64_t u64HL = (u64A >> 32) * (uint32_t)u64B;
+  uint64_t u64LH = (uint64_t)(uint32_t)u64A * (u64B >> 32);
+  uint64_t u64Mid = (u64LL >> 32) + (uint32_t)u64HL + (uint32_t)u64LH;
+
+  *pu64Lo = (u64Mid << 32) | (uint32_t)u64LL;
+  *pu64Hi = (u64A >> 32) * (u64B >> 32) + (u64HL >> 32) + (u64LH >> 32) + (u64Mid >> 32);
+}
+
+/*
+  |b/c - u64Rem/u64Den| / (u64Num/u64Den) > u32PPB / 1e9 for the convergent
+  b/c, whose u64Diff = |b * u64Den - c * u64Rem| is the Euclid remainder.
+  Cross-multiplied, u64Diff * 1e9 > u32PPB * c * u64Num, no division.
+*/
+static bool RatioOverPPB(const uint64_t u64Diff, const uint32_t u32c, const uint64_t u64Num, const uint32_t u32PPB) {
+  uint64_t u64Tol = (uint64_t)u32PPB * u32c;
+  uint64_t u64ErrHi;
+  uint64_t u64ErrLo;
+  uint64_t u64TolHi;
+  uint64_t u64TolLo;
+
+  if(!(u64Diff >> 34) && !((u64Tol | u64Num) >> 32)) {
+    return (u64Diff * 1000000000 > u64Tol * u64Num) ? true : false;
+  }
+  MulU64(&u64ErrHi, &u64ErrLo, u64Diff, 1000000000);
+  MulU64(&u64TolHi, &u64TolLo, u64Tol, u64Num);
+
+  return (u64ErrHi > u64TolHi || (u64ErrHi == u64TolHi && u64ErrLo > u64TolLo)) ? true : false;
+}
+
+bool Si5351_CalcMSRatio(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint64_t u64Num, const uint64_t u64Den, const uint32_t u32PPB) {
+  bool bValid = false;
+  uint64_t u64a;
+  uint64_t u64Rem;
+  uint64_t u64N;
+  uint64_t u64D;
+  uint64_t u64q;
+  uint64_t u64T;
+  uint32_t u32h1;
+  uint32_t u32k1;
+  uint32_t u32h2;
+  uint32_t u32k2;
+  uint32_t u32b;
+  uint32_t u32c;
+  uint32_t u32Floor;
+  int32_t i32Err;
+
+  if(ptMS && u64Den > 0 && u64Den <= MAX_RATIO_BASE) {
+    u64a = DivU64(u64Num, u64Den);
+    if(u64a >= 4 && u64a < 2048) {
+      bValid = true;
+      u64Rem = u64Num - u64a * u64Den;
+
+      /* convergents h/k of u64Rem/u64Den = [0; q1, q2, ...] */
+      u32h2 = 1;
+      u32k2 = 0;
+      u32h1 = 0;
+      u32k1 = 1;
+      u64N = u64Den;
+      u64D = u64Rem;
+      u32b = 0;
+      u32c = 1;
+      while(u64D && (u32PPB == 0 || RatioOverPPB(u64D, u32c, u64Num, u32PPB))) {
+        u64q = DivU64(u64N, u64D);
+        u64T = u64N - u64q * u64D;
+        u64N = u64D;
+        u64D = u64T;
+        if(u64q > (MAX_RATIO_DENO - u32k2) / u32k1) {
+          /* denominator overflows: largest semiconvergent, if closer */
+          u64q = (MAX_RATIO_DENO - u32k2) / u32k1;
+          if(u64q) {
+            u32h2 += (uint32_t)u64q * u32h1;
+            u32k2 += (uint32_t)u64q * u32k1;
+            /* |h2/k2 - x| < |b/c - x|, compared without division */
+            if(RatioDiff(u32h2, u32k2, u64Den, u64Rem) * u32c < RatioDiff(u32b, u32c, u64Den, u64Rem) * u32k2) {
+              u32b = u32h2;
+              u32c = u32k2;
+            }
+          }
+          break;
+        }
+        u32b = (uint32_t)u64q * u32h1 + u32h2;
+        u32c = (uint32_t)u64q * u32k1 + u32k2;
+        u32h2 = u32h1;
+        u32k2 = u32k1;
+        u32h1 = u32b;
+        u32k1 = u32c;
+      }
+      i32Err = RatioErrPPB(u32b, u32c, u64Num, u64Den, u64Rem);
+      if(u32b == u32c) {
+        /* 1/1 carries into a */
+        u64a++;
+        u32b = 0;
+        u32c = 1;
+      }
+
+      u32Floor = (uint32_t)(((uint64_t)u32b << 7) / u32c);
+      ptMS->bInteger = (u32b == 0 && !(u64a & 0x1)) ? true : false;
+      ptMS->u32MSX_P1 = ((uint32_t)u64a << 7) + u32Floor - 512;
+      ptMS->u32MSX_P2 = (u32b << 7) - u32c * u32Floor;
+      ptMS->u32MSX_P3 = u32c;
+      if(pi32ErrPPB) {
+        *pi32ErrPPB = i32Err;
+      }
+    }
+  }
+
+  return bValid;
+}
+
+#if SI5351_CLKNUM > 3
+/*
+  MS6/MS7 divider for u32Output from u32VCO (Hz): smallest R that brings the
+  divider to 254 or below, then the nearest even integer.
+  *pi32ErrPPB is the output frequency error.
+*/
+bool Si5351_CalcMS67(uint8_t* pu8MS, Si5351_MS_DIV_t* ptDIV, int32_t* pi32ErrPPB, const uint32_t u32VCO, const uint32_t u32Output) {
   bool bValid = false;
-  uint8_t u8Reg;
-  uint8_t au8Value[3];
-
-  if(pu32VCXO && ptSi5351) {
-    if(ptSi5351->tRead) {
+  uint64_t u64Step;
+  uint64_t u64MS;
+  uint8_t u8DIV;
+
+  if(pu8MS && ptDIV && u32VCO > 0 && u32Output > 0) {
+    for(u8DIV = SI5351_MS_DIV_BY1; u8DIV < SI5351_MS_DIV_BY128; u8DIV++) {
+      if(u32VCO <= ((uint64_t)u32Output << u8DIV) * 254) {
+        break;
+      }
+    }
+    u64Step = (uint64_t)u32Output << u8DIV;
+    u64MS = ((u32VCO + u64Step) / (u64Step * 2)) * 2;
+    if(IsMS67Divider(u64MS)) {
       bValid = true;
-      Lock(ptSi5351);
-      for(u8Reg = 0; u8Reg < 3; u8Reg++) {
-        au8Value[u8Reg] = ptSi5351->tRead(ptSi5351->pInstance, 0xA2 + u8Reg);
+      *pu8MS = (uint8_t)u64MS;
+      *ptDIV = (Si5351_MS_DIV_t)u8DIV;
+      if(pi32ErrPPB) {
+        *pi32ErrPPB = (int32_t)(((int64_t)u32VCO - (int64_t)(u64MS * u64Step)) * 1000000000 / (int64_t)(u64MS * u64Step));
       }
-      Unlock(ptSi5351);
-
-      *pu32VCXO = (((uint32_t)au8Value[2] & 0x3F) << 16) | ((uint32_t)au8Value[1] << 8) | au8Value[0];
     }
   }
 
   return bValid;
 }
+#endif
 
-bool Si5351_SetVCXO(const Si5351_t* ptSi5351, const uint32_t u32VCXO) {
+#if defined(SI5351_USE_INTEGER_MATH)
+/*
+  Integer engine
+
+  Frequencies are integer Hz. (a+b/c) is computed with integer division
+  only, by Si5351_CalcMSRatio(), so the ratio is exact whenever its reduced
+  denominator fits in 20 bits. MSx_INT/FBx_INT is set only for even integer ratios.
+*/
+/* 128 * (a+b/c) * P3 */
+static uint64_t MSNumerator(const Si5351_MS_t* ptMS) {
+  return ((uint64_t)ptMS->u32MSX_P1 + 512) * ptMS->u32MSX_P3 + ptMS->u32MSX_P2;
+}
+
+static bool IsValidMS(const Si5351_MS_t* ptMS) {
+  return (
+    ptMS->u32MSX_P1 < 0x40000  &&
+    ptMS->u32MSX_P2 < 0x100000 &&
+    ptMS->u32MSX_P3 < 0x100000 &&
+    ptMS->u32MSX_P3 > 0 &&
+    ptMS->u32MSX_P2 < ptMS->u32MSX_P3 * 128 &&
+    (!ptMS->bInteger || ptMS->u32MSX_P2 == 0)
+  ) ? true : false;
+}
+
+bool Si5351_CalcMSPLL(Si5351_MS_t* ptMS, const uint32_t u32BaseClock, const uint32_t u32Output) {
+  return Si5351_CalcMSPLLEx(ptMS, NULL, u32BaseClock, u32Output, SI5351_CALC_PPB);
+}
+
+bool Si5351_CalcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint32_t u32BaseClock, const uint32_t u32Output, const uint32_t u32PPB) {
   bool bValid = false;
 
-  if(ptSi5351) {
-    if(ptSi5351->tWrite) {
-      bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(ptSi5351->pInstance, 0xA2, (uint8_t)( u32VCXO        & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0xA3, (uint8_t)((u32VCXO >>  8) & 0xFF));
-      ptSi5351->tWrite(ptSi5351->pInstance, 0xA4, (uint8_t)((u32VCXO >> 16) & 0x3F));
-      Unlock(ptSi5351);
+  if(ptMS && u32BaseClock > 0 && u32Output > 0) {
+    if((uint64_t)u32Output >= (uint64_t)u32BaseClock * 15 && (uint64_t)u32Output <= (uint64_t)u32BaseClock * 90) {
+      if(Si5351_CalcMSRatio(ptMS, pi32ErrPPB, u32Output, u32BaseClock, u32PPB)) {
+        bValid = true;
+        ptMS->bDivBy4 = false;
+        ptMS->tDIV = SI5351_MS_DIV_BY1;
+      }
     }
   }
 
   return bValid;
 }
-#endif
 
-/* Reg.165-172 CLKx Initial Phase Offset */
-/* CLK0-5_PHOFF : Clock 0-5 Initial Phase Offset */
-bool Si5351_GetPhaseOffset(uint8_t* pu8PhOff, const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo) {
+bool Si5351_DecalcMSPLL(uint32_t* pu32Output, const uint32_t u32BaseClock, const Si5351_MS_t* ptMS) {
   bool bValid = false;
-
-#if SI5351_CLKNUM <= 3
-  if(pu8PhOff && ptSi5351 && tCLKNo < 3) {
-#else
-  if(pu8PhOff && ptSi5351 && tCLKNo < 6) {
-#endif
-    if(ptSi5351->tRead) {
-      bValid = true;
-      Lock(ptSi5351);
-      *pu8PhOff = (uint8_t)(ptSi5351->tRead(ptSi5351->pInstance, 0xA5 + tCLKNo) & 0x7F);
-      Unlock(ptSi5351);
+  uint64_t u64Num;
+  uint64_t u64Den;
+
+  if(pu32Output && u32BaseClock > 0 && ptMS) {
+    if(IsValidMS(ptMS)) {
+      u64Num = MSNumerator(ptMS);
+      u64Den = (uint64_t)ptMS->u32MSX_P3 << 7;
+      if(u64Num >= 15 * u64Den && u64Num <= 90 * u64Den) {
+        bValid = true;
+        *pu32Output = (uint32_t)((u64Num * u32BaseClock + u64Den / 2) / u64Den);
+      }
     }
   }
 
   return bValid;
 }
 
-bool Si5351_SetPhaseOffset(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, const uint8_t u8PhOff) {
+/*
+  R divider: smallest R_DIV that brings (a+b/c) to 1800 or below.
+  Exactly 4 selects the divide-by-4 mode (150MHz < Freq_OUT <= 200MHz).
+*/
+bool Si5351_CalcMSClk(Si5351_MS_t* ptMS, const uint32_t u32BaseClock, const uint32_t u32Output) {
+  return Si5351_CalcMSClkEx(ptMS, NULL, u32BaseClock, u32Output, SI5351_CALC_PPB);
+}
+
+/* *pi32ErrPPB is the output frequency error (opposite sign to the ratio error) */
+bool Si5351_CalcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint32_t u32BaseClock, const uint32_t u32Output, const uint32_t u32PPB) {
   bool bValid = false;
+  uint64_t u64Den;
+  uint8_t u8DIV;
 
-#if SI5351_CLKNUM <= 3
-  if(ptSi5351 && tCLKNo < 3) {
-#else
-  if(ptSi5351 && tCLKNo < 6) {
-#endif
-    if(ptSi5351->tWrite) {
+  if(ptMS && u32BaseClock > 0 && u32Output > 0) {
+    if((uint64_t)u32Output * 4 == u32BaseClock) {
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(ptSi5351->pInstance, 0xA5 + tCLKNo, (u8PhOff & 0x7F));
-      Unlock(ptSi5351);
+      if(pi32ErrPPB) {
+        *pi32ErrPPB = 0;
+      }
+      ptMS->bInteger = true;
+      ptMS->u32MSX_P1 = 0;
+      ptMS->u32MSX_P2 = 0;
+      ptMS->u32MSX_P3 = 1;
+      ptMS->tDIV = SI5351_MS_DIV_BY1;
+      ptMS->bDivBy4 = true;
+    } else {
+      for(u8DIV = SI5351_MS_DIV_BY1; u8DIV < SI5351_MS_DIV_BY128; u8DIV++) {
+        if(u32BaseClock <= ((uint64_t)u32Output << u8DIV) * 1800) {
+          break;
+        }
+      }
+      u64Den = (uint64_t)u32Output << u8DIV;
+      if(u32BaseClock >= u64Den * 6 && u32BaseClock <= u64Den * 1800) {
+        if(Si5351_CalcMSRatio(ptMS, pi32ErrPPB, u32BaseClock, u64Den, u32PPB)) {
+          bValid = true;
+          ptMS->tDIV = (Si5351_MS_DIV_t)u8DIV;
+          ptMS->bDivBy4 = false;
+          if(pi32ErrPPB) {
+            *pi32ErrPPB = -*pi32ErrPPB;
+          }
+        }
+      }
     }
   }
 
   return bValid;
 }
 
-/* PLL soft reset */
-/* Reg.177 PLL soft reset */
-bool Si5351_PLLSoftReset(const Si5351_t* ptSi5351) {
+bool Si5351_DecalcMSClk(uint32_t* pu32Output, const uint32_t u32BaseClock, const Si5351_MS_t* ptMS) {
   bool bValid = false;
+  uint64_t u64Num;
+  uint64_t u64Den;
 
-  if(ptSi5351) {
-    if(ptSi5351->tRead && ptSi5351->tWrite) {
-      bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(ptSi5351->pInstance, 0xB1, (ptSi5351->tRead(ptSi5351->pInstance, 0xB1) & 0x0F) | 0xA0);
-      Unlock(ptSi5351);
+  if(pu32Output && u32BaseClock > 0 && ptMS) {
+    if(IsValidMS(ptMS)) {
+      u64Num = (uint64_t)u32BaseClock * ptMS->u32MSX_P3 << 7;
+      u64Den = MSNumerator(ptMS);
+      if(
+        (ptMS->bDivBy4 && u64Den == ((uint64_t)ptMS->u32MSX_P3 << 9)) ||
+        (u64Den >= ((uint64_t)ptMS->u32MSX_P3 << 7) * 6 && u64Den <= ((uint64_t)ptMS->u32MSX_P3 << 7) * 1800)
+      ) {
+        bValid = true;
+        u64Den <<= ptMS->tDIV & 0x7;
+        *pu32Output = (uint32_t)((u64Num + u64Den / 2) / u64Den);
+      }
     }
   }
 
   return bValid;
 }
 
-/* Crystal Internal Load Capacitance */
-/* Reg.183 Crystal Internal Load Capacitance */
-bool Si5351_GetXTALLoadCap(Si5351_XTALLoadCap_t* ptXTALLoadCap, const Si5351_t* ptSi5351) {
+/* floor(u64Num / u64Den) as P1 and 32767 * fraction as P2 */
+static void CalcSSPParam(uint16_t* pu16P1, uint16_t* pu16P2, uint64_t u64Num, uint64_t u64Den) {
+  uint64_t u64Rem;
+
+  *pu16P1 = (uint16_t)(u64Num / u64Den);
+  u64Rem = u64Num % u64Den;
+  while(u64Den >= ((uint64_t)1 << 48)) {
+    u64Rem >>= 1;
+    u64Den >>= 1;
+  }
+  *pu16P2 = (uint16_t)(u64Rem * 32767 / u64Den);
+}
+
+/*
+  ptMS    : PLLA feedback setting, (a+b/c)
+  u16SscAmp : spread amplitude in ppm
+    Down   : 1000 (0.1%) - 25000 (2.5%)
+    Center : 0 - 15000 (plus-minus 1.5%)
+*/
+bool Si5351_CalcSSP(
+  Si5351_SSP_t* ptSSP,
+  const Si5351_SSP_Mode_t tSSC_MODE,
+  const uint32_t u32Freq_PFD,
+  const Si5351_MS_t* ptMS,
+  const uint16_t u16SscAmp
+) {
   bool bValid = false;
+  uint64_t u64Num;
+  uint64_t u64Den;
 
-  if(ptXTALLoadCap && ptSi5351) {
-    if(ptSi5351->tRead) {
-      bValid = true;
-      Lock(ptSi5351);
-      *ptXTALLoadCap = (Si5351_XTALLoadCap_t)((ptSi5351->tRead(ptSi5351->pInstance, 0xB7) >> 6) & 0x3);
-      Unlock(ptSi5351);
+  if(ptSSP && ptMS && u32Freq_PFD >= 4 * 35100 && u32Freq_PFD / (4 * 35100) < 0x1000 && IsValidMS(ptMS)) {
+    ptSSP->tSSC_MODE = (Si5351_SSP_Mode_t)(tSSC_MODE & 1);
+    ptSSP->u16SSUDP = (uint16_t)((u32Freq_PFD + 2 * 35100) / (4 * 35100));
+    /* 128 * (a+b/c) = MSNumerator / P3 */
+    u64Num = MSNumerator(ptMS) * u16SscAmp;
+    u64Den = (uint64_t)ptMS->u32MSX_P3 * ptSSP->u16SSUDP;
+    if(ptSSP->tSSC_MODE == SI5351_SSP_MODE_DOWN) {
+      if(u16SscAmp >= 1000 && u16SscAmp <= 25000) {
+        bValid = true;
+        /* SSDN = 64 * (a+b/c) * sscAmp / ((1 + sscAmp) * SSUDP) */
+        CalcSSPParam(&ptSSP->u16SSDN_P1, &ptSSP->u16SSDN_P2, u64Num, u64Den * 2 * (1000000 + u16SscAmp));
+        ptSSP->u16SSDN_P3 = 32767;
+        ptSSP->u16SSUP_P1 = 0;
+        ptSSP->u16SSUP_P2 = 0;
+        ptSSP->u16SSUP_P3 = 1;
+      }
+    } else if(ptSSP->tSSC_MODE == SI5351_SSP_MODE_CENTER) {
+      if(u16SscAmp <= 15000) {
+        bValid = true;
+        /* SSDN = 128 * (a+b/c) * sscAmp / ((1 + sscAmp) * SSUDP) */
+        CalcSSPParam(&ptSSP->u16SSDN_P1, &ptSSP->u16SSDN_P2, u64Num, u64Den * (1000000 + u16SscAmp));
+        ptSSP->u16SSDN_P3 = 32767;
+        /* SSUP = 128 * (a+b/c) * sscAmp / ((1 - sscAmp) * SSUDP) */
+        CalcSSPParam(&ptSSP->u16SSUP_P1, &ptSSP->u16SSUP_P2, u64Num, u64Den * (1000000 - u16SscAmp));
+        ptSSP->u16SSUP_P3 = 32767;
+      }
     }
   }
 
   return bValid;
 }
 
-bool Si5351_SetXTALLoadCap(const Si5351_t* ptSi5351, const Si5351_XTALLoadCap_t tXTALLoadCap) {
+#if SI5351_TYPE == 1
+/* ptMS : PLLB feedback setting, (a+b/c) */
+bool Si5351_CalcVCXO(uint32_t* pu32VCXO, const Si5351_MS_t* ptMS, const uint8_t u8APR) {
   bool bValid = false;
 
-  if(ptSi5351) {
-    if(ptSi5351->tRead && ptSi5351->tWrite) {
+  if(pu32VCXO && ptMS) {
+    if(IsValidMS(ptMS)) {
       bValid = true;
-      Lock(ptSi5351);
-      ptSi5351->tWrite(
-        ptSi5351->pInstance, 0xB7,
-        (ptSi5351->tRead(ptSi5351->pInstance, 0xB7) & ~(0x3 << 6)) | (((uint8_t)tXTALLoadCap & 0x3) << 6)
-      );
-      Unlock(ptSi5351);
+      /* 1.03 * (128 * (a+b/c)) * APR */
+      *pu32VCXO = (uint32_t)(MSNumerator(ptMS) * 103 * u8APR / ((uint64_t)ptMS->u32MSX_P3 * 100));
     }
   }
 
   return bValid;
 }
-
-/* Utility */
-
-#if defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
+#endif
+#elif defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
 static uint64_t f64_floor(float64_t f64Value) {
   return f64_to_ui64(f64_add(f64Value, f64_div(ui64_to_f64(1), ui64_to_f64(2))), softfloat_round_minMag, false); 
 }
 
+static uint64_t f64_scaled(float64_t f64Value) {
+  return f64_to_ui64(f64_mul(f64Value, ui64_to_f64(RATIO_SCALE)), softfloat_round_near_even, false);
+}
+
 bool Si5351_CalcMSPLL(Si5351_MS_t* ptMS, const float64_t f64BaseClock, const float64_t f64Output) {
+  return Si5351_CalcMSPLLEx(ptMS, NULL, f64BaseClock, f64Output, SI5351_CALC_PPB);
+}
+
+bool Si5351_CalcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const float64_t f64BaseClock, const float64_t f64Output, const uint32_t u32PPB) {
   bool bValid = false;
   float64_t f64Ratio;
-  float64_t f64After;
-  uint32_t u32a;
-  uint32_t u32b;
 
   if(ptMS && !f64_le(f64BaseClock, ui64_to_f64(0)) && !f64_le(f64Output, ui64_to_f64(0))) {
     f64Ratio = f64_div(f64Output, f64BaseClock);
     if(!f64_lt(f64Ratio, ui64_to_f64(15)) && f64_le(f64Ratio, ui64_to_f64(90))) {
-      bValid = true;
-      ptMS->bDivBy4 = false;
-      ptMS->tDIV = SI5351_MS_DIV_BY1;
-      f64After = f64_sub(f64Ratio, f64_roundToInt(f64Ratio, softfloat_round_minMag, false));
-      u32a = f64_to_ui64(f64Ratio, softfloat_round_minMag, false);
-      u32b = f64_to_ui64(f64_mul(f64After, ui64_to_f64(MAX_DENO)), softfloat_round_minMag, false);
-      if(u32b == 0) {
-        ptMS->bInteger = true;
-        ptMS->u32MSX_P1 = (u32a << 7) - 512;
-        ptMS->u32MSX_P2 = 0;
-        ptMS->u32MSX_P3 = MAX_DENO;
-      } else {
-        ptMS->bInteger = false;
-        ptMS->u32MSX_P1 = (u32a << 7) + f64_floor(f64_mul(ui64_to_f64(128), f64After)) - 512;
-        ptMS->u32MSX_P2 = (u32b << 7) - MAX_DENO * f64_floor(f64_mul(ui64_to_f64(128), f64After));
-        ptMS->u32MSX_P3 = MAX_DENO;
+      if(Si5351_CalcMSRatio(ptMS, pi32ErrPPB, f64_scaled(f64Output), f64_scaled(f64BaseClock), u32PPB)) {
+        bValid = true;
+        ptMS->bDivBy4 = false;
+        ptMS->tDIV = SI5351_MS_DIV_BY1;
       }
     }
   }
@@ -1358,8 +3106,8 @@ bool Si5351_DecalcMSPLL(float64_t* pf64Output, const float64_t f64BaseClock, con
         }
       } else {
         bValid = true;
-        f64Ratio = f64_add(f64_div(ui64_to_f64(ptMS->u32MSX_P1), ui64_to_f64(128)), ui64_to_f64(4));
-        f64Ratio = f64_add(f64Ratio, f64_div(ui64_to_f64(ptMS->u32MSX_P2), ui64_to_f64(128 * MAX_DENO)));
+        f64Ratio = f64_add(ui64_to_f64(ptMS->u32MSX_P1 + 512), f64_div(ui64_to_f64(ptMS->u32MSX_P2), ui64_to_f64(ptMS->u32MSX_P3)));
+        f64Ratio = f64_div(f64Ratio, ui64_to_f64(128));
       }
     }
     if(bValid) {
@@ -1375,16 +3123,19 @@ bool Si5351_DecalcMSPLL(float64_t* pf64Output, const float64_t f64BaseClock, con
 }
 
 bool Si5351_CalcMSClk(Si5351_MS_t* ptMS, const float64_t f64BaseClock, const float64_t f64Output) {
+  return Si5351_CalcMSClkEx(ptMS, NULL, f64BaseClock, f64Output, SI5351_CALC_PPB);
+}
+
+/* *pi32ErrPPB is the output frequency error (opposite sign to the ratio error) */
+bool Si5351_CalcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const float64_t f64BaseClock, const float64_t f64Output, const uint32_t u32PPB) {
   bool bValid = false;
   float64_t f64Ratio, f64RatioTemp;
-  float64_t f64After, f64AfterTemp;
+  float64_t f64AfterTemp;
   uint32_t u32a;
-  uint32_t u32b;
 
   if(ptMS && !f64_le(f64BaseClock, ui64_to_f64(0)) && !f64_le(f64Output, ui64_to_f64(0))) {
     f64Ratio = f64_div(f64BaseClock, f64Output);
     if(!f64_lt(f64Ratio, ui64_to_f64(6)) && f64_le(f64Ratio, ui64_to_f64(1800))) {
-      bValid = true;
       ptMS->bDivBy4 = false;
       ptMS->tDIV = SI5351_MS_DIV_BY1;
       for(u32a = 0; u32a < 8; u32a++) {
@@ -1399,20 +3150,11 @@ bool Si5351_CalcMSClk(Si5351_MS_t* ptMS, const float64_t f64BaseClock, const flo
       } else {
         ptMS->tDIV = (Si5351_MS_DIV_t)u32a;
       }
-      f64Ratio = f64_div(f64Ratio, ui64_to_f64(1 << (ptMS->tDIV + (ptMS->bDivBy4 ? 2 : 0))));
-      f64After = f64_sub(f64Ratio, f64_roundToInt(f64Ratio, softfloat_round_minMag, false));
-      u32a = f64_to_ui64(f64Ratio, softfloat_round_minMag, false);
-      u32b = f64_to_ui64(f64_mul(f64After, ui64_to_f64(MAX_DENO)), softfloat_round_minMag, false);
-      if(u32b == 0) {
-        ptMS->bInteger = true;
-        ptMS->u32MSX_P1 = (u32a << 7) - 512;
-        ptMS->u32MSX_P2 = 0;
-        ptMS->u32MSX_P3 = MAX_DENO;
-      } else {
-        ptMS->bInteger = false;
-        ptMS->u32MSX_P1 = (u32a << 7) + f64_floor(f64_mul(ui64_to_f64(128), f64After)) - 512;
-        ptMS->u32MSX_P2 = (u32b << 7) - MAX_DENO * f64_floor(f64_mul(ui64_to_f64(128), f64After));
-        ptMS->u32MSX_P3 = MAX_DENO;
+      if(Si5351_CalcMSRatio(ptMS, pi32ErrPPB, f64_scaled(f64BaseClock), f64_scaled(f64Output) << (ptMS->tDIV + (ptMS->bDivBy4 ? 2 : 0)), u32PPB)) {
+        bValid = true;
+        if(pi32ErrPPB) {
+          *pi32ErrPPB = -*pi32ErrPPB;
+        }
       }
     }
   }
@@ -1438,8 +3180,8 @@ bool Si5351_DecalcMSClk(float64_t* pf64Output, const float64_t f64BaseClock, con
         }
       } else {
         bValid = true;
-        f64Ratio = f64_add(f64_div(ui64_to_f64(ptMS->u32MSX_P1), ui64_to_f64(128)), ui64_to_f64(4));
-        f64Ratio = f64_add(f64Ratio, f64_div(ui64_to_f64(ptMS->u32MSX_P2), ui64_to_f64(128 * MAX_DENO)));
+        f64Ratio = f64_add(ui64_to_f64(ptMS->u32MSX_P1 + 512), f64_div(ui64_to_f64(ptMS->u32MSX_P2), ui64_to_f64(ptMS->u32MSX_P3)));
+        f64Ratio = f64_div(f64Ratio, ui64_to_f64(128));
       }
     }
     if(bValid) {
@@ -1517,31 +3259,20 @@ bool Si5351_CalcVCXO(uint32_t* pu32VCXO, const float64_t f64Ratio, const uint8_t
 #endif
 #else  /* SI5351_USE_BERKELEY_SOFTFLOAT_3 */
 bool Si5351_CalcMSPLL(Si5351_MS_t* ptMS, const double dBaseClock, const double dOutput) {
+  return Si5351_CalcMSPLLEx(ptMS, NULL, dBaseClock, dOutput, SI5351_CALC_PPB);
+}
+
+bool Si5351_CalcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const double dBaseClock, const double dOutput, const uint32_t u32PPB) {
   bool bValid = false;
   double dRatio;
-  double dAfter;
-  uint32_t u32a;
-  uint32_t u32b;
 
   if(ptMS && dBaseClock > 0 && dOutput > 0) {
     dRatio = dOutput / dBaseClock;
     if(dRatio >= 15 && dRatio <= 90) {
-      bValid = true;
-      ptMS->bDivBy4 = false;
-      ptMS->tDIV = SI5351_MS_DIV_BY1;
-      dAfter = dRatio - (uint32_t)dRatio;
-      u32a = (uint32_t)dRatio;
-      u32b = (uint32_t)(dAfter * MAX_DENO);
-      if(u32b == 0) {
-        ptMS->bInteger = true;
-        ptMS->u32MSX_P1 = (u32a << 7) - 512;
-        ptMS->u32MSX_P2 = 0;
-        ptMS->u32MSX_P3 = MAX_DENO;
-      } else {
-        ptMS->bInteger = false;
-        ptMS->u32MSX_P1 = (u32a << 7) + (uint32_t)((128 * dAfter) + 0.5) - 512;
-        ptMS->u32MSX_P2 = (u32b << 7) - MAX_DENO * (uint32_t)((128 * dAfter) + 0.5);
-        ptMS->u32MSX_P3 = MAX_DENO;
+      if(Si5351_CalcMSRatio(ptMS, pi32ErrPPB, (uint64_t)(dOutput * RATIO_SCALE + 0.5), (uint64_t)(dBaseClock * RATIO_SCALE + 0.5), u32PPB)) {
+        bValid = true;
+        ptMS->bDivBy4 = false;
+        ptMS->tDIV = SI5351_MS_DIV_BY1;
       }
     }
   }
@@ -1567,8 +3298,7 @@ bool Si5351_DecalcMSPLL(double* pdOutput, const double dBaseClock, const Si5351_
         }
       } else {
         bValid = true;
-        dRatio = ptMS->u32MSX_P1 / 128 + 4;
-        dRatio += (double)ptMS->u32MSX_P2 / (128 * MAX_DENO);
+        dRatio = ((double)ptMS->u32MSX_P1 + 512 + (double)ptMS->u32MSX_P2 / ptMS->u32MSX_P3) / 128;
       }
     }
     if(bValid) {
@@ -1584,16 +3314,19 @@ bool Si5351_DecalcMSPLL(double* pdOutput, const double dBaseClock, const Si5351_
 }
 
 bool Si5351_CalcMSClk(Si5351_MS_t* ptMS, const double dBaseClock, const double dOutput) {
+  return Si5351_CalcMSClkEx(ptMS, NULL, dBaseClock, dOutput, SI5351_CALC_PPB);
+}
+
+/* *pi32ErrPPB is the output frequency error (opposite sign to the ratio error) */
+bool Si5351_CalcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const double dBaseClock, const double dOutput, const uint32_t u32PPB) {
   bool bValid = false;
   double dRatio, dRatioTemp;
-  double dAfter, dAfterTemp;
+  double dAfterTemp;
   uint32_t u32a;
-  uint32_t u32b;
 
   if(ptMS && dBaseClock >0 && dOutput > 0) {
     dRatio = dBaseClock / dOutput;
     if(dRatio >= 6 && dRatio <= 1800) {
-      bValid = true;
       ptMS->bDivBy4 = false;
       ptMS->tDIV = SI5351_MS_DIV_BY1;
       for(u32a = 0; u32a < 8; u32a++) {
@@ -1608,20 +3341,11 @@ bool Si5351_CalcMSClk(Si5351_MS_t* ptMS, const double dBaseClock, const double d
       } else {
         ptMS->tDIV = (Si5351_MS_DIV_t)u32a;
       }
-      dRatio /= 1 << (ptMS->tDIV + (ptMS->bDivBy4 ? 2 : 0));
-      dAfter = dRatio - (uint32_t)dRatio;
-      u32a = (uint32_t)dRatio;
-      u32b = (uint32_t)(dAfter * MAX_DENO);
-      if(u32b == 0) {
-        ptMS->bInteger = true;
-        ptMS->u32MSX_P1 = (u32a << 7) - 512;
-        ptMS->u32MSX_P2 = 0;
-        ptMS->u32MSX_P3 = MAX_DENO;
-      } else {
-        ptMS->bInteger = false;
-        ptMS->u32MSX_P1 = (u32a << 7) + (uint32_t)((128 * dAfter) + 0.5) - 512;
-        ptMS->u32MSX_P2 = (u32b << 7) - MAX_DENO * (uint32_t)((128 * dAfter) + 0.5);
-        ptMS->u32MSX_P3 = MAX_DENO;
+      if(Si5351_CalcMSRatio(ptMS, pi32ErrPPB, (uint64_t)(dBaseClock * RATIO_SCALE + 0.5), (uint64_t)(dOutput * RATIO_SCALE + 0.5) << (ptMS->tDIV + (ptMS->bDivBy4 ? 2 : 0)), u32PPB)) {
+        bValid = true;
+        if(pi32ErrPPB) {
+          *pi32ErrPPB = -*pi32ErrPPB;
+        }
       }
     }
   }
@@ -1647,8 +3371,7 @@ bool Si5351_DecalcMSClk(double* pdOutput, const double dBaseClock, const Si5351_
         }
       } else {
         bValid = true;
-        dRatio = (double)ptMS->u32MSX_P1 / 128 + 4;
-        dRatio += (double)(ptMS->u32MSX_P2 >> 7) / MAX_DENO;
+        dRatio = ((double)ptMS->u32MSX_P1 + 512 + (double)ptMS->u32MSX_P2 / ptMS->u32MSX_P3) / 128;
       }
     }
     if(bValid) {
@@ -1720,6 +3443,328 @@ bool Si5351_CalcVCXO(uint32_t* pu32VCXO, const double dRatio, const uint8_t u8AP
 #endif
 #endif  /* SI5351_USE_BERKELEY_SOFTFLOAT_3 */
 
+/*
+  Frequency Plan
+
+  Deterministic greedy planner, integer Hz only.
+  Each output takes the smallest R_DIV that lets its MS reach 1800 (MS6/MS7: 254)
+  at the lowest VCO, so its step is Freq * R and an even integer MS needs the
+  VCO to be a multiple of 2 * step. Over 150MHz CLK0-5 use the divide-by-4
+  mode, MS6/MS7 have none and fail the plan.
+  PLLA, then PLLB, takes the VCO that puts the most pending outputs in even
+  integer mode. Outputs that can only be integer (divide-by-4, MS6/MS7) weigh
+  more than all others, and an even integer PLL ratio breaks ties. The first best
+  VCO is kept (CLK order, lowest VCO first). Remaining outputs go fractional on
+  the PLL with the smaller error.
+  Bounded: a seed tries the even MS from 600MHz / step to the lower of
+  900MHz / step and 1800, at most 301 VCOs (step 500kHz), so 2 PLL *
+  SI5351_CLKNUM seeds * 301 VCOs * SI5351_CLKNUM checks at most.
+*/
+#define PLAN_VCO_MIN 600000000UL
+#define PLAN_VCO_MAX 900000000UL
+
+typedef struct PlanCLK_t_ {
+  uint32_t u32Step;   /* Freq * R, 0: not used */
+  uint16_t u16MSMin;
+  uint16_t u16MSMax;
+  uint8_t  u8DIV;
+  bool     bDivBy4;
+  bool     bIntegerOnly;
+  bool     bPending;
+} PlanCLK_t;
+
+static bool PlanPrepare(PlanCLK_t* ptCLK, const uint32_t u32Freq, const uint8_t u8CLKNo) {
+  bool bValid = false;
+  uint64_t u64Step;
+
+  memset(ptCLK, 0, sizeof(PlanCLK_t));
+  if(u32Freq == 0) {
+    bValid = true;
+  } else if(u32Freq > 150000000) {
+    /* MS6/MS7 : no divide-by-4 */
+    if(u32Freq <= 200000000 && u8CLKNo < 6) {
+      bValid = true;
+      ptCLK->u32Step = u32Freq;
+      ptCLK->u16MSMin = 4;
+      ptCLK->u16MSMax = 4;
+      ptCLK->bDivBy4 = true;
+      ptCLK->bIntegerOnly = true;
+      ptCLK->bPending = true;
+    }
+  } else {
+    /* MS6/MS7 : even integer 6 - 254 only */
+    ptCLK->u16MSMin = 6;
+    ptCLK->u16MSMax = (u8CLKNo >= 6) ? 254 : 1800;
+    ptCLK->bIntegerOnly = (u8CLKNo >= 6) ? true : false;
+    for(ptCLK->u8DIV = SI5351_MS_DIV_BY1; ptCLK->u8DIV < SI5351_MS_DIV_BY128; ptCLK->u8DIV++) {
+      if(((uint64_t)u32Freq << ptCLK->u8DIV) * ptCLK->u16MSMax >= PLAN_VCO_MIN) {
+        break;
+      }
+    }
+    u64Step = (uint64_t)u32Freq << ptCLK->u8DIV;
+    if(u64Step * ptCLK->u16MSMax >= PLAN_VCO_MIN && u64Step * ptCLK->u16MSMin <= PLAN_VCO_MAX) {
+      bValid = true;
+      ptCLK->u32Step = (uint32_t)u64Step;
+      ptCLK->bPending = true;
+    }
+  }
+
+  return bValid;
+}
+
+static bool PlanIsInteger(const PlanCLK_t* ptCLK, const uint32_t u32VCO) {
+  uint32_t u32MS;
+
+  if(!ptCLK->u32Step || u32VCO % ptCLK->u32Step) {
+    return false;
+  }
+  u32MS = u32VCO / ptCLK->u32Step;
+
+  return (!(u32MS & 0x1) && u32MS >= ptCLK->u16MSMin && u32MS <= ptCLK->u16MSMax) ? true : false;
+}
+
+static bool PlanIsInRange(const PlanCLK_t* ptCLK, const uint32_t u32VCO) {
+  return (
+    !ptCLK->bIntegerOnly &&
+    (uint64_t)ptCLK->u32Step * ptCLK->u16MSMin <= u32VCO &&
+    (uint64_t)ptCLK->u32Step * ptCLK->u16MSMax >= u32VCO
+  ) ? true : false;
+}
+
+/* VCO for the next PLL, 0: none */
+static uint32_t PlanPickVCO(const PlanCLK_t* ptCLK, const uint32_t u32BaseClock) {
+  uint32_t u32Best = 0;
+  uint16_t u16BestScore = 0;
+  uint16_t u16Score;
+  uint32_t u32VCO;
+  uint32_t u32MS;
+  uint32_t u32MSEnd;
+  uint8_t u8Seed;
+  uint8_t u8CLKNo;
+
+  for(u8Seed = 0; u8Seed < SI5351_CLKNUM; u8Seed++) {
+    if(!ptCLK[u8Seed].bPending) {
+      continue;
+    }
+    /* same candidates as an earlier seed */
+    for(u8CLKNo = 0; u8CLKNo < u8Seed; u8CLKNo++) {
+      if(
+        ptCLK[u8CLKNo].bPending &&
+        ptCLK[u8CLKNo].u32Step  == ptCLK[u8Seed].u32Step &&
+        ptCLK[u8CLKNo].u16MSMin == ptCLK[u8Seed].u16MSMin &&
+        ptCLK[u8CLKNo].u16MSMax == ptCLK[u8Seed].u16MSMax
+      ) {
+        break;
+      }
+    }
+    if(u8CLKNo < u8Seed) {
+      continue;
+    }
+
+    u32MS = (PLAN_VCO_MIN + ptCLK[u8Seed].u32Step - 1) / ptCLK[u8Seed].u32Step;
+    if(u32MS < ptCLK[u8Seed].u16MSMin) {
+      u32MS = ptCLK[u8Seed].u16MSMin;
+    }
+    u32MS += u32MS & 0x1;
+    u32MSEnd = PLAN_VCO_MAX / ptCLK[u8Seed].u32Step;
+    if(u32MSEnd > ptCLK[u8Seed].u16MSMax) {
+      u32MSEnd = ptCLK[u8Seed].u16MSMax;
+    }
+    for(; u32MS <= u32MSEnd; u32MS += 2) {
+      u32VCO = ptCLK[u8Seed].u32Step * u32MS;
+      if((uint64_t)u32BaseClock * 15 > u32VCO || (uint64_t)u32BaseClock * 90 < u32VCO) {
+        continue;
+      }
+      u16Score = 0;
+      for(u8CLKNo = 0; u8CLKNo < SI5351_CLKNUM; u8CLKNo++) {
+        if(ptCLK[u8CLKNo].bPending && PlanIsInteger(&ptCLK[u8CLKNo], u32VCO)) {
+          u16Score += ptCLK[u8CLKNo].bIntegerOnly ? (SI5351_CLKNUM + 1) * 2 : 2;
+        }
+      }
+      if(!(u32VCO % u32BaseClock) && !((u32VCO / u32BaseClock) & 0x1)) {
+        u16Score++;
+      }
+      if(u16Score > u16BestScore) {
+        u16BestScore = u16Score;
+        u32Best = u32VCO;
+      }
+    }
+  }
+
+  return u32Best;
+}
+
+bool Si5351_CalcPlan(Si5351_Plan_t* ptPlan, const uint32_t u32BaseClock, const Si5351_PlanRequest_t* ptRequest) {
+  bool bValid = false;
+  PlanCLK_t atCLK[SI5351_CLKNUM];
+  Si5351_MS_t tMS;
+  int32_t ai32PLLErr[2];
+  int32_t i32Err;
+  uint32_t u32Abs;
+  uint32_t u32BestAbs;
+  uint8_t u8PLL;
+  uint8_t u8CLKNo;
+
+  if(ptPlan && ptRequest && u32BaseClock > 0) {
+    memset(ptPlan, 0, sizeof(Si5351_Plan_t));
+    bValid = true;
+    for(u8CLKNo = 0; u8CLKNo < SI5351_CLKNUM; u8CLKNo++) {
+      if(!PlanPrepare(&atCLK[u8CLKNo], ptRequest[u8CLKNo].u32Freq, u8CLKNo)) {
+        bValid = false;
+      }
+    }
+
+    /* PLLs and their even integer outputs */
+    for(u8PLL = 0; bValid && u8PLL < 2; u8PLL++) {
+      ptPlan->au32VCO[u8PLL] = PlanPickVCO(atCLK, u32BaseClock);
+      if(!ptPlan->au32VCO[u8PLL]) {
+        break;
+      }
+      Si5351_CalcMSRatio(&ptPlan->atPLL[u8PLL], &ai32PLLErr[u8PLL], ptPlan->au32VCO[u8PLL], u32BaseClock, 0);
+      ptPlan->atPLL[u8PLL].tDIV = SI5351_MS_DIV_BY1;
+      ptPlan->atPLL[u8PLL].bDivBy4 = false;
+      for(u8CLKNo = 0; u8CLKNo < SI5351_CLKNUM; u8CLKNo++) {
+        if(atCLK[u8CLKNo].bPending && PlanIsInteger(&atCLK[u8CLKNo], ptPlan->au32VCO[u8PLL])) {
+          atCLK[u8CLKNo].bPending = false;
+          ptPlan->atCLK[u8CLKNo].bEnable = true;
+          ptPlan->atCLK[u8CLKNo].tSrc = (Si5351_CLK_MS_SRC_t)u8PLL;
+          Si5351_CalcMSRatio(&ptPlan->atCLK[u8CLKNo].tMS, NULL, ptPlan->au32VCO[u8PLL], atCLK[u8CLKNo].u32Step, 0);
+          ptPlan->atCLK[u8CLKNo].i32ErrPPB = ai32PLLErr[u8PLL];
+          ptPlan->u8Integer++;
+        }
+      }
+    }
+
+    /* fractional outputs */
+    for(u8CLKNo = 0; bValid && u8CLKNo < SI5351_CLKNUM; u8CLKNo++) {
+      if(atCLK[u8CLKNo].bPending) {
+        u32BestAbs = 0xFFFFFFFF;
+        for(u8PLL = 0; u8PLL < 2; u8PLL++) {
+          if(ptPlan->au32VCO[u8PLL] && PlanIsInRange(&atCLK[u8CLKNo], ptPlan->au32VCO[u8PLL])) {
+            if(Si5351_CalcMSRatio(&tMS, &i32Err, ptPlan->au32VCO[u8PLL], atCLK[u8CLKNo].u32Step, 0)) {
+              i32Err = ai32PLLErr[u8PLL] - i32Err;
+              u32Abs = AbsPPB(i32Err);
+              if(u32Abs < u32BestAbs) {
+                u32BestAbs = u32Abs;
+                ptPlan->atCLK[u8CLKNo].bEnable = true;
+                ptPlan->atCLK[u8CLKNo].tSrc = (Si5351_CLK_MS_SRC_t)u8PLL;
+                ptPlan->atCLK[u8CLKNo].tMS = tMS;
+                ptPlan->atCLK[u8CLKNo].i32ErrPPB = i32Err;
+              }
+            }
+          }
+        }
+        if(ptPlan->atCLK[u8CLKNo].bEnable) {
+          atCLK[u8CLKNo].bPending = false;
+          if(ptPlan->atCLK[u8CLKNo].tMS.bInteger) {
+            ptPlan->u8Integer++;
+          }
+        } else {
+          bValid = false;
+        }
+      }
+    }
+
+    for(u8CLKNo = 0; bValid && u8CLKNo < SI5351_CLKNUM; u8CLKNo++) {
+      if(ptPlan->atCLK[u8CLKNo].bEnable) {
+        ptPlan->atCLK[u8CLKNo].tMS.tDIV = (Si5351_MS_DIV_t)atCLK[u8CLKNo].u8DIV;
+        ptPlan->atCLK[u8CLKNo].tMS.bDivBy4 = atCLK[u8CLKNo].bDivBy4;
+        if(AbsPPB(ptPlan->atCLK[u8CLKNo].i32ErrPPB) > ptRequest[u8CLKNo].u32TolPPB) {
+          bValid = false;
+        }
+      }
+    }
+  }
+
+  return bValid;
+}
+
+/* Si5351_SetPlan: put the staged registers of one step on the device before the next step */
+static bool CommitPhase(const Si5351_t* ptSi5351, const bool bTransaction, const bool bValid) {
+  if(!bTransaction) {
+    return false;
+  }
+  if(!bValid) {
+    Si5351_AbortTransaction(ptSi5351);
+    return false;
+  }
+  Si5351_Commit(ptSi5351);
+
+  return Si5351_BeginTransaction(ptSi5351);
+}
+
+/*
+  Outputs off and powered down, then dividers and PLL reset, then the planned
+  outputs on. With a cache every step is one commit, a commit writes in
+  address order and Reg.3/16-23 come before the dividers and Reg.177.
+  Inside an open transaction the steps commit it too, and the last step
+  opens a new one for the caller to commit. The lock is held over all
+  steps, no other caller runs in between.
+*/
+bool Si5351_SetPlan(const Si5351_t* ptSi5351, const Si5351_Plan_t* ptPlan) {
+  bool bValid = false;
+  bool bOuter;
+  bool bTransaction;
+  uint8_t u8Enable = 0;
+  uint8_t u8CLKNo;
+
+  if(ptSi5351 && ptPlan) {
+    if(ptSi5351->tRead && ptSi5351->tWrite) {
+      bValid = true;
+      Lock(ptSi5351, SI5351_API_SETPLAN);
+      bOuter = InTransaction(ptSi5351);
+      bTransaction = bOuter ? true : Si5351_BeginTransaction(ptSi5351);
+      bValid = Si5351_SetOutputDisable(ptSi5351, (uint8_t)((1 << SI5351_CLKNUM) - 1));
+      for(u8CLKNo = 0; bValid && u8CLKNo < SI5351_CLKNUM; u8CLKNo++) {
+        bValid = Si5351_SetClkPowerDown(ptSi5351, (Si5351_CLKNo_t)u8CLKNo, true);
+      }
+      bTransaction = CommitPhase(ptSi5351, bTransaction, bValid);
+
+      if(bValid && ptPlan->au32VCO[SI5351_CLK_MS_SRC_PLLA]) {
+        bValid = Si5351_SetMSA(ptSi5351, &ptPlan->atPLL[SI5351_CLK_MS_SRC_PLLA]);
+      }
+      if(bValid && ptPlan->au32VCO[SI5351_CLK_MS_SRC_PLLB_VCXO]) {
+        bValid = Si5351_SetMSB(ptSi5351, &ptPlan->atPLL[SI5351_CLK_MS_SRC_PLLB_VCXO]);
+      }
+      for(u8CLKNo = 0; bValid && u8CLKNo < SI5351_CLKNUM; u8CLKNo++) {
+        if(ptPlan->atCLK[u8CLKNo].bEnable) {
+          u8Enable |= 1 << u8CLKNo;
+          bValid = (
+            Si5351_SetClkMSSource(ptSi5351, (Si5351_CLKNo_t)u8CLKNo, ptPlan->atCLK[u8CLKNo].tSrc) &&
+            Si5351_SetClkSrc(ptSi5351, (Si5351_CLKNo_t)u8CLKNo, SI5351_CLK_SRC_MS) &&
+            Si5351_SetMS(ptSi5351, (Si5351_CLKNo_t)u8CLKNo, &ptPlan->atCLK[u8CLKNo].tMS)
+          ) ? true : false;
+        }
+      }
+      if(bValid) {
+        bValid = Si5351_PLLSoftReset(ptSi5351);
+      }
+      bTransaction = CommitPhase(ptSi5351, bTransaction, bValid);
+
+      for(u8CLKNo = 0; bValid && u8CLKNo < SI5351_CLKNUM; u8CLKNo++) {
+        if(ptPlan->atCLK[u8CLKNo].bEnable) {
+          bValid = Si5351_SetClkPowerDown(ptSi5351, (Si5351_CLKNo_t)u8CLKNo, false);
+        }
+      }
+      if(bValid) {
+        bValid = Si5351_SetOutputEnable(ptSi5351, u8Enable);
+      }
+      if(bOuter) {
+        CommitPhase(ptSi5351, bTransaction, bValid);
+      } else if(bTransaction) {
+        if(bValid) {
+          Si5351_Commit(ptSi5351);
+        } else {
+          Si5351_AbortTransaction(ptSi5351);
+        }
+      }
+      Unlock(ptSi5351);
+    }
+  }
+
+  return bValid;
+}
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -8,6 +8,57 @@
 
 //#define SI5351_USE_BERKELEY_SOFTFLOAT_3
 
+/* Utility with 64-bit integer arithmetic only (frequencies in Hz) */
+//#define SI5351_USE_INTEGER_MATH
+
+#if defined(SI5351_USE_BERKELEY_SOFTFLOAT_3) && defined(SI5351_USE_INTEGER_MATH)
+#error Define only one of SI5351_USE_BERKELEY_SOFTFLOAT_3 and SI5351_USE_INTEGER_MATH
+#endif
+
+/*
+  Lock as a C11 atomic ticket lock in the ppLock word (<stdatomic.h>, needs
+  lock-free pointer-sized atomics): waiters are served in arrival order, try
+  attempts only take a free lock. tMemoryBarrier is then only called while
+  waiting and may yield. Otherwise a plain check-then-set spin, only safe on
+  a single core.
+*/
+//#define SI5351_USE_ATOMIC_LOCK
+
+/* Lock policy Si5351_LockPolicyPthread (pthread_mutex_t, Linux / POSIX hosts) */
+//#define SI5351_USE_PTHREAD_LOCK
+
+/* Si5351_Async command queue (si5351_async.h, C++11 threads) */
+//#define SI5351_USE_ASYNC
+
+/* Si5351_Fleet parallel programming over several buses (si5351_fleet.h, C++11 threads) */
+//#define SI5351_USE_FLEET
+
+/* Si5351_Coro awaitable operations on a non-blocking transport (si5351_coro.h, C++20) */
+//#define SI5351_USE_COROUTINE
+
+/* Per-operation bus statistics (Si5351_AttachStats, about 2.5KB RAM per instance) */
+//#define SI5351_USE_STATS
+
+/* Register access trace ring buffer (Si5351_AttachTrace, 8 bytes RAM per entry) */
+//#define SI5351_USE_TRACE
+
+/*
+  Debug check of the one-instance-per-context rule (see Lock): an expression
+  naming the running thread / task / ISR. Unless NDEBUG is defined, assert()
+  fails when another context enters an instance whose lock is held.
+*/
+//#define SI5351_CONTEXT_ID() ((uintptr_t)pthread_self())
+
+/* Upper limit of the lock backoff (tMemoryBarrier calls between attempts) */
+#ifndef SI5351_LOCK_BACKOFF_MAX
+#define SI5351_LOCK_BACKOFF_MAX 64
+#endif
+
+/* Utility divider search stops once the ratio error is within this (ppb, 0 = closest b/c) */
+#ifndef SI5351_CALC_PPB
+#define SI5351_CALC_PPB 0
+#endif
+
 #if defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
 #ifdef __cplusplus 
 extern "C" {
@@ -302,21 +353,309 @@ typedef enum Si5351_XTALLoadCap_t_ {
 } Si5351_XTALLoadCap_t;
 
 
+/*
+  Frequency Plan
+
+  Request : output frequency (Hz, 0 = output not used) and allowed |error| (ppb).
+  Plan    : VCO and feedback MS for PLLA/PLLB (indexed by Si5351_CLK_MS_SRC_t),
+            per output PLL source, MS/R divider and achieved error (ppb).
+*/
+typedef struct Si5351_PlanRequest_t_ {
+  uint32_t u32Freq;
+  uint32_t u32TolPPB;
+} Si5351_PlanRequest_t;
+
+typedef struct Si5351_PlanCLK_t_ {
+  bool                bEnable;
+  Si5351_CLK_MS_SRC_t tSrc;
+  Si5351_MS_t         tMS;
+  int32_t             i32ErrPPB;
+} Si5351_PlanCLK_t;
+
+typedef struct Si5351_Plan_t_ {
+  uint32_t         au32VCO[2];
+  Si5351_MS_t      atPLL[2];
+  Si5351_PlanCLK_t atCLK[SI5351_CLKNUM];
+  uint8_t          u8Integer;  /* outputs with even integer MS */
+} Si5351_Plan_t;
+
+
 /* Access */
 typedef uint8_t (*Si5351_Read_t)(void* pInstance, const uint8_t u8Reg);
 typedef void (*Si5351_Write_t)(void* pInstance, const uint8_t u8Reg, uint8_t u8Value);
+/* Block write from u8Reg with register auto-increment (optional) */
+typedef void (*Si5351_WriteBlock_t)(void* pInstance, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count);
+/* Block read from u8Reg with register auto-increment (optional) */
+typedef void (*Si5351_ReadBlock_t)(void* pInstance, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count);
 typedef void (*Si5351_MemoryBarrier_t)(void);
 
+/*
+  Lock policy
+  tLock blocks until the lock is held, tTryLock makes one attempt (NULL: tLock),
+  tUnlock releases. pContext is the lock object given to Si5351_SetLockPolicy
+  (mutex, RTOS semaphore handle ...). NULL functions do nothing.
+*/
+typedef void (*Si5351_LockFunc_t)(void* pContext);
+typedef bool (*Si5351_TryLockFunc_t)(void* pContext);
+
+typedef struct Si5351_LockPolicy_t_ {
+  Si5351_LockFunc_t    tLock;
+  Si5351_TryLockFunc_t tTryLock;
+  Si5351_LockFunc_t    tUnlock;
+} Si5351_LockPolicy_t;
+
+/* No lock, for single-threaded use */
+extern const Si5351_LockPolicy_t Si5351_LockPolicyNone;
+#if defined(SI5351_USE_PTHREAD_LOCK)
+/* pContext : pthread_mutex_t* */
+extern const Si5351_LockPolicy_t Si5351_LockPolicyPthread;
+#endif
+
+#if defined(SI5351_USE_ATOMIC_LOCK)
+/*
+  Bus arbiter (ticket lock)
+  One per I2C bus, shared by the instances of the chips on it through
+  Si5351_LockPolicyArbiter. Waiters get the bus in arrival order, so a busy
+  instance cannot starve the others. tWait is called while waiting (yield,
+  barrier ...), may be NULL.
+*/
+typedef struct Si5351_Arbiter_t_ {
+  volatile uint32_t u32Next;     /* next ticket */
+  volatile uint32_t u32Serving;  /* ticket owning the bus */
+  Si5351_MemoryBarrier_t tWait;
+} Si5351_Arbiter_t;
+
+bool Si5351_InitArbiter(Si5351_Arbiter_t* ptArbiter, const Si5351_MemoryBarrier_t tWait);
+/* pContext : Si5351_Arbiter_t* */
+extern const Si5351_LockPolicy_t Si5351_LockPolicyArbiter;
+#endif
+
+/*
+  Register Cache
+
+  Shadow image of the register map used for read-modify-write.
+  Registers are filled on first read (or all at once by Si5351_SyncCache)
+  and updated on every write, so later changes cost only bus writes.
+  Reg.0,1 (status) are never cached.
+  Call Si5351_InvalidateCache after the device was reset or power cycled.
+
+  Transaction (needs the cache)
+  Si5351_BeginTransaction takes the lock once and following setters only
+  stage their registers in the cache. Si5351_Commit writes the staged
+  registers in address order, merging contiguous runs into block writes,
+  and releases the lock. Other contexts wait for the lock, so they neither
+  stage into nor commit a transaction they did not open.
+
+  Write Elision (needs the cache)
+  When enabled, a register write whose value equals the cached device
+  value is not sent. Counters report issued and elided register writes.
+*/
+#define SI5351_REG_LAST 0xB7
+
+typedef struct Si5351_WriteStats_t_ {
+  uint32_t u32Issued;
+  uint32_t u32Elided;
+} Si5351_WriteStats_t;
+
+typedef struct Si5351_Cache_t_ {
+  uint8_t             au8Value[256];
+  uint8_t             au8Valid[256 / 8];
+  uint8_t             au8Dirty[256 / 8];
+  bool                bTransaction;
+  bool                bElide;
+  Si5351_WriteStats_t tWriteStats;
+} Si5351_Cache_t;
+
+/*
+  Operation Statistics (SI5351_USE_STATS)
+
+  Public functions are identified by Si5351_Api_t (values are stable, new
+  ones are added at the end). Per operation the attached Si5351_Stats_t
+  counts calls, bus transfers (tRead/tWrite/tReadBlock/tWriteBlock calls),
+  register bytes read and written, time waiting for the lock and total
+  time, in units of the tTimestamp callback (micros(), cycle counter ...).
+  A call made by another public function (the setters of Si5351_SetPlan)
+  is part of the outer call; Si5351_SetMS/Si5351_RetuneMS on CLK6/7 count
+  as the MS67 call doing the work. A transaction counts as one
+  SI5351_API_TRANSACTION call from Si5351_BeginTransaction to
+  Si5351_Commit/Si5351_AbortTransaction, the bus traffic of its setters
+  included. Without SI5351_USE_STATS only the Si5351_Api_t values remain.
+*/
+typedef enum Si5351_Api_t_ {
+  SI5351_API_NONE = 0,
+  SI5351_API_INITDEVICE,
+  SI5351_API_SYNCCACHE,
+  SI5351_API_TRANSACTION,
+  SI5351_API_READREGISTERS,
+  SI5351_API_WRITEREGISTERS,
+  SI5351_API_UPDATEREGISTER,
+  SI5351_API_SETREGISTERBITS,
+  SI5351_API_CLEARREGISTERBITS,
+  SI5351_API_TOGGLEREGISTERBITS,
+  SI5351_API_GETSTATUS,
+  SI5351_API_GETSTICKYSTATUS,
+  SI5351_API_SETSTICKYSTATUS,
+  SI5351_API_GETSTATUSMASK,
+  SI5351_API_SETSTATUSMASK,
+  SI5351_API_GETOUTPUTENABLE,
+  SI5351_API_SETOUTPUTENABLE,
+  SI5351_API_SETOUTPUTDISABLE,
+  SI5351_API_GETOUTPUTCONTROLMASK,
+  SI5351_API_SETOUTPUTCONTROLMASK,
+  SI5351_API_GETCLKIN_DIV,
+  SI5351_API_SETCLKIN_DIV,
+  SI5351_API_GETPLLA_SRC,
+  SI5351_API_SETPLLA_SRC,
+  SI5351_API_GETPLLB_SRC,
+  SI5351_API_SETPLLB_SRC,
+  SI5351_API_GETCLKPOWERDOWN,
+  SI5351_API_SETCLKPOWERDOWN,
+  SI5351_API_GETCLKMSSOURCE,
+  SI5351_API_SETCLKMSSOURCE,
+  SI5351_API_GETCLKINVERT,
+  SI5351_API_SETCLKINVERT,
+  SI5351_API_GETCLKSRC,
+  SI5351_API_SETCLKSRC,
+  SI5351_API_GETCLKIDRIVE,
+  SI5351_API_SETCLKIDRIVE,
+  SI5351_API_GETCLKDISABLESTATE,
+  SI5351_API_SETCLKDISABLESTATE,
+  SI5351_API_GETMSA,
+  SI5351_API_SETMSA,
+  SI5351_API_GETMSB,
+  SI5351_API_SETMSB,
+  SI5351_API_GETMS,
+  SI5351_API_SETMS,
+  SI5351_API_GETMS67,
+  SI5351_API_SETMS67,
+  SI5351_API_SETMS67DIVIDER,
+  SI5351_API_RETUNEMSA,
+  SI5351_API_RETUNEMSB,
+  SI5351_API_RETUNEMS,
+  SI5351_API_GETSSPENABLE,
+  SI5351_API_SETSSPENABLE,
+  SI5351_API_SETSSPDISABLE,
+  SI5351_API_GETSSP,
+  SI5351_API_SETSSP,
+  SI5351_API_GETVCXO,
+  SI5351_API_SETVCXO,
+  SI5351_API_GETPHASEOFFSET,
+  SI5351_API_SETPHASEOFFSET,
+  SI5351_API_PLLSOFTRESET,
+  SI5351_API_GETXTALLOADCAP,
+  SI5351_API_SETXTALLOADCAP,
+  SI5351_API_SETPLAN,
+  SI5351_API_COUNT
+} Si5351_Api_t;
+
+/* Free running time stamp, any unit, wraps at 2^32 */
+typedef uint32_t (*Si5351_Timestamp_t)(void);
+
+#if defined(SI5351_USE_STATS)
+typedef struct Si5351_OpStats_t_ {
+  uint32_t u32Calls;
+  uint32_t u32Transfers;
+  uint32_t u32ReadBytes;
+  uint32_t u32WriteBytes;
+  uint64_t u64LockWait;
+  uint64_t u64Time;
+  uint32_t u32TimeMax;
+} Si5351_OpStats_t;
+
+typedef struct Si5351_Stats_t_ {
+  Si5351_OpStats_t   atOp[SI5351_API_COUNT];
+  Si5351_Timestamp_t tTimestamp;
+  uint32_t           u32Start;      /* outermost call began */
+} Si5351_Stats_t;
+#endif
+
+/*
+  Register Access Trace (SI5351_USE_TRACE)
+
+  A flight recorder of the bus: every register byte read from or written
+  to the device (cache hits and elided writes never reach it) is recorded
+  with time stamp, direction and the public call (Si5351_Api_t) it belongs
+  to. The ring keeps the newest entries, its storage comes from the caller.
+  Recording takes one tTimestamp call per transfer and a few stores per
+  byte, no allocation and no lock, so it can stay on in production.
+  Several instances may share one trace (u8Device 0-15 tells them apart).
+
+  Si5351_SetTraceFreeze is safe in an interrupt handler, e.g. freeze on
+  the LOL interrupt to keep what led there. Entries are reserved with an
+  atomic add under SI5351_USE_ATOMIC_LOCK only: without it the contexts
+  recording into one trace (Si5351_MarkTrace included) must not preempt
+  each other, so an interrupt handler may freeze but not mark. Dump a
+  frozen trace: an entry being written while it is dumped may be incomplete.
+
+  Dump format (little endian), read by extras/host/trace_decode and trace_replay
+    header 20 bytes : "S5TR", version 1, entry size 8, 0, 0,
+                      u32TickNs, u32First (sequence of the first entry), u32Count
+    entry 8 bytes   : u32Time, u8Reg, u8Value, u8Api, u8Flags
+*/
+#define SI5351_TRACE_WRITE  0x01  /* else read */
+#define SI5351_TRACE_START  0x02  /* first byte of a bus transfer */
+#define SI5351_TRACE_MARK   0x04  /* Si5351_MarkTrace, u8Value : tag */
+#define SI5351_TRACE_DEVICE(u8Flags) ((uint8_t)((u8Flags) >> 4))
+
+#define SI5351_TRACE_VERSION    1
+#define SI5351_TRACE_HEADER     20
+#define SI5351_TRACE_ENTRY_SIZE 8
+
+#if defined(SI5351_USE_TRACE)
+typedef struct Si5351_TraceEntry_t_ {
+  uint32_t u32Time;
+  uint8_t  u8Reg;
+  uint8_t  u8Value;
+  uint8_t  u8Api;
+  uint8_t  u8Flags;
+} Si5351_TraceEntry_t;
+
+typedef struct Si5351_Trace_t_ {
+  Si5351_TraceEntry_t* ptEntry;
+  uint32_t             u32Mask;     /* entries - 1 */
+  volatile uint32_t    u32Head;     /* entries recorded since cleared */
+  volatile bool        bFrozen;
+  Si5351_Timestamp_t   tTimestamp;
+  uint32_t             u32TickNs;   /* time stamp unit, for the decoder */
+} Si5351_Trace_t;
+
+/* Dump sink (Serial.write, file ...) */
+typedef void (*Si5351_TraceOutput_t)(void* pContext, const uint8_t* pu8Data, const uint8_t u8Count);
+#endif
+
 /* Si5351 */
 typedef struct Si5351_t_ {
   void* pInstance;
   Si5351_Read_t tRead;
   Si5351_Write_t tWrite;
+  Si5351_ReadBlock_t tReadBlock;
+  Si5351_WriteBlock_t tWriteBlock;
   Si5351_MemoryBarrier_t tMemoryBarrier;
   void** ppLock;
+  const Si5351_LockPolicy_t* ptLockPolicy;
+  void* pLockContext;
+  Si5351_Cache_t* ptCache;
+  uint8_t u8LockDepth;  /* nesting while this instance owns *ppLock */
+#if defined(SI5351_CONTEXT_ID)
+  uintptr_t uOwner;     /* SI5351_CONTEXT_ID() of the holder */
+#endif
+#if defined(SI5351_USE_STATS) || defined(SI5351_USE_TRACE)
+  uint8_t u8Api;        /* public call running (Si5351_Api_t) */
+  uint8_t u8ApiDepth;   /* public call nesting */
+#endif
+#if defined(SI5351_USE_STATS)
+  Si5351_Stats_t* ptStats;
+#endif
+#if defined(SI5351_USE_TRACE)
+  Si5351_Trace_t* ptTrace;
+  uint8_t u8Device;
+#endif
 } Si5351_t;
 
-/* Initialize */
+/*
+  Initialize
+  ppLock : spin lock shared by the instances on one bus (NULL: Si5351_LockPolicyNone)
+*/
 bool Si5351_Initialize(
   Si5351_t* ptSi5351,
   void* pInstance,
@@ -325,8 +664,88 @@ bool Si5351_Initialize(
   const Si5351_MemoryBarrier_t tMemoryBarrier,
   void** ppLock
 );
+bool Si5351_SetReadBlock(Si5351_t* ptSi5351, const Si5351_ReadBlock_t tReadBlock);
+bool Si5351_SetWriteBlock(Si5351_t* ptSi5351, const Si5351_WriteBlock_t tWriteBlock);
+/* ptPolicy NULL: back to the spin lock on ppLock */
+bool Si5351_SetLockPolicy(Si5351_t* ptSi5351, const Si5351_LockPolicy_t* ptPolicy, void* pContext);
 bool Si5351_InitDevice(const Si5351_t* ptSi5351);
 
+/* Register Cache */
+bool Si5351_AttachCache(Si5351_t* ptSi5351, Si5351_Cache_t* ptCache);
+bool Si5351_InvalidateCache(const Si5351_t* ptSi5351);
+bool Si5351_SyncCache(const Si5351_t* ptSi5351);
+
+/* Write Elision */
+bool Si5351_SetWriteElision(const Si5351_t* ptSi5351, const bool bElide);
+bool Si5351_GetWriteStats(Si5351_WriteStats_t* ptWriteStats, const Si5351_t* ptSi5351);
+bool Si5351_ResetWriteStats(const Si5351_t* ptSi5351);
+
+#if defined(SI5351_USE_STATS)
+/* Operation Statistics (ptStats NULL: detach, tTimestamp NULL: no times) */
+bool Si5351_AttachStats(Si5351_t* ptSi5351, Si5351_Stats_t* ptStats, const Si5351_Timestamp_t tTimestamp);
+/* tApi SI5351_API_NONE: sum of all operations */
+bool Si5351_GetStats(Si5351_OpStats_t* ptOpStats, const Si5351_t* ptSi5351, const Si5351_Api_t tApi);
+bool Si5351_ResetStats(const Si5351_t* ptSi5351);
+#endif
+
+#if defined(SI5351_USE_TRACE)
+/* Register Access Trace (u16Size : entries, power of 2) */
+bool Si5351_InitTrace(
+  Si5351_Trace_t* ptTrace,
+  Si5351_TraceEntry_t* ptEntry,
+  const uint16_t u16Size,
+  const Si5351_Timestamp_t tTimestamp,
+  const uint32_t u32TickNs
+);
+/* ptTrace NULL: detach */
+bool Si5351_AttachTrace(Si5351_t* ptSi5351, Si5351_Trace_t* ptTrace, const uint8_t u8Device);
+bool Si5351_ClearTrace(Si5351_Trace_t* ptTrace);
+/* Interrupt safe */
+bool Si5351_SetTraceFreeze(Si5351_Trace_t* ptTrace, const bool bFreeze);
+/* Interrupt safe with SI5351_USE_ATOMIC_LOCK only */
+bool Si5351_MarkTrace(Si5351_Trace_t* ptTrace, const uint8_t u8Device, const uint8_t u8Tag);
+/* Header and the kept entries, oldest first */
+bool Si5351_DumpTrace(const Si5351_Trace_t* ptTrace, const Si5351_TraceOutput_t tOutput, void* pContext);
+#endif
+
+#if defined(SI5351_USE_STATS) || defined(SI5351_USE_TRACE)
+/* "Si5351_SetMS", NULL for an unknown value */
+const char* Si5351_GetApiName(const Si5351_Api_t tApi);
+#endif
+
+/* Transaction */
+bool Si5351_BeginTransaction(const Si5351_t* ptSi5351);
+bool Si5351_Commit(const Si5351_t* ptSi5351);
+bool Si5351_AbortTransaction(const Si5351_t* ptSi5351);
+
+/*
+  Lock
+  Held per instance and nests with the library's own locking, so several calls
+  can run under one lock. Ownership is the instance, not the caller: every
+  thread or ISR must use its own Si5351_t (the instances of one chip share
+  ppLock or the lock policy context), a second context on the same instance
+  counts as the owner and skips the lock. SI5351_CONTEXT_ID checks this in
+  debug builds. An ISR should use Si5351_TryLock or Si5351_LockWait
+  (u32Tries attempts with exponential backoff) and skip the access on false,
+  instead of waiting on a holder it preempted. A lock policy without tTryLock
+  always blocks.
+*/
+bool Si5351_TryLock(const Si5351_t* ptSi5351);
+bool Si5351_LockWait(const Si5351_t* ptSi5351, const uint32_t u32Tries);
+bool Si5351_Unlock(const Si5351_t* ptSi5351);
+
+/* Register Access */
+bool Si5351_ReadRegisters(uint8_t* pu8Value, const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Count);
+bool Si5351_WriteRegisters(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count);
+/*
+  Read-modify-write under one lock hold (the read comes from the cache when attached).
+  UpdateRegister replaces the u8Mask bits with u8Value.
+*/
+bool Si5351_UpdateRegister(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Mask, const uint8_t u8Value);
+bool Si5351_SetRegisterBits(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Bits);
+bool Si5351_ClearRegisterBits(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Bits);
+bool Si5351_ToggleRegisterBits(const Si5351_t* ptSi5351, const uint8_t u8Reg, const uint8_t u8Bits);
+
 /* Status */
 bool Si5351_GetStatus(Si5351_Status_t* ptStatus, const Si5351_t* ptSi5351);
 bool Si5351_GetStickyStatus(Si5351_Status_t* ptStatus, const Si5351_t* ptSi5351);
@@ -386,6 +805,17 @@ bool Si5351_GetMSB(Si5351_MS_t* ptMS, const Si5351_t* ptSi5351);
 bool Si5351_SetMSB(const Si5351_t* ptSi5351, const Si5351_MS_t* ptMS);
 bool Si5351_GetMS(Si5351_MS_t* ptMS, const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo);
 bool Si5351_SetMS(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS);
+#if SI5351_CLKNUM > 3
+/* MS6/MS7 : integer divider (even 6 - 254) and R6/R7 */
+bool Si5351_GetMS67(uint8_t* pu8MS, Si5351_MS_DIV_t* ptDIV, const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo);
+bool Si5351_SetMS67(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, const uint8_t u8MS, const Si5351_MS_DIV_t tDIV);
+bool Si5351_SetMS67Divider(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, const uint8_t u8MS);
+#endif
+
+/* Frequency hop (writes only registers changed from ptLastMS) */
+bool Si5351_RetuneMSA(const Si5351_t* ptSi5351, const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS);
+bool Si5351_RetuneMSB(const Si5351_t* ptSi5351, const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS);
+bool Si5351_RetuneMS(const Si5351_t* ptSi5351, const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS);
 
 /* Spread Spectrum Parameters */
 bool Si5351_GetSSPEnable(bool* pbEnable, const Si5351_t* ptSi5351);
@@ -414,10 +844,38 @@ bool Si5351_GetXTALLoadCap(Si5351_XTALLoadCap_t* ptXTALLoadCap, const Si5351_t*
 bool Si5351_SetXTALLoadCap(const Si5351_t* ptSi5351, const Si5351_XTALLoadCap_t tXTALLoadCap);
 
 /* Utility */
-#if defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
+/* a+b/c closest to u64Num/u64Den with c <= 0xFFFFF, *pi32ErrPPB = (a+b/c) error in ppb */
+bool Si5351_CalcMSRatio(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint64_t u64Num, const uint64_t u64Den, const uint32_t u32PPB);
+#if SI5351_CLKNUM > 3
+/* MS6/MS7 divider and R for u32Output from u32VCO (Hz) */
+bool Si5351_CalcMS67(uint8_t* pu8MS, Si5351_MS_DIV_t* ptDIV, int32_t* pi32ErrPPB, const uint32_t u32VCO, const uint32_t u32Output);
+#endif
+
+#if defined(SI5351_USE_INTEGER_MATH)
+bool Si5351_CalcMSPLL(Si5351_MS_t* ptMS, const uint32_t u32BaseClock, const uint32_t u32Output);
+bool Si5351_CalcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint32_t u32BaseClock, const uint32_t u32Output, const uint32_t u32PPB);
+bool Si5351_DecalcMSPLL(uint32_t* pu32Output, const uint32_t u32BaseClock, const Si5351_MS_t* ptMS);
+bool Si5351_CalcMSClk(Si5351_MS_t* ptMS, const uint32_t u32BaseClock, const uint32_t u32Output);
+bool Si5351_CalcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint32_t u32BaseClock, const uint32_t u32Output, const uint32_t u32PPB);
+bool Si5351_DecalcMSClk(uint32_t* pu32Output, const uint32_t u32BaseClock, const Si5351_MS_t* ptMS);
+
+bool Si5351_CalcSSP(
+  Si5351_SSP_t* ptSSP,
+  const Si5351_SSP_Mode_t tSSC_MODE,
+  const uint32_t u32Freq_PFD,
+  const Si5351_MS_t* ptMS,
+  const uint16_t u16SscAmp
+);
+
+#if SI5351_TYPE == 1
+bool Si5351_CalcVCXO(uint32_t* pu32VCXO, const Si5351_MS_t* ptMS, const uint8_t u8APR);
+#endif
+#elif defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
 bool Si5351_CalcMSPLL(Si5351_MS_t* ptMS, const float64_t f64BaseClock, float64_t f64Output);
+bool Si5351_CalcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const float64_t f64BaseClock, const float64_t f64Output, const uint32_t u32PPB);
 bool Si5351_DecalcMSPLL(float64_t* pf64Output, const float64_t f64BaseClock, const Si5351_MS_t* ptMS);
 bool Si5351_CalcMSClk(Si5351_MS_t* ptMS, const float64_t f64BaseClock, const float64_t f64Output);
+bool Si5351_CalcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const float64_t f64BaseClock, const float64_t f64Output, const uint32_t u32PPB);
 bool Si5351_DecalcMSClk(float64_t* pf64Output, const float64_t f64BaseClock, const Si5351_MS_t* ptMS);
 
 bool Si5351_CalcSSP(
@@ -433,8 +891,10 @@ bool Si5351_CalcVCXO(uint32_t* pu32VCXO, const float64_t f64Ratio, const uint8_t
 #endif
 #else  /* SI5351_USE_BERKELEY_SOFTFLOAT_3 */
 bool Si5351_CalcMSPLL(Si5351_MS_t* ptMS, const double dBaseClock, const double dOutput);
+bool Si5351_CalcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const double dBaseClock, const double dOutput, const uint32_t u32PPB);
 bool Si5351_DecalcMSPLL(double* pdOutput, const double dBaseClock, const Si5351_MS_t* ptMS);
 bool Si5351_CalcMSClk(Si5351_MS_t* ptMS, const double dBaseClock, const double dOutput);
+bool Si5351_CalcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const double dBaseClock, const double dOutput, const uint32_t u32PPB);
 bool Si5351_DecalcMSClk(double* pdOutput, const double dBaseClock, const Si5351_MS_t* ptMS);
 
 bool Si5351_CalcSSP(
@@ -450,6 +910,16 @@ bool Si5351_CalcVCXO(uint32_t* pu32VCXO, const double dRatio, const uint8_t u8AP
 #endif
 #endif  /* SI5351_USE_BERKELEY_SOFTFLOAT_3 */
 
+/* Frequency Plan (ptRequest[SI5351_CLKNUM], u32BaseClock: PLL input Hz) */
+bool Si5351_CalcPlan(Si5351_Plan_t* ptPlan, const uint32_t u32BaseClock, const Si5351_PlanRequest_t* ptRequest);
+/*
+  Outputs off, dividers and PLL reset, outputs on, each step on the device
+  before the next. Inside an open transaction it commits that transaction
+  at every step (what was staged before goes out with the first step) and
+  leaves a new, empty one open; on failure the transaction is aborted.
+*/
+bool Si5351_SetPlan(const Si5351_t* ptSi5351, const Si5351_Plan_t* ptPlan);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,749 @@
+/* Si5351 asynchronous command queue by AZO */
+
+#include "si5351_async.h"
+
+#if defined(SI5351_USE_ASYNC)
+
+#include <chrono>
+
+#if (SI5351_ASYNC_QUEUE_SIZE & (SI5351_ASYNC_QUEUE_SIZE - 1)) || SI5351_ASYNC_QUEUE_SIZE < 2
+#error SI5351_ASYNC_QUEUE_SIZE must be a power of 2
+#endif
+
+#define SI5351_ASYNC_MASK (SI5351_ASYNC_QUEUE_SIZE - 1)
+
+/* Idle wait of the worker, also bounds a missed wake-up */
+#define SI5351_ASYNC_IDLE_MS 10
+
+/* Service order of the classes */
+static const uint8_t g_au8Order[SI5351_ASYNC_PRIORITIES] = {
+  SI5351_ASYNC_URGENT, SI5351_ASYNC_NORMAL, SI5351_ASYNC_BULK
+};
+
+Si5351_Async::Si5351_Async(Si5351_I2C& roSi5351) : roSi5351(roSi5351), poBus(NULL) {
+  uint32_t u32Index;
+  uint8_t u8Priority;
+
+  for(u8Priority = 0; u8Priority < SI5351_ASYNC_PRIORITIES; u8Priority++) {
+    for(u32Index = 0; u32Index < SI5351_ASYNC_QUEUE_SIZE; u32Index++) {
+      this->aatSlot[u8Priority][u32Index].u32Seq.store(u32Index, std::memory_order_relaxed);
+    }
+    this->au32Enqueue[u8Priority].store(0, std::memory_order_relaxed);
+    this->au32Dequeue[u8Priority] = 0;
+    this->abStep[u8Priority] = false;
+  }
+  this->u8Chunk.store(SI5351_ASYNC_CHUNK);
+  this->bRun.store(false);
+  this->u32Pushing.store(0);
+  this->bSleeping.store(false);
+  for(u32Index = 0; u32Index < SI5351_CLKNUM; u32Index++) {
+    this->abLastMS[u32Index] = false;
+  }
+  this->abLastPLL[0] = false;
+  this->abLastPLL[1] = false;
+  this->resetStats();
+}
+
+Si5351_Async::~Si5351_Async() {
+  this->stop();
+}
+
+bool Si5351_Async::start(void) {
+  bool bValid = false;
+
+  if(!this->poBus && !this->oWorker.joinable()) {
+    bValid = true;
+    this->bRun.store(true);
+    this->oWorker = std::thread(&Si5351_Async::run, this);
+  }
+
+  return bValid;
+}
+
+bool Si5351_Async::stop(void) {
+  bool bValid = false;
+
+  if(this->oWorker.joinable()) {
+    bValid = true;
+    {
+      std::lock_guard<std::mutex> oGuard(this->oMutex);
+      this->bRun.store(false);
+      this->bSleeping.store(false);
+    }
+    this->oWake.notify_one();
+    this->oWorker.join();
+  }
+
+  return bValid;
+}
+
+bool Si5351_Async::post(const Si5351_AsyncCommand_t* ptCommand, Si5351_AsyncDone_t tDone, void* pUser) {
+  bool bValid = false;
+  Entry_t tEntry;
+
+  if(ptCommand) {
+    tEntry.tCommand = *ptCommand;
+    tEntry.tDone = tDone;
+    tEntry.pUser = pUser;
+    tEntry.poPromise = NULL;
+    bValid = this->push(&tEntry);
+  }
+
+  return bValid;
+}
+
+std::future<bool> Si5351_Async::submit(const Si5351_AsyncCommand_t* ptCommand) {
+  std::future<bool> oFuture;
+  Entry_t tEntry;
+
+  if(ptCommand) {
+    tEntry.tCommand = *ptCommand;
+    tEntry.tDone = NULL;
+    tEntry.pUser = NULL;
+    tEntry.poPromise = new std::promise<bool>();
+    oFuture = tEntry.poPromise->get_future();
+    if(!this->push(&tEntry)) {
+      delete tEntry.poPromise;
+      oFuture = std::future<bool>();
+    }
+  }
+
+  return oFuture;
+}
+
+bool Si5351_Async::getStats(Si5351_AsyncStats_t* ptStats) const {
+  bool bValid = false;
+  uint8_t u8Priority;
+
+  if(ptStats) {
+    bValid = true;
+    ptStats->u32Posted    = this->u32Posted.load(std::memory_order_relaxed);
+    ptStats->u32Rejected  = this->u32Rejected.load(std::memory_order_relaxed);
+    ptStats->u32Executed  = this->u32Executed.load(std::memory_order_relaxed);
+    ptStats->u32Coalesced = this->u32Coalesced.load(std::memory_order_relaxed);
+    ptStats->u32Passes    = this->u32Passes.load(std::memory_order_relaxed);
+    ptStats->u32Steps     = this->u32Steps.load(std::memory_order_relaxed);
+    for(u8Priority = 0; u8Priority < SI5351_ASYNC_PRIORITIES; u8Priority++) {
+      ptStats->atLatency[u8Priority].u32Count   = this->atLatency[u8Priority].u32Count.load(std::memory_order_relaxed);
+      ptStats->atLatency[u8Priority].u32WorstUs = this->atLatency[u8Priority].u32WorstUs.load(std::memory_order_relaxed);
+      ptStats->atLatency[u8Priority].u64TotalUs = this->atLatency[u8Priority].u64TotalUs.load(std::memory_order_relaxed);
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_Async::resetStats(void) {
+  uint8_t u8Priority;
+
+  this->u32Posted.store(0);
+  this->u32Rejected.store(0);
+  this->u32Executed.store(0);
+  this->u32Coalesced.store(0);
+  this->u32Passes.store(0);
+  this->u32Steps.store(0);
+  for(u8Priority = 0; u8Priority < SI5351_ASYNC_PRIORITIES; u8Priority++) {
+    this->atLatency[u8Priority].u32Count.store(0);
+    this->atLatency[u8Priority].u32WorstUs.store(0);
+    this->atLatency[u8Priority].u64TotalUs.store(0);
+  }
+
+  return true;
+}
+
+bool Si5351_Async::setChunk(const uint8_t u8Registers) {
+  this->u8Chunk.store(u8Registers);
+
+  return true;
+}
+
+/*
+  Bounded MPSC ring (per-slot sequence numbers)
+  Slot i is free for position p when u32Seq == p, filled when u32Seq == p + 1.
+  Producers claim a position with a CAS on the enqueue index, no lock is taken.
+  u32Pushing covers a producer from its bRun check until the entry is published,
+  so a stopping worker does not leave before an accepted entry is in the ring.
+*/
+bool Si5351_Async::push(Entry_t* ptEntry) {
+  bool bValid = false;
+  bool bFull = false;
+  uint8_t u8Priority = (uint8_t)ptEntry->tCommand.tPriority;
+  Slot_t* ptSlot = NULL;
+  uint32_t u32Pos = 0;
+  int32_t i32Diff;
+
+  this->u32Pushing.fetch_add(1);
+  if(this->bRun.load() && u8Priority < SI5351_ASYNC_PRIORITIES) {
+    u32Pos = this->au32Enqueue[u8Priority].load(std::memory_order_relaxed);
+    while(!bValid && !bFull) {
+      ptSlot = &this->aatSlot[u8Priority][u32Pos & SI5351_ASYNC_MASK];
+      i32Diff = (int32_t)(ptSlot->u32Seq.load(std::memory_order_acquire) - u32Pos);
+      if(i32Diff == 0) {
+        if(this->au32Enqueue[u8Priority].compare_exchange_weak(u32Pos, u32Pos + 1, std::memory_order_relaxed)) {
+          bValid = true;
+        }
+      } else if(i32Diff < 0) {
+        bFull = true;
+      } else {
+        u32Pos = this->au32Enqueue[u8Priority].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  if(bValid) {
+    ptEntry->u64PostedUs = nowUs();
+    ptSlot->tEntry = *ptEntry;
+    ptSlot->u32Seq.store(u32Pos + 1, std::memory_order_release);
+    this->u32Pushing.fetch_sub(1, std::memory_order_release);
+    this->u32Posted.fetch_add(1, std::memory_order_relaxed);
+    if(this->poBus) {
+      this->poBus->wake();
+    } else {
+      this->wake();
+    }
+  } else {
+    this->u32Pushing.fetch_sub(1, std::memory_order_release);
+    this->u32Rejected.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  return bValid;
+}
+
+bool Si5351_Async::pop(Entry_t* ptEntry, const uint8_t u8Priority) {
+  bool bValid = false;
+  uint32_t u32Pos = this->au32Dequeue[u8Priority];
+  Slot_t* ptSlot = &this->aatSlot[u8Priority][u32Pos & SI5351_ASYNC_MASK];
+
+  if(ptSlot->u32Seq.load(std::memory_order_acquire) == u32Pos + 1) {
+    bValid = true;
+    *ptEntry = ptSlot->tEntry;
+    ptSlot->u32Seq.store(u32Pos + SI5351_ASYNC_QUEUE_SIZE, std::memory_order_release);
+    this->au32Dequeue[u8Priority]++;
+  }
+
+  return bValid;
+}
+
+bool Si5351_Async::isEmpty(void) const {
+  bool bValid = true;
+  uint8_t u8Priority;
+  uint32_t u32Pos;
+
+  for(u8Priority = 0; u8Priority < SI5351_ASYNC_PRIORITIES; u8Priority++) {
+    u32Pos = this->au32Dequeue[u8Priority];
+    if(this->aatSlot[u8Priority][u32Pos & SI5351_ASYNC_MASK].u32Seq.load(std::memory_order_acquire) == u32Pos + 1) {
+      bValid = false;
+    }
+  }
+
+  return bValid;
+}
+
+/* Stopped and nothing left: no producer past its bRun check, rings empty */
+bool Si5351_Async::isDrained(void) const {
+  return (!this->u32Pushing.load(std::memory_order_acquire) && this->isEmpty()) ? true : false;
+}
+
+uint64_t Si5351_Async::nowUs(void) {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()
+  ).count();
+}
+
+/* Multi-register fields are not split: MSNA/MSNB/MS0-5 parameters (26-89), SSP (149-161), VCXO (162-164) */
+bool Si5351_Async::isSafeSplit(const uint16_t u16Reg) {
+  bool bValid = true;
+
+  if(u16Reg > 26 && u16Reg < 90) {
+    bValid = ((u16Reg - 26) % 8 == 0) ? true : false;
+  } else if(u16Reg > 149 && u16Reg < 162) {
+    bValid = false;
+  } else if(u16Reg > 162 && u16Reg < 165) {
+    bValid = false;
+  }
+
+  return bValid;
+}
+
+/* Wake only an idle worker, the mutex orders this against its wait */
+void Si5351_Async::wake(void) {
+  if(this->bSleeping.exchange(false)) {
+    std::lock_guard<std::mutex> oGuard(this->oMutex);
+    this->oWake.notify_one();
+  }
+}
+
+/* Worker */
+void Si5351_Async::run(void) {
+  for(;;) {
+    if(this->dispatch()) {
+      continue;
+    } else if(!this->bRun.load()) {
+      if(this->isDrained()) {
+        break;
+      }
+      std::this_thread::yield();
+    } else {
+      this->bSleeping.store(true);
+      if(this->isEmpty()) {
+        std::unique_lock<std::mutex> oLock(this->oMutex);
+        this->oWake.wait_for(
+          oLock, std::chrono::milliseconds(SI5351_ASYNC_IDLE_MS),
+          [this] { return !this->bSleeping.load(); }
+        );
+      }
+      this->bSleeping.store(false);
+    }
+  }
+}
+
+/*
+  One unit of work for the highest class that has some: the next step of its
+  WRITE_REGISTERS, or a pass over its queue. A pass stops at WRITE_REGISTERS,
+  which then runs in steps so that higher classes can go in between.
+*/
+bool Si5351_Async::dispatch(void) {
+  bool bValid = false;
+  Entry_t atBatch[SI5351_ASYNC_BATCH];
+  uint8_t u8Order;
+  uint8_t u8Priority;
+  uint8_t u8Count;
+
+  for(u8Order = 0; !bValid && u8Order < SI5351_ASYNC_PRIORITIES; u8Order++) {
+    u8Priority = g_au8Order[u8Order];
+    if(this->abStep[u8Priority]) {
+      bValid = this->runStep(u8Priority);
+    } else {
+      u8Count = 0;
+      while(u8Count < SI5351_ASYNC_BATCH && this->pop(&atBatch[u8Count], u8Priority)) {
+        if(atBatch[u8Count].tCommand.tType == SI5351_ASYNC_WRITE_REGISTERS) {
+          this->atStep[u8Priority] = atBatch[u8Count];
+          this->abStep[u8Priority] = true;
+          this->abStepResult[u8Priority] = true;
+          this->au8StepDone[u8Priority] = 0;
+          break;
+        }
+        u8Count++;
+      }
+      if(u8Count) {
+        bValid = true;
+        this->runBatch(atBatch, u8Count);
+      } else if(this->abStep[u8Priority]) {
+        bValid = this->runStep(u8Priority);
+      }
+    }
+  }
+
+  return bValid;
+}
+
+/* Next step of the class's WRITE_REGISTERS, ending on a safe register boundary */
+bool Si5351_Async::runStep(const uint8_t u8Priority) {
+  Entry_t* ptEntry = &this->atStep[u8Priority];
+  uint8_t u8Done = this->au8StepDone[u8Priority];
+  uint8_t u8Left = ptEntry->tCommand.u8Count - u8Done;
+  uint16_t u16Reg = (uint16_t)ptEntry->tCommand.u8Reg + u8Done;
+  uint8_t u8Chunk = this->u8Chunk.load(std::memory_order_relaxed);
+  uint8_t u8Step = u8Left;
+
+  if(u8Done == 0) {
+    this->measure(ptEntry);
+  }
+  if(u8Chunk && u8Step > u8Chunk) {
+    u8Step = u8Chunk;
+    while(u8Step > 0 && !isSafeSplit(u16Reg + u8Step)) {
+      u8Step--;
+    }
+    if(u8Step == 0) {
+      u8Step = u8Chunk;
+      while(u8Step < u8Left && !isSafeSplit(u16Reg + u8Step)) {
+        u8Step++;
+      }
+    }
+  }
+
+  if(!ptEntry->tCommand.pu8Data || !this->roSi5351.writeRegisters((uint8_t)u16Reg, &ptEntry->tCommand.pu8Data[u8Done], u8Step)) {
+    this->abStepResult[u8Priority] = false;
+  }
+  this->forgetDividers(u16Reg, u8Step);
+  this->au8StepDone[u8Priority] = u8Done + u8Step;
+  this->u32Steps.fetch_add(1, std::memory_order_relaxed);
+
+  if(!ptEntry->tCommand.pu8Data || this->au8StepDone[u8Priority] >= ptEntry->tCommand.u8Count) {
+    this->abStep[u8Priority] = false;
+    this->u32Executed.fetch_add(1, std::memory_order_relaxed);
+    this->complete(ptEntry, this->abStepResult[u8Priority]);
+  }
+
+  return true;
+}
+
+void Si5351_Async::complete(Entry_t* ptEntry, const bool bResult) {
+  if(ptEntry->tDone) {
+    ptEntry->tDone(ptEntry->pUser, bResult);
+  }
+  if(ptEntry->poPromise) {
+    ptEntry->poPromise->set_value(bResult);
+    delete ptEntry->poPromise;
+    ptEntry->poPromise = NULL;
+  }
+}
+
+void Si5351_Async::measure(const Entry_t* ptEntry) {
+  Latency_t* ptLatency = &this->atLatency[ptEntry->tCommand.tPriority];
+  uint64_t u64Us = nowUs() - ptEntry->u64PostedUs;
+  uint32_t u32Us = (u64Us > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)u64Us;
+
+  ptLatency->u32Count.fetch_add(1, std::memory_order_relaxed);
+  ptLatency->u64TotalUs.fetch_add(u64Us, std::memory_order_relaxed);
+  if(u32Us > ptLatency->u32WorstUs.load(std::memory_order_relaxed)) {
+    ptLatency->u32WorstUs.store(u32Us, std::memory_order_relaxed);
+  }
+}
+
+/*
+  One pass: drop replaced commands, merge Reg.3 runs, run the rest in one
+  transaction (when a cache is attached), then complete everything.
+*/
+void Si5351_Async::runBatch(Entry_t* ptBatch, const uint8_t u8Count) {
+  int16_t ai16Replaced[SI5351_ASYNC_BATCH];
+  bool abResult[SI5351_ASYNC_BATCH];
+  uint8_t u8Index;
+  uint8_t u8Later;
+  uint8_t u8Last;
+  uint32_t u32Coalesced = 0;
+  uint32_t u32Executed = 0;
+
+  for(u8Index = 0; u8Index < u8Count; u8Index++) {
+    this->measure(&ptBatch[u8Index]);
+    ai16Replaced[u8Index] = -1;
+    for(u8Later = u8Index + 1; u8Later < u8Count; u8Later++) {
+      if(isReplacedBy(&ptBatch[u8Index].tCommand, &ptBatch[u8Later].tCommand)) {
+        ai16Replaced[u8Index] = u8Later;
+        break;
+      }
+    }
+  }
+
+  {
+    Si5351_I2C_Transaction oTransaction(this->roSi5351);
+
+    for(u8Index = 0; u8Index < u8Count; u8Index++) {
+      if(ai16Replaced[u8Index] >= 0) {
+        u32Coalesced++;
+      } else if(isOutputEnable(&ptBatch[u8Index].tCommand)) {
+        u8Last = u8Index;
+        while(u8Last + 1 < u8Count && isOutputEnable(&ptBatch[u8Last + 1].tCommand)) {
+          u8Last++;
+        }
+        abResult[u8Index] = this->executeOutputEnable(ptBatch, u8Index, u8Last);
+        u32Executed++;
+        for(u8Later = u8Index + 1; u8Later <= u8Last; u8Later++) {
+          ai16Replaced[u8Later] = u8Index;
+          u32Coalesced++;
+        }
+        u8Index = u8Last;
+      } else {
+        abResult[u8Index] = this->execute(&ptBatch[u8Index].tCommand);
+        u32Executed++;
+      }
+    }
+
+    oTransaction.commit();
+  }
+
+  /* replaced by a later command (higher index) or merged into an earlier one */
+  for(u8Index = u8Count; u8Index-- > 0;) {
+    if(ai16Replaced[u8Index] > u8Index) {
+      abResult[u8Index] = abResult[ai16Replaced[u8Index]];
+    }
+  }
+  for(u8Index = 0; u8Index < u8Count; u8Index++) {
+    if(ai16Replaced[u8Index] >= 0 && ai16Replaced[u8Index] < u8Index) {
+      abResult[u8Index] = abResult[ai16Replaced[u8Index]];
+    }
+  }
+
+  for(u8Index = 0; u8Index < u8Count; u8Index++) {
+    this->complete(&ptBatch[u8Index], abResult[u8Index]);
+  }
+
+  this->u32Executed.fetch_add(u32Executed, std::memory_order_relaxed);
+  this->u32Coalesced.fetch_add(u32Coalesced, std::memory_order_relaxed);
+  this->u32Passes.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool Si5351_Async::execute(const Si5351_AsyncCommand_t* ptCommand) {
+  bool bValid = false;
+  Si5351_MS_t tMS;
+  uint8_t u8PLL;
+
+  switch(ptCommand->tType) {
+  case SI5351_ASYNC_FREQUENCY:
+#if defined(SI5351_USE_INTEGER_MATH)
+    bValid = Si5351_I2C::calcMSClk(&tMS, ptCommand->u32VCO, ptCommand->u32Freq);
+#elif defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
+    bValid = Si5351_I2C::calcMSClk(&tMS, ui32_to_f64(ptCommand->u32VCO), ui32_to_f64(ptCommand->u32Freq));
+#else
+    bValid = Si5351_I2C::calcMSClk(&tMS, (double)ptCommand->u32VCO, (double)ptCommand->u32Freq);
+#endif
+    if(bValid) {
+      bValid = this->executeMS(ptCommand->tCLKNo, &tMS);
+    }
+    break;
+  case SI5351_ASYNC_MS:
+    bValid = this->executeMS(ptCommand->tCLKNo, &ptCommand->tMS);
+    break;
+  case SI5351_ASYNC_MSA:
+  case SI5351_ASYNC_MSB:
+    u8PLL = (ptCommand->tType == SI5351_ASYNC_MSA) ? 0 : 1;
+    if(this->abLastPLL[u8PLL]) {
+      bValid = u8PLL ?
+        this->roSi5351.retuneMSB(&ptCommand->tMS, &this->atLastPLL[u8PLL]) :
+        this->roSi5351.retuneMSA(&ptCommand->tMS, &this->atLastPLL[u8PLL]);
+    } else {
+      bValid = u8PLL ? this->roSi5351.setMSB(&ptCommand->tMS) : this->roSi5351.setMSA(&ptCommand->tMS);
+    }
+    this->abLastPLL[u8PLL] = bValid;
+    if(bValid) {
+      this->atLastPLL[u8PLL] = ptCommand->tMS;
+    }
+    break;
+  case SI5351_ASYNC_PHASE_OFFSET:
+    bValid = this->roSi5351.setPhaseOffset(ptCommand->tCLKNo, ptCommand->u8Value);
+    break;
+  case SI5351_ASYNC_UPDATE_REGISTER:
+    bValid = this->roSi5351.updateRegister(ptCommand->u8Reg, ptCommand->u8Mask, ptCommand->u8Value);
+    this->forgetDividers(ptCommand->u8Reg, 1);
+    break;
+  case SI5351_ASYNC_PLL_SOFT_RESET:
+    bValid = this->roSi5351.PLLSoftReset();
+    break;
+  default:
+    break;
+  }
+
+  return bValid;
+}
+
+/* Frequency hop from the last programmed divider when known */
+bool Si5351_Async::executeMS(const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS) {
+  bool bValid = false;
+
+  if(tCLKNo < SI5351_CLKNUM) {
+    if(this->abLastMS[tCLKNo]) {
+      bValid = this->roSi5351.retuneMS(tCLKNo, ptMS, &this->atLastMS[tCLKNo]);
+    } else {
+      bValid = this->roSi5351.setMS(tCLKNo, ptMS);
+    }
+    this->abLastMS[tCLKNo] = bValid;
+    if(bValid) {
+      this->atLastMS[tCLKNo] = *ptMS;
+    }
+  }
+
+  return bValid;
+}
+
+/*
+  Raw writes to Reg.26-41 (MSNA/MSNB), Reg.42-89 (MS0-5) or Reg.90-92 (MS6/MS7)
+  leave the last programmed divider unknown, the next hop writes it in full
+*/
+void Si5351_Async::forgetDividers(const uint16_t u16Reg, const uint8_t u8Count) {
+  uint16_t u16Index;
+  uint16_t u16CLKNo;
+
+  for(u16Index = u16Reg; u16Index < u16Reg + u8Count; u16Index++) {
+    if(u16Index >= 26 && u16Index < 42) {
+      this->abLastPLL[(u16Index - 26) / 8] = false;
+    } else if(u16Index >= 42 && u16Index < 92) {
+      u16CLKNo = (u16Index < 90) ? (uint16_t)((u16Index - 42) / 8) : (uint16_t)(u16Index - 84);
+      if(u16CLKNo < SI5351_CLKNUM) {
+        this->abLastMS[u16CLKNo] = false;
+      }
+    } else if(u16Index == 92) {
+      for(u16CLKNo = 6; u16CLKNo < SI5351_CLKNUM; u16CLKNo++) {
+        this->abLastMS[u16CLKNo] = false;
+      }
+    }
+  }
+}
+
+/* Net effect of an enable/disable run as one Reg.3 update (1 = disabled) */
+bool Si5351_Async::executeOutputEnable(const Entry_t* ptBatch, const uint8_t u8First, const uint8_t u8Last) {
+  uint8_t u8Index;
+  uint8_t u8Mask = 0;
+  uint8_t u8Disable = 0;
+
+  for(u8Index = u8First; u8Index <= u8Last; u8Index++) {
+    u8Mask |= ptBatch[u8Index].tCommand.u8Mask;
+    if(ptBatch[u8Index].tCommand.tType == SI5351_ASYNC_OUTPUT_DISABLE) {
+      u8Disable |= ptBatch[u8Index].tCommand.u8Mask;
+    } else {
+      u8Disable &= ~ptBatch[u8Index].tCommand.u8Mask;
+    }
+  }
+#if SI5351_CLKNUM <= 3
+  u8Mask &= 0x7;
+#endif
+
+  return this->roSi5351.updateRegister(0x03, u8Mask, u8Disable);
+}
+
+bool Si5351_Async::isOutputEnable(const Si5351_AsyncCommand_t* ptCommand) {
+  return (ptCommand->tType == SI5351_ASYNC_OUTPUT_ENABLE || ptCommand->tType == SI5351_ASYNC_OUTPUT_DISABLE) ? true : false;
+}
+
+bool Si5351_Async::isReplacedBy(const Si5351_AsyncCommand_t* ptCommand, const Si5351_AsyncCommand_t* ptLater) {
+  bool bValid = false;
+
+  switch(ptCommand->tType) {
+  case SI5351_ASYNC_FREQUENCY:
+  case SI5351_ASYNC_MS:
+    bValid = ((ptLater->tType == SI5351_ASYNC_FREQUENCY || ptLater->tType == SI5351_ASYNC_MS) && ptLater->tCLKNo == ptCommand->tCLKNo) ? true : false;
+    break;
+  case SI5351_ASYNC_MSA:
+  case SI5351_ASYNC_MSB:
+    bValid = (ptLater->tType == ptCommand->tType) ? true : false;
+    break;
+  case SI5351_ASYNC_PHASE_OFFSET:
+    bValid = (ptLater->tType == SI5351_ASYNC_PHASE_OFFSET && ptLater->tCLKNo == ptCommand->tCLKNo) ? true : false;
+    break;
+  default:
+    break;
+  }
+
+  return bValid;
+}
+
+/* Bus worker */
+Si5351_AsyncBus::Si5351_AsyncBus() {
+  this->u8Devices = 0;
+  this->bRun.store(false);
+  this->bSleeping.store(false);
+}
+
+Si5351_AsyncBus::~Si5351_AsyncBus() {
+  this->stop();
+}
+
+bool Si5351_AsyncBus::attach(Si5351_Async& roAsync) {
+  bool bValid = false;
+
+  if(
+    !this->oWorker.joinable() && this->u8Devices < SI5351_ASYNC_DEVICES &&
+    !roAsync.poBus && !roAsync.oWorker.joinable()
+  ) {
+    bValid = true;
+    roAsync.poBus = this;
+    this->apoAsync[this->u8Devices++] = &roAsync;
+  }
+
+  return bValid;
+}
+
+bool Si5351_AsyncBus::start(void) {
+  bool bValid = false;
+  uint8_t u8Index;
+
+  if(!this->oWorker.joinable()) {
+    bValid = true;
+    this->bRun.store(true);
+    for(u8Index = 0; u8Index < this->u8Devices; u8Index++) {
+      this->apoAsync[u8Index]->bRun.store(true);
+    }
+    this->oWorker = std::thread(&Si5351_AsyncBus::run, this);
+  }
+
+  return bValid;
+}
+
+bool Si5351_AsyncBus::stop(void) {
+  bool bValid = false;
+  uint8_t u8Index;
+
+  if(this->oWorker.joinable()) {
+    bValid = true;
+    for(u8Index = 0; u8Index < this->u8Devices; u8Index++) {
+      this->apoAsync[u8Index]->bRun.store(false);
+    }
+    {
+      std::lock_guard<std::mutex> oGuard(this->oMutex);
+      this->bRun.store(false);
+      this->bSleeping.store(false);
+    }
+    this->oWake.notify_one();
+    this->oWorker.join();
+  }
+
+  return bValid;
+}
+
+void Si5351_AsyncBus::wake(void) {
+  if(this->bSleeping.exchange(false)) {
+    std::lock_guard<std::mutex> oGuard(this->oMutex);
+    this->oWake.notify_one();
+  }
+}
+
+bool Si5351_AsyncBus::isEmpty(void) const {
+  bool bValid = true;
+  uint8_t u8Index;
+
+  for(u8Index = 0; u8Index < this->u8Devices; u8Index++) {
+    if(!this->apoAsync[u8Index]->isEmpty()) {
+      bValid = false;
+    }
+  }
+
+  return bValid;
+}
+
+/* The queues are closed before bRun, so a stopped bus sees their producers */
+bool Si5351_AsyncBus::isDrained(void) const {
+  bool bValid = true;
+  uint8_t u8Index;
+
+  for(u8Index = 0; u8Index < this->u8Devices; u8Index++) {
+    if(!this->apoAsync[u8Index]->isDrained()) {
+      bValid = false;
+    }
+  }
+
+  return bValid;
+}
+
+/* Round robin: one unit of work (pass or step) per chip and turn */
+void Si5351_AsyncBus::run(void) {
+  bool bBusy;
+  uint8_t u8Index;
+
+  for(;;) {
+    bBusy = false;
+    for(u8Index = 0; u8Index < this->u8Devices; u8Index++) {
+      if(this->apoAsync[u8Index]->dispatch()) {
+        bBusy = true;
+      }
+    }
+    if(bBusy) {
+      continue;
+    } else if(!this->bRun.load()) {
+      if(this->isDrained()) {
+        break;
+      }
+      std::this_thread::yield();
+    } else {
+      this->bSleeping.store(true);
+      if(this->isEmpty()) {
+        std::unique_lock<std::mutex> oLock(this->oMutex);
+        this->oWake.wait_for(
+          oLock, std::chrono::milliseconds(SI5351_ASYNC_IDLE_MS),
+          [this] { return !this->bSleeping.load(); }
+        );
+      }
+      this->bSleeping.store(false);
+    }
+  }
+}
+
+#endif  /* SI5351_USE_ASYNC */
@@ -0,0 +1,256 @@
+#ifndef _SI5351_ASYNC_H_
+#define _SI5351_ASYNC_H_
+
+/* Si5351 asynchronous command queue by AZO */
+/*
+  Host front-end (C++11 threads, Linux etc.): producer threads post commands
+  into a bounded lock-free multi-producer ring, one worker thread owns the bus,
+  coalesces what is queued and runs it. Enable with SI5351_USE_ASYNC.
+
+  The worker is meant to be the only user of the Si5351_I2C instance,
+  so it can be initialized without a lock (ppLock = NULL).
+
+  Several chips on one bus: attach their Si5351_Async queues to one
+  Si5351_AsyncBus. Its single worker owns the bus and takes one pass (or one
+  WRITE_REGISTERS step) from each chip in turn, so queued work for different
+  chips is interleaved without the bus going idle between them.
+*/
+
+#include "si5351_i2c.h"
+
+#if defined(SI5351_USE_ASYNC)
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
+/* Queue slots (power of 2) */
+#ifndef SI5351_ASYNC_QUEUE_SIZE
+#define SI5351_ASYNC_QUEUE_SIZE 256
+#endif
+
+/* Commands taken per worker pass (coalescing window) */
+#ifndef SI5351_ASYNC_BATCH
+#define SI5351_ASYNC_BATCH 32
+#endif
+
+/* Queues per Si5351_AsyncBus */
+#ifndef SI5351_ASYNC_DEVICES
+#define SI5351_ASYNC_DEVICES 8
+#endif
+
+/* Registers per WRITE_REGISTERS step before higher classes get the bus (0: no split) */
+#ifndef SI5351_ASYNC_CHUNK
+#define SI5351_ASYNC_CHUNK 8
+#endif
+
+/*
+  Priority classes, one queue each. The worker serves URGENT, then NORMAL,
+  then BULK, and checks the higher queues again after every pass or
+  WRITE_REGISTERS step. Order is kept within a class, not across classes.
+*/
+typedef enum Si5351_AsyncPriority_t_ {
+  SI5351_ASYNC_NORMAL = 0,
+  SI5351_ASYNC_URGENT,
+  SI5351_ASYNC_BULK,
+  SI5351_ASYNC_PRIORITIES
+} Si5351_AsyncPriority_t;
+
+/*
+  Commands
+  Within one worker pass a later FREQUENCY/MS/PHASE_OFFSET for the same CLK
+  (or MSA/MSB) replaces an earlier one, and a run of OUTPUT_ENABLE/DISABLE
+  becomes one Reg.3 write. Replaced commands complete with the result of
+  the command that replaced them.
+*/
+typedef enum Si5351_AsyncType_t_ {
+  SI5351_ASYNC_OUTPUT_ENABLE = 0, /* u8Mask */
+  SI5351_ASYNC_OUTPUT_DISABLE,    /* u8Mask */
+  SI5351_ASYNC_FREQUENCY,         /* tCLKNo, u32VCO, u32Freq (CLK from its PLL VCO) */
+  SI5351_ASYNC_MS,                /* tCLKNo, tMS */
+  SI5351_ASYNC_MSA,               /* tMS */
+  SI5351_ASYNC_MSB,               /* tMS */
+  SI5351_ASYNC_PHASE_OFFSET,      /* tCLKNo, u8Value */
+  SI5351_ASYNC_UPDATE_REGISTER,   /* u8Reg, u8Mask, u8Value */
+  SI5351_ASYNC_PLL_SOFT_RESET,
+  SI5351_ASYNC_WRITE_REGISTERS    /* u8Reg, u8Count, pu8Data (kept valid until done), written in steps */
+} Si5351_AsyncType_t;
+
+typedef struct Si5351_AsyncCommand_t_ {
+  Si5351_AsyncType_t     tType;
+  Si5351_AsyncPriority_t tPriority;
+  Si5351_CLKNo_t         tCLKNo;
+  uint8_t                u8Reg;
+  uint8_t                u8Mask;
+  uint8_t                u8Value;
+  uint8_t                u8Count;
+  const uint8_t*         pu8Data;
+  uint32_t               u32VCO;
+  uint32_t               u32Freq;
+  Si5351_MS_t            tMS;
+} Si5351_AsyncCommand_t;
+
+/* Queueing latency, post to start of execution (first step for WRITE_REGISTERS) */
+typedef struct Si5351_AsyncLatency_t_ {
+  uint32_t u32Count;
+  uint32_t u32WorstUs;
+  uint64_t u64TotalUs;
+} Si5351_AsyncLatency_t;
+
+typedef struct Si5351_AsyncStats_t_ {
+  uint32_t u32Posted;
+  uint32_t u32Rejected;   /* queue full */
+  uint32_t u32Executed;
+  uint32_t u32Coalesced;  /* replaced or merged, not run on its own */
+  uint32_t u32Passes;
+  uint32_t u32Steps;      /* WRITE_REGISTERS steps */
+  Si5351_AsyncLatency_t atLatency[SI5351_ASYNC_PRIORITIES];
+} Si5351_AsyncStats_t;
+
+/* Completion callback, called on the worker thread */
+typedef void (*Si5351_AsyncDone_t)(void* pUser, const bool bResult);
+
+class Si5351_AsyncBus;
+
+/* Si5351 asynchronous class */
+class Si5351_Async {
+public:
+  explicit Si5351_Async(Si5351_I2C& roSi5351);
+  ~Si5351_Async();
+
+  /* own worker thread (false when attached to an Si5351_AsyncBus, which starts and stops it) */
+  bool start(void);
+  /* runs what is already queued, then joins the worker */
+  bool stop(void);
+
+  /* false : queue full or not started */
+  bool post(const Si5351_AsyncCommand_t* ptCommand, Si5351_AsyncDone_t tDone = NULL, void* pUser = NULL);
+  /* invalid future (valid() == false) : queue full or not started */
+  std::future<bool> submit(const Si5351_AsyncCommand_t* ptCommand);
+
+  bool getStats(Si5351_AsyncStats_t* ptStats) const;
+  bool resetStats(void);
+  /* registers per WRITE_REGISTERS step, 0 : whole run at once */
+  bool setChunk(const uint8_t u8Registers);
+
+private:
+  friend class Si5351_AsyncBus;
+
+  Si5351_Async(const Si5351_Async&);
+  Si5351_Async& operator=(const Si5351_Async&);
+
+  typedef struct Entry_t_ {
+    Si5351_AsyncCommand_t tCommand;
+    Si5351_AsyncDone_t    tDone;
+    void*                 pUser;
+    std::promise<bool>*   poPromise;
+    uint64_t              u64PostedUs;
+  } Entry_t;
+
+  typedef struct Latency_t_ {
+    std::atomic<uint32_t> u32Count;
+    std::atomic<uint32_t> u32WorstUs;
+    std::atomic<uint64_t> u64TotalUs;
+  } Latency_t;
+
+  typedef struct Slot_t_ {
+    std::atomic<uint32_t> u32Seq;
+    Entry_t               tEntry;
+  } Slot_t;
+
+  bool push(Entry_t* ptEntry);
+  bool pop(Entry_t* ptEntry, const uint8_t u8Priority);
+  bool isEmpty(void) const;
+  bool isDrained(void) const;
+  void run(void);
+  void wake(void);
+  bool dispatch(void);
+  void runBatch(Entry_t* ptBatch, const uint8_t u8Count);
+  bool runStep(const uint8_t u8Priority);
+  void complete(Entry_t* ptEntry, const bool bResult);
+  void measure(const Entry_t* ptEntry);
+  static uint64_t nowUs(void);
+  static bool isSafeSplit(const uint16_t u16Reg);
+  bool execute(const Si5351_AsyncCommand_t* ptCommand);
+  bool executeMS(const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS);
+  void forgetDividers(const uint16_t u16Reg, const uint8_t u8Count);
+  bool executeOutputEnable(const Entry_t* ptBatch, const uint8_t u8First, const uint8_t u8Last);
+  static bool isOutputEnable(const Si5351_AsyncCommand_t* ptCommand);
+  static bool isReplacedBy(const Si5351_AsyncCommand_t* ptCommand, const Si5351_AsyncCommand_t* ptLater);
+
+  Si5351_I2C& roSi5351;
+  Si5351_AsyncBus* poBus;
+
+  Slot_t aatSlot[SI5351_ASYNC_PRIORITIES][SI5351_ASYNC_QUEUE_SIZE];
+  std::atomic<uint32_t> au32Enqueue[SI5351_ASYNC_PRIORITIES];
+  uint32_t au32Dequeue[SI5351_ASYNC_PRIORITIES];  /* worker only */
+
+  /* WRITE_REGISTERS in progress per class (worker only) */
+  Entry_t atStep[SI5351_ASYNC_PRIORITIES];
+  bool abStep[SI5351_ASYNC_PRIORITIES];
+  bool abStepResult[SI5351_ASYNC_PRIORITIES];
+  uint8_t au8StepDone[SI5351_ASYNC_PRIORITIES];
+  std::atomic<uint8_t> u8Chunk;
+
+  std::atomic<bool> bRun;
+  std::atomic<uint32_t> u32Pushing;  /* producers between the bRun check and publishing */
+  std::atomic<bool> bSleeping;
+  std::mutex oMutex;
+  std::condition_variable oWake;
+  std::thread oWorker;
+
+  /* last programmed dividers for frequency hops (worker only) */
+  Si5351_MS_t atLastMS[SI5351_CLKNUM];
+  bool abLastMS[SI5351_CLKNUM];
+  Si5351_MS_t atLastPLL[2];
+  bool abLastPLL[2];
+
+  std::atomic<uint32_t> u32Posted;
+  std::atomic<uint32_t> u32Rejected;
+  std::atomic<uint32_t> u32Executed;
+  std::atomic<uint32_t> u32Coalesced;
+  std::atomic<uint32_t> u32Passes;
+  std::atomic<uint32_t> u32Steps;
+  Latency_t atLatency[SI5351_ASYNC_PRIORITIES];
+};
+
+/* One worker for the Si5351_Async queues of the chips on one bus */
+class Si5351_AsyncBus {
+public:
+  Si5351_AsyncBus();
+  /* stop before the attached queues are destroyed */
+  ~Si5351_AsyncBus();
+
+  /* while stopped, up to SI5351_ASYNC_DEVICES queues (each Si5351_I2C with its own address) */
+  bool attach(Si5351_Async& roAsync);
+  /* opens all attached queues */
+  bool start(void);
+  /* closes them, runs what is already queued, then joins the worker */
+  bool stop(void);
+
+private:
+  friend class Si5351_Async;
+
+  Si5351_AsyncBus(const Si5351_AsyncBus&);
+  Si5351_AsyncBus& operator=(const Si5351_AsyncBus&);
+
+  void run(void);
+  void wake(void);
+  bool isEmpty(void) const;
+  bool isDrained(void) const;
+
+  Si5351_Async* apoAsync[SI5351_ASYNC_DEVICES];
+  uint8_t u8Devices;
+
+  std::atomic<bool> bRun;
+  std::atomic<bool> bSleeping;
+  std::mutex oMutex;
+  std::condition_variable oWake;
+  std::thread oWorker;
+};
+
+#endif  /* SI5351_USE_ASYNC */
+
+#endif  /* _SI5351_ASYNC_H_ */
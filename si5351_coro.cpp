@@ -0,0 +1,620 @@
+/* Si5351 C++20 coroutine front-end by AZO */
+
+#include "si5351_coro.h"
+
+#if defined(SI5351_USE_COROUTINE)
+
+#include <string.h>
+#include <chrono>
+#include <exception>
+
+/* Task */
+
+std::coroutine_handle<> Si5351_CoroTask::FinalAwaiter::await_suspend(Handle_t hTask) noexcept {
+  if(hTask.promise().hContinuation) {
+    return hTask.promise().hContinuation;
+  }
+  return std::noop_coroutine();
+}
+
+void Si5351_CoroTask::promise_type::unhandled_exception(void) {
+  std::terminate();
+}
+
+Si5351_CoroTask::Si5351_CoroTask() {
+}
+
+Si5351_CoroTask::Si5351_CoroTask(Handle_t hTask) {
+  this->hTask = hTask;
+}
+
+Si5351_CoroTask::Si5351_CoroTask(Si5351_CoroTask&& roTask) noexcept {
+  this->hTask = roTask.hTask;
+  roTask.hTask = nullptr;
+}
+
+Si5351_CoroTask& Si5351_CoroTask::operator=(Si5351_CoroTask&& roTask) noexcept {
+  if(this != &roTask) {
+    if(this->hTask) {
+      this->hTask.destroy();
+    }
+    this->hTask = roTask.hTask;
+    roTask.hTask = nullptr;
+  }
+
+  return *this;
+}
+
+Si5351_CoroTask::~Si5351_CoroTask() {
+  if(this->hTask) {
+    this->hTask.destroy();
+  }
+}
+
+bool Si5351_CoroTask::isValid(void) const {
+  return this->hTask ? true : false;
+}
+
+bool Si5351_CoroTask::isDone(void) const {
+  return (this->hTask && this->hTask.done()) ? true : false;
+}
+
+bool Si5351_CoroTask::getResult(void) const {
+  return this->isDone() ? this->hTask.promise().bResult : false;
+}
+
+bool Si5351_CoroTask::await_ready(void) const noexcept {
+  return this->hTask ? false : true;
+}
+
+/* Symmetric transfer into the task, it comes back through FinalAwaiter */
+std::coroutine_handle<> Si5351_CoroTask::await_suspend(std::coroutine_handle<> hCaller) noexcept {
+  this->hTask.promise().hContinuation = hCaller;
+  return this->hTask;
+}
+
+bool Si5351_CoroTask::await_resume(void) const noexcept {
+  return this->hTask ? this->hTask.promise().bResult : false;
+}
+
+/* Executor */
+
+Si5351_CoroExecutor::Si5351_CoroExecutor() {
+}
+
+void Si5351_CoroExecutor::post(std::coroutine_handle<> hCoroutine) {
+  if(hCoroutine) {
+    {
+      std::lock_guard<std::mutex> oLock(this->oMutex);
+      this->ahReady.push_back(hCoroutine);
+    }
+    this->oReady.notify_one();
+  }
+}
+
+bool Si5351_CoroExecutor::start(Si5351_CoroTask& roTask) {
+  bool bValid = false;
+
+  if(roTask.hTask && !roTask.hTask.done()) {
+    bValid = true;
+    this->post(roTask.hTask);
+  }
+
+  return bValid;
+}
+
+uint32_t Si5351_CoroExecutor::poll(void) {
+  uint32_t u32Count = 0;
+  std::coroutine_handle<> hCoroutine;
+
+  for(;;) {
+    {
+      std::lock_guard<std::mutex> oLock(this->oMutex);
+      if(this->ahReady.empty()) {
+        break;
+      }
+      hCoroutine = this->ahReady.front();
+      this->ahReady.pop_front();
+    }
+    hCoroutine.resume();
+    u32Count++;
+  }
+
+  return u32Count;
+}
+
+bool Si5351_CoroExecutor::runOnce(const uint32_t u32TimeoutUs) {
+  bool bValid = false;
+  std::coroutine_handle<> hCoroutine;
+
+  {
+    std::unique_lock<std::mutex> oLock(this->oMutex);
+    if(this->oReady.wait_for(oLock, std::chrono::microseconds(u32TimeoutUs), [this] { return !this->ahReady.empty(); })) {
+      bValid = true;
+      hCoroutine = this->ahReady.front();
+      this->ahReady.pop_front();
+    }
+  }
+  if(bValid) {
+    hCoroutine.resume();
+  }
+
+  return bValid;
+}
+
+bool Si5351_CoroExecutor::run(Si5351_CoroTask& roTask) {
+  bool bValid = false;
+
+  if(this->start(roTask)) {
+    while(!roTask.isDone()) {
+      this->runOnce(1000);
+    }
+    bValid = roTask.getResult();
+  }
+
+  return bValid;
+}
+
+uint32_t Si5351_CoroExecutor::getPending(void) {
+  std::lock_guard<std::mutex> oLock(this->oMutex);
+
+  return (uint32_t)this->ahReady.size();
+}
+
+/* Si5351 */
+
+/* Only the lock waits on it, and the core runs unlocked here */
+static void Si5351_Coro_MemoryBarrier(void) {
+}
+
+Si5351_Coro::Si5351_Coro() {
+  memset(&this->tSi5351, 0, sizeof(this->tSi5351));
+  memset(&this->tTransport, 0, sizeof(this->tTransport));
+  this->poExecutor = NULL;
+  this->u8Address = SI5351_I2C_ADDRESS;
+  this->bSynced = false;
+  this->bBusy = false;
+  memset(this->au8Image, 0, sizeof(this->au8Image));
+  this->u16PendingBytes = 0;
+  this->u8Runs = 0;
+  this->bOverflow = false;
+}
+
+bool Si5351_Coro::initialize(
+  const Si5351_CoroTransport_t* ptTransport,
+  Si5351_CoroExecutor* poExecutor,
+  const uint8_t u8Address
+) {
+  bool bValid = false;
+
+  if(ptTransport && poExecutor && u8Address <= 0x7F) {
+    if(ptTransport->tStartRead && ptTransport->tStartWrite) {
+      this->tTransport = *ptTransport;
+      this->poExecutor = poExecutor;
+      this->u8Address = u8Address;
+      this->bSynced = false;
+
+      /* The core runs only inside tasks, one at a time per device: no lock */
+      bValid = Si5351_Initialize(
+        &this->tSi5351,
+        this,
+        Si5351_Coro::gen_read,
+        Si5351_Coro::gen_write,
+        Si5351_Coro_MemoryBarrier,
+        NULL
+      );
+      if(bValid) {
+        bValid = Si5351_SetReadBlock(&this->tSi5351, Si5351_Coro::gen_read_block);
+      }
+      if(bValid) {
+        bValid = Si5351_SetWriteBlock(&this->tSi5351, Si5351_Coro::gen_write_block);
+      }
+      if(bValid) {
+        bValid = Si5351_AttachCache(&this->tSi5351, &this->tCache);
+      }
+      if(bValid) {
+        bValid = Si5351_SetWriteElision(&this->tSi5351, true);
+      }
+    }
+  }
+
+  return bValid;
+}
+
+bool Si5351_Coro::getAddress(uint8_t* pu8Address) {
+  bool bValid = false;
+
+  if(pu8Address) {
+    bValid = true;
+    *pu8Address = this->u8Address;
+  }
+
+  return bValid;
+}
+
+bool Si5351_Coro::invalidateCache(void) {
+  this->bSynced = false;
+
+  return Si5351_InvalidateCache(&this->tSi5351);
+}
+
+/* Access : the core reads the image and stages its writes */
+uint8_t Si5351_Coro::gen_read(void* pSi5351_Coro, const uint8_t u8Reg) {
+  uint8_t u8Value = 0;
+
+  if(pSi5351_Coro) {
+    u8Value = ((Si5351_Coro*)pSi5351_Coro)->au8Image[u8Reg];
+  }
+
+  return u8Value;
+}
+
+void Si5351_Coro::gen_write(void* pSi5351_Coro, const uint8_t u8Reg, const uint8_t u8Value) {
+  if(pSi5351_Coro) {
+    ((Si5351_Coro*)pSi5351_Coro)->stage(u8Reg, &u8Value, 1);
+  }
+}
+
+void Si5351_Coro::gen_read_block(void* pSi5351_Coro, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count) {
+  uint8_t u8Index;
+
+  if(pSi5351_Coro && pu8Value) {
+    for(u8Index = 0; u8Index < u8Count; u8Index++) {
+      pu8Value[u8Index] = ((Si5351_Coro*)pSi5351_Coro)->au8Image[(uint8_t)(u8Reg + u8Index)];
+    }
+  }
+}
+
+void Si5351_Coro::gen_write_block(void* pSi5351_Coro, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+  if(pSi5351_Coro && pu8Value) {
+    ((Si5351_Coro*)pSi5351_Coro)->stage(u8Reg, pu8Value, u8Count);
+  }
+}
+
+/* Append to the pending runs, joining a run that ends at u8Reg */
+void Si5351_Coro::stage(const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+  uint8_t u8Index;
+
+  if(this->u16PendingBytes + u8Count > sizeof(this->au8Pending)) {
+    this->bOverflow = true;
+    return;
+  }
+  if(
+    this->u8Runs &&
+    this->au8RunReg[this->u8Runs - 1] + this->au8RunCount[this->u8Runs - 1] == u8Reg &&
+    this->au8RunCount[this->u8Runs - 1] + u8Count <= 0xFF
+  ) {
+    this->au8RunCount[this->u8Runs - 1] += u8Count;
+  } else if(this->u8Runs < sizeof(this->au8RunReg)) {
+    this->au8RunReg[this->u8Runs] = u8Reg;
+    this->au8RunCount[this->u8Runs] = u8Count;
+    this->u8Runs++;
+  } else {
+    this->bOverflow = true;
+    return;
+  }
+  for(u8Index = 0; u8Index < u8Count; u8Index++) {
+    this->au8Pending[this->u16PendingBytes++] = pu8Value[u8Index];
+    this->au8Image[(uint8_t)(u8Reg + u8Index)] = pu8Value[u8Index];
+  }
+}
+
+/* Transfer */
+
+Si5351_Coro::Transfer Si5351_Coro::transfer(const bool bWrite, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count) {
+  Transfer tTransfer;
+
+  tTransfer.poSi5351 = this;
+  tTransfer.bWrite = bWrite;
+  tTransfer.u8Reg = u8Reg;
+  tTransfer.pu8Value = pu8Value;
+  tTransfer.u8Count = u8Count;
+  tTransfer.bResult = false;
+
+  return tTransfer;
+}
+
+/* false : not started, the caller goes on at once with bResult false */
+bool Si5351_Coro::Transfer::await_suspend(std::coroutine_handle<> hCoroutine) {
+  bool bValid;
+
+  this->hCaller = hCoroutine;
+  if(this->bWrite) {
+    bValid = this->poSi5351->tTransport.tStartWrite(
+      this->poSi5351->tTransport.pContext, this->poSi5351->u8Address,
+      this->u8Reg, this->pu8Value, this->u8Count, Transfer::done, this
+    );
+  } else {
+    bValid = this->poSi5351->tTransport.tStartRead(
+      this->poSi5351->tTransport.pContext, this->poSi5351->u8Address,
+      this->u8Reg, this->pu8Value, this->u8Count, Transfer::done, this
+    );
+  }
+  /* Once started, done() may already have resumed the caller elsewhere: no member access */
+
+  return bValid;
+}
+
+void Si5351_Coro::Transfer::done(void* pUser, const bool bResult) {
+  Transfer* ptTransfer = (Transfer*)pUser;
+
+  ptTransfer->bResult = bResult;
+  ptTransfer->poSi5351->poExecutor->post(ptTransfer->hCaller);
+}
+
+/* Device order */
+
+Si5351_Coro::Acquire Si5351_Coro::acquire(void) {
+  Acquire tAcquire;
+
+  tAcquire.poSi5351 = this;
+
+  return tAcquire;
+}
+
+bool Si5351_Coro::Acquire::await_ready(void) const noexcept {
+  bool bValid = false;
+
+  if(!this->poSi5351->bBusy) {
+    bValid = true;
+    this->poSi5351->bBusy = true;
+  }
+
+  return bValid;
+}
+
+void Si5351_Coro::Acquire::await_suspend(std::coroutine_handle<> hCoroutine) {
+  this->poSi5351->ahWaiting.push_back(hCoroutine);
+}
+
+/* The next waiter inherits the device and runs from the executor */
+void Si5351_Coro::release(void) {
+  if(this->ahWaiting.empty()) {
+    this->bBusy = false;
+  } else {
+    this->poExecutor->post(this->ahWaiting.front());
+    this->ahWaiting.pop_front();
+  }
+}
+
+/* Internal steps (the device is owned) */
+
+Si5351_CoroTask Si5351_Coro::prepare(void) {
+  bool bValid = true;
+  uint16_t u16Reg;
+  uint8_t u8Chunk;
+
+  if(!this->bSynced) {
+    for(u16Reg = 0x02; bValid && u16Reg <= SI5351_REG_LAST; u16Reg += u8Chunk) {
+      u8Chunk = (SI5351_REG_LAST + 1 - u16Reg > SI5351_CORO_BLOCK_MAX) ? SI5351_CORO_BLOCK_MAX : (uint8_t)(SI5351_REG_LAST + 1 - u16Reg);
+      bValid = co_await this->transfer(false, (uint8_t)u16Reg, &this->au8Image[u16Reg], u8Chunk);
+    }
+    if(bValid) {
+      bValid = Si5351_SyncCache(&this->tSi5351);
+    }
+    this->bSynced = bValid;
+  }
+
+  co_return bValid;
+}
+
+void Si5351_Coro::discard(void) {
+  this->u16PendingBytes = 0;
+  this->u8Runs = 0;
+  this->bOverflow = false;
+}
+
+bool Si5351_Coro::begin(void) {
+  this->discard();
+
+  return Si5351_BeginTransaction(&this->tSi5351);
+}
+
+/* Commit (or abort) the transaction, then send the staged runs */
+Si5351_CoroTask Si5351_Coro::commit(const bool bValid) {
+  bool bResult = bValid;
+
+  if(bResult) {
+    Si5351_Commit(&this->tSi5351);
+    bResult = co_await this->send();
+  } else {
+    Si5351_AbortTransaction(&this->tSi5351);
+  }
+
+  co_return bResult;
+}
+
+/* Staged runs in the order the core wrote them */
+Si5351_CoroTask Si5351_Coro::send(void) {
+  bool bResult = !this->bOverflow;
+  uint16_t u16Offset = 0;
+  uint8_t u8Run;
+  uint8_t u8Index;
+  uint8_t u8Chunk;
+
+  for(u8Run = 0; bResult && u8Run < this->u8Runs; u8Run++) {
+    for(u8Index = 0; bResult && u8Index < this->au8RunCount[u8Run]; u8Index += u8Chunk) {
+      u8Chunk = (this->au8RunCount[u8Run] - u8Index > SI5351_CORO_BLOCK_MAX) ? SI5351_CORO_BLOCK_MAX : (uint8_t)(this->au8RunCount[u8Run] - u8Index);
+      bResult = co_await this->transfer(true, this->au8RunReg[u8Run] + u8Index, &this->au8Pending[u16Offset + u8Index], u8Chunk);
+    }
+    u16Offset += this->au8RunCount[u8Run];
+  }
+  if(!bResult) {
+    /* The cache holds values the device may not have */
+    this->invalidateCache();
+  }
+
+  co_return bResult;
+}
+
+/* Operations */
+
+Si5351_CoroTask Si5351_Coro::initDevice(void) {
+  bool bValid = false;
+
+  co_await this->acquire();
+  if(this->begin()) {
+    bValid = co_await this->commit(Si5351_InitDevice(&this->tSi5351));
+  }
+  this->release();
+
+  co_return bValid;
+}
+
+Si5351_CoroTask Si5351_Coro::syncCache(void) {
+  bool bValid;
+
+  co_await this->acquire();
+  this->bSynced = false;
+  bValid = co_await this->prepare();
+  this->release();
+
+  co_return bValid;
+}
+
+/* Reg.0 is never cached: read it into the image and decode it with the core */
+Si5351_CoroTask Si5351_Coro::getStatus(Si5351_Status_t* ptStatus) {
+  bool bValid = false;
+
+  if(ptStatus) {
+    co_await this->acquire();
+    if(co_await this->transfer(false, 0x00, &this->au8Image[0x00], 1)) {
+      bValid = Si5351_GetStatus(ptStatus, &this->tSi5351);
+    }
+    this->release();
+  }
+
+  co_return bValid;
+}
+
+/* Straight from the device, the cache is not consulted */
+Si5351_CoroTask Si5351_Coro::readRegisters(uint8_t* pu8Value, const uint8_t u8Reg, const uint8_t u8Count) {
+  bool bValid = false;
+  uint8_t u8Index;
+  uint8_t u8Chunk;
+
+  if(pu8Value && u8Count && (uint16_t)u8Reg + u8Count <= 0x100) {
+    bValid = true;
+    co_await this->acquire();
+    for(u8Index = 0; bValid && u8Index < u8Count; u8Index += u8Chunk) {
+      u8Chunk = (u8Count - u8Index > SI5351_CORO_BLOCK_MAX) ? SI5351_CORO_BLOCK_MAX : (uint8_t)(u8Count - u8Index);
+      bValid = co_await this->transfer(false, u8Reg + u8Index, &pu8Value[u8Index], u8Chunk);
+    }
+    this->release();
+  }
+
+  co_return bValid;
+}
+
+Si5351_CoroTask Si5351_Coro::writeRegisters(const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+  bool bValid = false;
+
+  co_await this->acquire();
+  if(this->begin()) {
+    bValid = co_await this->commit(Si5351_WriteRegisters(&this->tSi5351, u8Reg, pu8Value, u8Count));
+  }
+  this->release();
+
+  co_return bValid;
+}
+
+Si5351_CoroTask Si5351_Coro::updateRegister(const uint8_t u8Reg, const uint8_t u8Mask, const uint8_t u8Value) {
+  bool bValid = false;
+
+  co_await this->acquire();
+  if(co_await this->prepare() && this->begin()) {
+    bValid = co_await this->commit(Si5351_UpdateRegister(&this->tSi5351, u8Reg, u8Mask, u8Value));
+  }
+  this->release();
+
+  co_return bValid;
+}
+
+Si5351_CoroTask Si5351_Coro::setOutputEnable(const uint8_t u8Enable) {
+  bool bValid = false;
+
+  co_await this->acquire();
+  if(co_await this->prepare() && this->begin()) {
+    bValid = co_await this->commit(Si5351_SetOutputEnable(&this->tSi5351, u8Enable));
+  }
+  this->release();
+
+  co_return bValid;
+}
+
+Si5351_CoroTask Si5351_Coro::setOutputDisable(const uint8_t u8Disable) {
+  bool bValid = false;
+
+  co_await this->acquire();
+  if(co_await this->prepare() && this->begin()) {
+    bValid = co_await this->commit(Si5351_SetOutputDisable(&this->tSi5351, u8Disable));
+  }
+  this->release();
+
+  co_return bValid;
+}
+
+Si5351_CoroTask Si5351_Coro::setMS(const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS) {
+  bool bValid = false;
+
+  co_await this->acquire();
+  if(co_await this->prepare() && this->begin()) {
+    bValid = co_await this->commit(Si5351_SetMS(&this->tSi5351, tCLKNo, ptMS));
+  }
+  this->release();
+
+  co_return bValid;
+}
+
+Si5351_CoroTask Si5351_Coro::setFrequency(const Si5351_CLKNo_t tCLKNo, const uint32_t u32VCO, const uint32_t u32Freq) {
+  bool bValid;
+  Si5351_MS_t tMS;
+
+#if defined(SI5351_USE_INTEGER_MATH)
+  bValid = Si5351_I2C::calcMSClk(&tMS, u32VCO, u32Freq);
+#elif defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
+  bValid = Si5351_I2C::calcMSClk(&tMS, ui32_to_f64(u32VCO), ui32_to_f64(u32Freq));
+#else
+  bValid = Si5351_I2C::calcMSClk(&tMS, (double)u32VCO, (double)u32Freq);
+#endif
+  if(bValid) {
+    bValid = co_await this->setMS(tCLKNo, &tMS);
+  }
+
+  co_return bValid;
+}
+
+/*
+  No transaction around Si5351_SetPlan: it commits each of its steps itself,
+  the steps are staged in turn and go out in that order. A failed step may
+  follow committed ones, so what was staged is sent anyway.
+*/
+Si5351_CoroTask Si5351_Coro::setPlan(const Si5351_Plan_t* ptPlan) {
+  bool bValid = false;
+  bool bSent;
+
+  co_await this->acquire();
+  if(co_await this->prepare()) {
+    this->discard();
+    bValid = Si5351_SetPlan(&this->tSi5351, ptPlan);
+    bSent = co_await this->send();
+    bValid = bValid && bSent;
+  }
+  this->release();
+
+  co_return bValid;
+}
+
+Si5351_CoroTask Si5351_Coro::PLLSoftReset(void) {
+  bool bValid = false;
+
+  co_await this->acquire();
+  if(co_await this->prepare() && this->begin()) {
+    bValid = co_await this->commit(Si5351_PLLSoftReset(&this->tSi5351));
+  }
+  this->release();
+
+  co_return bValid;
+}
+
+#endif  /* SI5351_USE_COROUTINE */
@@ -0,0 +1,245 @@
+#ifndef _SI5351_CORO_H_
+#define _SI5351_CORO_H_
+
+/* Si5351 C++20 coroutine front-end by AZO */
+/*
+  Awaitable operations on a non-blocking transport (Linux, ESP32 etc.).
+  Enable with SI5351_USE_COROUTINE, needs a C++20 compiler.
+
+  The transport only starts a transfer and reports its end through a
+  callback, so no call here waits for the bus. Every operation is a lazy
+  Si5351_CoroTask: co_await it from another task, or hand it to a
+  Si5351_CoroExecutor, which resumes tasks whose transfers completed.
+  Many operations, on one or many devices, can be in flight at once; the
+  operations of one device run in call order.
+
+  Si5351_Coro keeps the register cache of the C core. Setters run the core
+  inside a transaction with a capturing bus, then await the staged block
+  writes. The register map is read once (syncCache) before the first
+  read-modify-write, and write elision drops bytes the device already has.
+
+  Threading: tasks of a device must be resumed by one executor thread;
+  the transport may call tDone from any thread (not from an ISR).
+*/
+
+#include "si5351_i2c.h"
+
+#if defined(SI5351_USE_COROUTINE)
+
+#if !defined(__cpp_impl_coroutine)
+#error si5351_coro.h needs C++20 coroutines
+#endif
+
+#include <coroutine>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+/* Max data bytes per transfer */
+#ifndef SI5351_CORO_BLOCK_MAX
+#define SI5351_CORO_BLOCK_MAX SI5351_I2C_BLOCK_MAX
+#endif
+
+/*
+  Non-blocking transport
+  tStartRead / tStartWrite start a register transfer (u8Reg then u8Count
+  bytes, register auto-increment) and return at once. tDone(pUser, bResult)
+  is called exactly once when it ended; it may be called before the start
+  function returns. pu8Value stays valid until then.
+  false : not started (tDone is not called)
+*/
+typedef void (*Si5351_CoroDone_t)(void* pUser, const bool bResult);
+typedef bool (*Si5351_CoroStartRead_t)(
+  void* pContext, const uint8_t u8Address, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count,
+  Si5351_CoroDone_t tDone, void* pUser
+);
+typedef bool (*Si5351_CoroStartWrite_t)(
+  void* pContext, const uint8_t u8Address, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count,
+  Si5351_CoroDone_t tDone, void* pUser
+);
+
+typedef struct Si5351_CoroTransport_t_ {
+  Si5351_CoroStartRead_t  tStartRead;
+  Si5351_CoroStartWrite_t tStartWrite;
+  void*                   pContext;
+} Si5351_CoroTransport_t;
+
+/* Coroutine returning bool, started on first co_await or by an executor */
+class Si5351_CoroTask {
+public:
+  struct promise_type;
+  typedef std::coroutine_handle<promise_type> Handle_t;
+
+  struct FinalAwaiter {
+    bool await_ready(void) const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(Handle_t hTask) noexcept;
+    void await_resume(void) const noexcept {}
+  };
+
+  struct promise_type {
+    bool bResult = false;
+    std::coroutine_handle<> hContinuation;
+
+    Si5351_CoroTask get_return_object(void) { return Si5351_CoroTask(Handle_t::from_promise(*this)); }
+    std::suspend_always initial_suspend(void) const noexcept { return std::suspend_always(); }
+    FinalAwaiter final_suspend(void) const noexcept { return FinalAwaiter(); }
+    void return_value(const bool bValue) { this->bResult = bValue; }
+    void unhandled_exception(void);
+  };
+
+  Si5351_CoroTask();
+  Si5351_CoroTask(Si5351_CoroTask&& roTask) noexcept;
+  Si5351_CoroTask& operator=(Si5351_CoroTask&& roTask) noexcept;
+  ~Si5351_CoroTask();
+
+  bool isValid(void) const;
+  bool isDone(void) const;
+  /* false until done */
+  bool getResult(void) const;
+
+  /* co_await : runs the task, resumes the caller with its result */
+  bool await_ready(void) const noexcept;
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> hCaller) noexcept;
+  bool await_resume(void) const noexcept;
+
+private:
+  explicit Si5351_CoroTask(Handle_t hTask);
+  Si5351_CoroTask(const Si5351_CoroTask&);
+  Si5351_CoroTask& operator=(const Si5351_CoroTask&);
+
+  friend class Si5351_CoroExecutor;
+  Handle_t hTask;
+};
+
+/*
+  Executor
+  A FIFO of resumable coroutines. post() may be called from any thread,
+  the poll/run functions from the one thread that owns the tasks.
+*/
+class Si5351_CoroExecutor {
+public:
+  Si5351_CoroExecutor();
+
+  void post(std::coroutine_handle<> hCoroutine);
+  /* Queue a task not started yet (it must outlive its run) */
+  bool start(Si5351_CoroTask& roTask);
+  /* Resume what is ready, without waiting; returns the number resumed (event loop hook) */
+  uint32_t poll(void);
+  /* Wait up to u32TimeoutUs for one coroutine and resume it; false : timeout */
+  bool runOnce(const uint32_t u32TimeoutUs);
+  /* start(roTask) and resume until it is done; returns its result */
+  bool run(Si5351_CoroTask& roTask);
+  uint32_t getPending(void);
+
+private:
+  Si5351_CoroExecutor(const Si5351_CoroExecutor&);
+  Si5351_CoroExecutor& operator=(const Si5351_CoroExecutor&);
+
+  std::mutex oMutex;
+  std::condition_variable oReady;
+  std::deque<std::coroutine_handle<> > ahReady;
+};
+
+/* Si5351 coroutine class */
+class Si5351_Coro {
+public:
+  Si5351_Coro();
+
+  bool initialize(
+    const Si5351_CoroTransport_t* ptTransport,
+    Si5351_CoroExecutor* poExecutor,
+    const uint8_t u8Address = SI5351_I2C_ADDRESS
+  );
+  bool getAddress(uint8_t* pu8Address);
+  /* Forget the register image (device reset or power cycled) */
+  bool invalidateCache(void);
+
+  /*
+    Awaitable operations, true : done on the device.
+    Pointer arguments must stay valid until the task is done.
+  */
+  Si5351_CoroTask initDevice(void);
+  Si5351_CoroTask syncCache(void);
+  Si5351_CoroTask getStatus(Si5351_Status_t* ptStatus);
+  Si5351_CoroTask readRegisters(uint8_t* pu8Value, const uint8_t u8Reg, const uint8_t u8Count);
+  Si5351_CoroTask writeRegisters(const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count);
+  Si5351_CoroTask updateRegister(const uint8_t u8Reg, const uint8_t u8Mask, const uint8_t u8Value);
+  Si5351_CoroTask setOutputEnable(const uint8_t u8Enable);
+  Si5351_CoroTask setOutputDisable(const uint8_t u8Disable);
+  Si5351_CoroTask setMS(const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS);
+  /* Multisynth of tCLKNo for u32Freq from its PLL at u32VCO (Hz) */
+  Si5351_CoroTask setFrequency(const Si5351_CLKNo_t tCLKNo, const uint32_t u32VCO, const uint32_t u32Freq);
+  /* Whole frequency plan in one burst (see Si5351_SetPlan) */
+  Si5351_CoroTask setPlan(const Si5351_Plan_t* ptPlan);
+  Si5351_CoroTask PLLSoftReset(void);
+
+  /* Access (Don't use) */
+  static uint8_t gen_read(void* pSi5351_Coro, const uint8_t u8Reg);
+  static void gen_write(void* pSi5351_Coro, const uint8_t u8Reg, const uint8_t u8Value);
+  static void gen_read_block(void* pSi5351_Coro, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count);
+  static void gen_write_block(void* pSi5351_Coro, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count);
+
+private:
+  Si5351_Coro(const Si5351_Coro&);
+  Si5351_Coro& operator=(const Si5351_Coro&);
+
+  /* One transfer on the transport, resumed through the executor */
+  struct Transfer {
+    Si5351_Coro* poSi5351;
+    bool bWrite;
+    uint8_t u8Reg;
+    uint8_t* pu8Value;
+    uint8_t u8Count;
+    bool bResult;
+    std::coroutine_handle<> hCaller;
+
+    bool await_ready(void) const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> hCoroutine);
+    bool await_resume(void) const noexcept { return this->bResult; }
+    static void done(void* pUser, const bool bResult);
+  };
+
+  /* Per-device order: the operation owning the device, the others wait in FIFO */
+  struct Acquire {
+    Si5351_Coro* poSi5351;
+
+    bool await_ready(void) const noexcept;
+    void await_suspend(std::coroutine_handle<> hCoroutine);
+    void await_resume(void) const noexcept {}
+  };
+
+  Acquire acquire(void);
+  void release(void);
+
+  Transfer transfer(const bool bWrite, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count);
+  /* Register image read once before the first read-modify-write */
+  Si5351_CoroTask prepare(void);
+  /* Core calls between begin() and commit() only stage their writes */
+  void discard(void);
+  bool begin(void);
+  Si5351_CoroTask commit(const bool bValid);
+  Si5351_CoroTask send(void);
+  void stage(const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count);
+
+  Si5351_t tSi5351;
+  Si5351_Cache_t tCache;
+  Si5351_CoroTransport_t tTransport;
+  Si5351_CoroExecutor* poExecutor;
+  uint8_t u8Address;
+  bool bSynced;
+  bool bBusy;
+  std::deque<std::coroutine_handle<> > ahWaiting;
+
+  /* Register image the core reads from, and the block writes it staged */
+  uint8_t au8Image[256];
+  uint8_t au8Pending[256];
+  uint8_t au8RunReg[128];
+  uint8_t au8RunCount[128];
+  uint16_t u16PendingBytes;
+  uint8_t u8Runs;
+  bool bOverflow;
+};
+
+#endif  /* SI5351_USE_COROUTINE */
+
+#endif  /* _SI5351_CORO_H_ */
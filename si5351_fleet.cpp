@@ -0,0 +1,115 @@
+/* Si5351 fleet programming by AZO */
+
+#include "si5351_fleet.h"
+
+#if defined(SI5351_USE_FLEET)
+
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+Si5351_Fleet::Si5351_Fleet() {
+  this->u8Devices = 0;
+  memset(&this->tStats, 0, sizeof(this->tStats));
+}
+
+bool Si5351_Fleet::add(Si5351_I2C& roSi5351, const uint8_t u8Bus) {
+  bool bValid = false;
+
+  if(this->u8Devices < SI5351_FLEET_DEVICES && u8Bus < SI5351_FLEET_BUSES) {
+    bValid = true;
+    this->apoSi5351[this->u8Devices] = &roSi5351;
+    this->au8Bus[this->u8Devices] = u8Bus;
+    this->u8Devices++;
+  }
+
+  return bValid;
+}
+
+uint8_t Si5351_Fleet::getDevices(void) const {
+  return this->u8Devices;
+}
+
+/* The last bus runs on the calling thread, the others on their own */
+bool Si5351_Fleet::program(const Si5351_Plan_t* ptPlan, bool* pbResult) {
+  bool bValid = false;
+  bool abResult[SI5351_FLEET_DEVICES];
+  bool abUsed[SI5351_FLEET_BUSES];
+  std::thread aoThread[SI5351_FLEET_BUSES];
+  uint64_t u64Start = nowUs();
+  uint8_t u8Bus;
+  uint8_t u8Last = SI5351_FLEET_BUSES;
+  uint8_t u8Index;
+
+  if(ptPlan && this->u8Devices) {
+    bValid = true;
+    memset(abUsed, 0, sizeof(abUsed));
+    memset(&this->tStats, 0, sizeof(this->tStats));
+    for(u8Index = 0; u8Index < this->u8Devices; u8Index++) {
+      abUsed[this->au8Bus[u8Index]] = true;
+      abResult[u8Index] = false;
+    }
+    for(u8Bus = 0; u8Bus < SI5351_FLEET_BUSES; u8Bus++) {
+      if(abUsed[u8Bus]) {
+        this->tStats.u8Buses++;
+        if(u8Last < SI5351_FLEET_BUSES) {
+          aoThread[u8Last] = std::thread(&Si5351_Fleet::runBus, this, u8Last, ptPlan, abResult);
+        }
+        u8Last = u8Bus;
+      }
+    }
+    this->runBus(u8Last, ptPlan, abResult);
+    for(u8Bus = 0; u8Bus < SI5351_FLEET_BUSES; u8Bus++) {
+      if(aoThread[u8Bus].joinable()) {
+        aoThread[u8Bus].join();
+      }
+    }
+
+    for(u8Index = 0; u8Index < this->u8Devices; u8Index++) {
+      if(abResult[u8Index]) {
+        this->tStats.u32Programmed++;
+      } else {
+        this->tStats.u32Failed++;
+        bValid = false;
+      }
+      if(pbResult) {
+        pbResult[u8Index] = abResult[u8Index];
+      }
+    }
+    this->tStats.u64TotalUs = nowUs() - u64Start;
+  }
+
+  return bValid;
+}
+
+bool Si5351_Fleet::getStats(Si5351_FleetStats_t* ptStats) const {
+  bool bValid = false;
+
+  if(ptStats) {
+    bValid = true;
+    *ptStats = this->tStats;
+  }
+
+  return bValid;
+}
+
+/* Devices of one bus, in the order they were added */
+void Si5351_Fleet::runBus(const uint8_t u8Bus, const Si5351_Plan_t* ptPlan, bool* pbResult) {
+  uint64_t u64Start = nowUs();
+  uint8_t u8Index;
+
+  for(u8Index = 0; u8Index < this->u8Devices; u8Index++) {
+    if(this->au8Bus[u8Index] == u8Bus) {
+      pbResult[u8Index] = this->apoSi5351[u8Index]->setPlan(&ptPlan[u8Index]);
+    }
+  }
+  this->tStats.au64BusUs[u8Bus] = nowUs() - u64Start;
+}
+
+uint64_t Si5351_Fleet::nowUs(void) {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()
+  ).count();
+}
+
+#endif  /* SI5351_USE_FLEET */
@@ -0,0 +1,72 @@
+#ifndef _SI5351_FLEET_H_
+#define _SI5351_FLEET_H_
+
+/* Si5351 fleet programming by AZO */
+/*
+  Host front-end (C++11 threads, Linux etc.) for many Si5351s spread over
+  independent I2C buses. program() applies one Si5351_Plan_t per device with
+  one thread per bus, so the buses transfer in parallel, and returns when
+  every device is done. Devices on the same bus are programmed in turn.
+  Enable with SI5351_USE_FLEET.
+
+  Each bus needs its own Wire-style callbacks; the devices of a bus have
+  distinct addresses (setAddress) and may share a lock with other users.
+*/
+
+#include "si5351_i2c.h"
+
+#if defined(SI5351_USE_FLEET)
+
+#include <stddef.h>
+
+/* Devices per fleet */
+#ifndef SI5351_FLEET_DEVICES
+#define SI5351_FLEET_DEVICES 32
+#endif
+
+/* Buses per fleet */
+#ifndef SI5351_FLEET_BUSES
+#define SI5351_FLEET_BUSES 8
+#endif
+
+/* Last program() call */
+typedef struct Si5351_FleetStats_t_ {
+  uint32_t u32Programmed;
+  uint32_t u32Failed;
+  uint8_t  u8Buses;                        /* buses with devices */
+  uint64_t u64TotalUs;                     /* call to return */
+  uint64_t au64BusUs[SI5351_FLEET_BUSES];  /* per bus */
+} Si5351_FleetStats_t;
+
+/* Si5351 fleet class */
+class Si5351_Fleet {
+public:
+  Si5351_Fleet();
+
+  /* u8Bus : 0 - SI5351_FLEET_BUSES-1, the I2C bus of the device */
+  bool add(Si5351_I2C& roSi5351, const uint8_t u8Bus);
+  uint8_t getDevices(void) const;
+
+  /*
+    ptPlan[n] to the n-th added device, pbResult[n] its result (may be NULL).
+    true : every device programmed
+  */
+  bool program(const Si5351_Plan_t* ptPlan, bool* pbResult = NULL);
+  bool getStats(Si5351_FleetStats_t* ptStats) const;
+
+private:
+  Si5351_Fleet(const Si5351_Fleet&);
+  Si5351_Fleet& operator=(const Si5351_Fleet&);
+
+  void runBus(const uint8_t u8Bus, const Si5351_Plan_t* ptPlan, bool* pbResult);
+  static uint64_t nowUs(void);
+
+  Si5351_I2C* apoSi5351[SI5351_FLEET_DEVICES];
+  uint8_t au8Bus[SI5351_FLEET_DEVICES];
+  uint8_t u8Devices;
+  Si5351_FleetStats_t tStats;
+};
+
+#endif  /* SI5351_USE_FLEET */
+
+#endif  /* _SI5351_FLEET_H_ */
@@ -3,9 +3,8 @@
 #include <stdio.h>
 #include "si5351_i2c.h"
 
-#define SI5351_I2C_ADDRESS 0x60
-
 Si5351_I2C::Si5351_I2C() {
+  this->u8Address = SI5351_I2C_ADDRESS;
 }
 
 bool Si5351_I2C::initialize(
@@ -40,6 +39,12 @@ bool Si5351_I2C::initialize(
       tMemoryBarrier,
       ppLock
     );
+    if(bValid) {
+      bValid = Si5351_SetReadBlock(&this->tSi5351, Si5351_I2C::gen_read_block);
+    }
+    if(bValid) {
+      bValid = Si5351_SetWriteBlock(&this->tSi5351, Si5351_I2C::gen_write_block);
+    }
   }
 
   return bValid;
@@ -57,11 +62,11 @@ uint8_t Si5351_I2C::gen_read(void* pSi5351_I2C, const uint8_t u8Reg) {
       ((Si5351_I2C*)pSi5351_I2C)->tWrite &&
       ((Si5351_I2C*)pSi5351_I2C)->tEndTransmission
     ) {
-      ((Si5351_I2C*)pSi5351_I2C)->tBeginTransmission(SI5351_I2C_ADDRESS);
+      ((Si5351_I2C*)pSi5351_I2C)->tBeginTransmission(((Si5351_I2C*)pSi5351_I2C)->u8Address);
       ((Si5351_I2C*)pSi5351_I2C)->tWrite(u8Reg);
       ((Si5351_I2C*)pSi5351_I2C)->tEndTransmission();
-      ((Si5351_I2C*)pSi5351_I2C)->tRequestFrom(SI5351_I2C_ADDRESS, 1);
-      u8Value = ((Si5351_I2C*)pSi5351_I2C)->tRead(SI5351_I2C_ADDRESS);
+      ((Si5351_I2C*)pSi5351_I2C)->tRequestFrom(((Si5351_I2C*)pSi5351_I2C)->u8Address, 1);
+      u8Value = ((Si5351_I2C*)pSi5351_I2C)->tRead(((Si5351_I2C*)pSi5351_I2C)->u8Address);
     }
   }
 
@@ -75,7 +80,7 @@ void Si5351_I2C::gen_write(void* pSi5351_I2C, const uint8_t u8Reg, const uint8_t
       ((Si5351_I2C*)pSi5351_I2C)->tWrite &&
       ((Si5351_I2C*)pSi5351_I2C)->tEndTransmission
     ) {
-      ((Si5351_I2C*)pSi5351_I2C)->tBeginTransmission(SI5351_I2C_ADDRESS);
+      ((Si5351_I2C*)pSi5351_I2C)->tBeginTransmission(((Si5351_I2C*)pSi5351_I2C)->u8Address);
       ((Si5351_I2C*)pSi5351_I2C)->tWrite(u8Reg);
       ((Si5351_I2C*)pSi5351_I2C)->tWrite(u8Value);
       ((Si5351_I2C*)pSi5351_I2C)->tEndTransmission();
@@ -83,10 +88,236 @@ void Si5351_I2C::gen_write(void* pSi5351_I2C, const uint8_t u8Reg, const uint8_t
   }
 }
 
+/* Block read with register auto-increment */
+void Si5351_I2C::gen_read_block(void* pSi5351_I2C, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count) {
+  uint8_t u8Index;
+  uint8_t u8Chunk;
+  uint8_t u8Byte;
+
+  if(pSi5351_I2C && pu8Value) {
+    if(
+      ((Si5351_I2C*)pSi5351_I2C)->tBeginTransmission &&
+      ((Si5351_I2C*)pSi5351_I2C)->tRequestFrom &&
+      ((Si5351_I2C*)pSi5351_I2C)->tRead &&
+      ((Si5351_I2C*)pSi5351_I2C)->tWrite &&
+      ((Si5351_I2C*)pSi5351_I2C)->tEndTransmission
+    ) {
+      for(u8Index = 0; u8Index < u8Count; u8Index += u8Chunk) {
+        u8Chunk = u8Count - u8Index;
+        if(u8Chunk > SI5351_I2C_BLOCK_MAX) {
+          u8Chunk = SI5351_I2C_BLOCK_MAX;
+        }
+        ((Si5351_I2C*)pSi5351_I2C)->tBeginTransmission(((Si5351_I2C*)pSi5351_I2C)->u8Address);
+        ((Si5351_I2C*)pSi5351_I2C)->tWrite(u8Reg + u8Index);
+        ((Si5351_I2C*)pSi5351_I2C)->tEndTransmission();
+        ((Si5351_I2C*)pSi5351_I2C)->tRequestFrom(((Si5351_I2C*)pSi5351_I2C)->u8Address, u8Chunk);
+        for(u8Byte = 0; u8Byte < u8Chunk; u8Byte++) {
+          pu8Value[u8Index + u8Byte] = ((Si5351_I2C*)pSi5351_I2C)->tRead(((Si5351_I2C*)pSi5351_I2C)->u8Address);
+        }
+      }
+    }
+  }
+}
+
+/* Block write with register auto-increment */
+void Si5351_I2C::gen_write_block(void* pSi5351_I2C, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+  uint8_t u8Index;
+  uint8_t u8Chunk;
+  uint8_t u8Byte;
+
+  if(pSi5351_I2C && pu8Value) {
+    if(
+      ((Si5351_I2C*)pSi5351_I2C)->tBeginTransmission &&
+      ((Si5351_I2C*)pSi5351_I2C)->tWrite &&
+      ((Si5351_I2C*)pSi5351_I2C)->tEndTransmission
+    ) {
+      for(u8Index = 0; u8Index < u8Count; u8Index += u8Chunk) {
+        u8Chunk = u8Count - u8Index;
+        if(u8Chunk > SI5351_I2C_BLOCK_MAX) {
+          u8Chunk = SI5351_I2C_BLOCK_MAX;
+        }
+        ((Si5351_I2C*)pSi5351_I2C)->tBeginTransmission(((Si5351_I2C*)pSi5351_I2C)->u8Address);
+        ((Si5351_I2C*)pSi5351_I2C)->tWrite(u8Reg + u8Index);
+        for(u8Byte = 0; u8Byte < u8Chunk; u8Byte++) {
+          ((Si5351_I2C*)pSi5351_I2C)->tWrite(pu8Value[u8Index + u8Byte]);
+        }
+        ((Si5351_I2C*)pSi5351_I2C)->tEndTransmission();
+      }
+    }
+  }
+}
+
 bool Si5351_I2C::initDevice(void) {
   return Si5351_InitDevice(&this->tSi5351);
 }
 
+bool Si5351_I2C::setLockPolicy(const Si5351_LockPolicy_t* ptPolicy, void* pContext) {
+  return Si5351_SetLockPolicy(&this->tSi5351, ptPolicy, pContext);
+}
+
+bool Si5351_I2C::getAddress(uint8_t* pu8Address) {
+  bool bValid = false;
+
+  if(pu8Address) {
+    bValid = true;
+    *pu8Address = this->u8Address;
+  }
+
+  return bValid;
+}
+
+/* 7-bit address, set before use (the instances on one bus share its lock or arbiter) */
+bool Si5351_I2C::setAddress(const uint8_t u8Address) {
+  bool bValid = false;
+
+  if(u8Address <= 0x7F) {
+    bValid = true;
+    this->u8Address = u8Address;
+  }
+
+  return bValid;
+}
+
+/* Register Cache */
+
+bool Si5351_I2C::attachCache(Si5351_Cache_t* ptCache) {
+  return Si5351_AttachCache(&this->tSi5351, ptCache);
+}
+
+bool Si5351_I2C::invalidateCache(void) {
+  return Si5351_InvalidateCache(&this->tSi5351);
+}
+
+bool Si5351_I2C::syncCache(void) {
+  return Si5351_SyncCache(&this->tSi5351);
+}
+
+/* Write Elision */
+
+bool Si5351_I2C::setWriteElision(const bool bElide) {
+  return Si5351_SetWriteElision(&this->tSi5351, bElide);
+}
+
+bool Si5351_I2C::getWriteStats(Si5351_WriteStats_t* ptWriteStats) {
+  return Si5351_GetWriteStats(ptWriteStats, &this->tSi5351);
+}
+
+bool Si5351_I2C::resetWriteStats(void) {
+  return Si5351_ResetWriteStats(&this->tSi5351);
+}
+
+#if defined(SI5351_USE_STATS)
+/* Operation Statistics */
+
+bool Si5351_I2C::attachStats(Si5351_Stats_t* ptStats, const Si5351_Timestamp_t tTimestamp) {
+  return Si5351_AttachStats(&this->tSi5351, ptStats, tTimestamp);
+}
+
+bool Si5351_I2C::getStats(Si5351_OpStats_t* ptOpStats, const Si5351_Api_t tApi) {
+  return Si5351_GetStats(ptOpStats, &this->tSi5351, tApi);
+}
+
+bool Si5351_I2C::resetStats(void) {
+  return Si5351_ResetStats(&this->tSi5351);
+}
+#endif
+
+#if defined(SI5351_USE_TRACE)
+/* Register Access Trace */
+
+bool Si5351_I2C::attachTrace(Si5351_Trace_t* ptTrace, const uint8_t u8Device) {
+  return Si5351_AttachTrace(&this->tSi5351, ptTrace, u8Device);
+}
+#endif
+
+/* Transaction */
+
+bool Si5351_I2C::beginTransaction(void) {
+  return Si5351_BeginTransaction(&this->tSi5351);
+}
+
+bool Si5351_I2C::commit(void) {
+  return Si5351_Commit(&this->tSi5351);
+}
+
+bool Si5351_I2C::abortTransaction(void) {
+  return Si5351_AbortTransaction(&this->tSi5351);
+}
+
+Si5351_I2C_Transaction::Si5351_I2C_Transaction(Si5351_I2C& roSi5351) : roSi5351(roSi5351) {
+  this->bActive = roSi5351.beginTransaction();
+}
+
+Si5351_I2C_Transaction::~Si5351_I2C_Transaction() {
+  this->commit();
+}
+
+bool Si5351_I2C_Transaction::isActive(void) const {
+  return this->bActive;
+}
+
+bool Si5351_I2C_Transaction::commit(void) {
+  bool bValid = false;
+
+  if(this->bActive) {
+    this->bActive = false;
+    bValid = this->roSi5351.commit();
+  }
+
+  return bValid;
+}
+
+bool Si5351_I2C_Transaction::abort(void) {
+  bool bValid = false;
+
+  if(this->bActive) {
+    this->bActive = false;
+    bValid = this->roSi5351.abortTransaction();
+  }
+
+  return bValid;
+}
+
+/* Lock */
+
+bool Si5351_I2C::tryLock(void) {
+  return Si5351_TryLock(&this->tSi5351);
+}
+
+bool Si5351_I2C::lockWait(const uint32_t u32Tries) {
+  return Si5351_LockWait(&this->tSi5351, u32Tries);
+}
+
+bool Si5351_I2C::unlock(void) {
+  return Si5351_Unlock(&this->tSi5351);
+}
+
+/* Register Access */
+
+bool Si5351_I2C::readRegisters(uint8_t* pu8Value, const uint8_t u8Reg, const uint8_t u8Count) {
+  return Si5351_ReadRegisters(pu8Value, &this->tSi5351, u8Reg, u8Count);
+}
+
+bool Si5351_I2C::writeRegisters(const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+  return Si5351_WriteRegisters(&this->tSi5351, u8Reg, pu8Value, u8Count);
+}
+
+bool Si5351_I2C::updateRegister(const uint8_t u8Reg, const uint8_t u8Mask, const uint8_t u8Value) {
+  return Si5351_UpdateRegister(&this->tSi5351, u8Reg, u8Mask, u8Value);
+}
+
+bool Si5351_I2C::setRegisterBits(const uint8_t u8Reg, const uint8_t u8Bits) {
+  return Si5351_SetRegisterBits(&this->tSi5351, u8Reg, u8Bits);
+}
+
+bool Si5351_I2C::clearRegisterBits(const uint8_t u8Reg, const uint8_t u8Bits) {
+  return Si5351_ClearRegisterBits(&this->tSi5351, u8Reg, u8Bits);
+}
+
+bool Si5351_I2C::toggleRegisterBits(const uint8_t u8Reg, const uint8_t u8Bits) {
+  return Si5351_ToggleRegisterBits(&this->tSi5351, u8Reg, u8Bits);
+}
+
 /* Status */
 
 /* Reg.0-2 Status */
@@ -246,6 +477,33 @@ bool Si5351_I2C::setMS(const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS) {
   return Si5351_SetMS(&this->tSi5351, tCLKNo, ptMS);
 }
 
+#if SI5351_CLKNUM > 3
+bool Si5351_I2C::getMS67(uint8_t* pu8MS, Si5351_MS_DIV_t* ptDIV, const Si5351_CLKNo_t tCLKNo) {
+  return Si5351_GetMS67(pu8MS, ptDIV, &this->tSi5351, tCLKNo);
+}
+
+bool Si5351_I2C::setMS67(const Si5351_CLKNo_t tCLKNo, const uint8_t u8MS, const Si5351_MS_DIV_t tDIV) {
+  return Si5351_SetMS67(&this->tSi5351, tCLKNo, u8MS, tDIV);
+}
+
+bool Si5351_I2C::setMS67Divider(const Si5351_CLKNo_t tCLKNo, const uint8_t u8MS) {
+  return Si5351_SetMS67Divider(&this->tSi5351, tCLKNo, u8MS);
+}
+#endif
+
+/* Frequency hop */
+bool Si5351_I2C::retuneMSA(const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS) {
+  return Si5351_RetuneMSA(&this->tSi5351, ptMS, ptLastMS);
+}
+
+bool Si5351_I2C::retuneMSB(const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS) {
+  return Si5351_RetuneMSB(&this->tSi5351, ptMS, ptLastMS);
+}
+
+bool Si5351_I2C::retuneMS(const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS) {
+  return Si5351_RetuneMS(&this->tSi5351, tCLKNo, ptMS, ptLastMS);
+}
+
 /* Spread Spectrum Parameters */
 
 /* Reg.149-161 Spread Spectrum Parameters */
@@ -312,11 +570,65 @@ bool Si5351_I2C::setXTALLoadCap(const Si5351_XTALLoadCap_t tXTALLoadCap) {
 
 /* Utility */
 
-#if defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
+bool Si5351_I2C::calcMSRatio(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint64_t u64Num, const uint64_t u64Den, const uint32_t u32PPB) {
+  return Si5351_CalcMSRatio(ptMS, pi32ErrPPB, u64Num, u64Den, u32PPB);
+}
+
+#if SI5351_CLKNUM > 3
+bool Si5351_I2C::calcMS67(uint8_t* pu8MS, Si5351_MS_DIV_t* ptDIV, int32_t* pi32ErrPPB, const uint32_t u32VCO, const uint32_t u32Output) {
+  return Si5351_CalcMS67(pu8MS, ptDIV, pi32ErrPPB, u32VCO, u32Output);
+}
+#endif
+
+#if defined(SI5351_USE_INTEGER_MATH)
+bool Si5351_I2C::calcMSPLL(Si5351_MS_t* ptMS, const uint32_t u32BaseClock, const uint32_t u32Output) {
+  return Si5351_CalcMSPLL(ptMS, u32BaseClock, u32Output);
+}
+
+bool Si5351_I2C::calcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint32_t u32BaseClock, const uint32_t u32Output, const uint32_t u32PPB) {
+  return Si5351_CalcMSPLLEx(ptMS, pi32ErrPPB, u32BaseClock, u32Output, u32PPB);
+}
+
+bool Si5351_I2C::decalcMSPLL(uint32_t* pu32Output, const uint32_t u32BaseClock, const Si5351_MS_t* ptMS) {
+  return Si5351_DecalcMSPLL(pu32Output, u32BaseClock, ptMS);
+}
+
+bool Si5351_I2C::calcMSClk(Si5351_MS_t* ptMS, const uint32_t u32BaseClock, const uint32_t u32Output) {
+  return Si5351_CalcMSClk(ptMS, u32BaseClock, u32Output);
+}
+
+bool Si5351_I2C::calcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint32_t u32BaseClock, const uint32_t u32Output, const uint32_t u32PPB) {
+  return Si5351_CalcMSClkEx(ptMS, pi32ErrPPB, u32BaseClock, u32Output, u32PPB);
+}
+
+bool Si5351_I2C::decalcMSClk(uint32_t* pu32Output, const uint32_t u32BaseClock, const Si5351_MS_t* ptMS) {
+  return Si5351_DecalcMSClk(pu32Output, u32BaseClock, ptMS);
+}
+
+bool Si5351_I2C::calcSSP(
+  Si5351_SSP_t* ptSSP,
+  const Si5351_SSP_Mode_t tSSC_MODE,
+  const uint32_t u32Freq_PFD,
+  const Si5351_MS_t* ptMS,
+  const uint16_t u16SscAmp
+) {
+  return Si5351_CalcSSP(ptSSP, tSSC_MODE, u32Freq_PFD, ptMS, u16SscAmp);
+}
+
+#if SI5351_TYPE == 1
+bool Si5351_I2C::calcVCXO(uint32_t* pu32VCXO, const Si5351_MS_t* ptMS, const uint8_t u8APR) {
+  return Si5351_CalcVCXO(pu32VCXO, ptMS, u8APR);
+}
+#endif
+#elif defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
 bool Si5351_I2C::calcMSPLL(Si5351_MS_t* ptMS, const float64_t f64BaseClock, const float64_t f64Output) {
   return Si5351_CalcMSPLL(ptMS, f64BaseClock, f64Output);
 }
 
+bool Si5351_I2C::calcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const float64_t f64BaseClock, const float64_t f64Output, const uint32_t u32PPB) {
+  return Si5351_CalcMSPLLEx(ptMS, pi32ErrPPB, f64BaseClock, f64Output, u32PPB);
+}
+
 bool Si5351_I2C::decalcMSPLL(float64_t* pf64Output, const float64_t f64BaseClock, const Si5351_MS_t* ptMS) {
   return Si5351_DecalcMSPLL(pf64Output, f64BaseClock, ptMS);
 }
@@ -325,6 +637,10 @@ bool Si5351_I2C::calcMSClk(Si5351_MS_t* ptMS, const float64_t f64BaseClock, cons
   return Si5351_CalcMSClk(ptMS, f64BaseClock, f64Output);
 }
 
+bool Si5351_I2C::calcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const float64_t f64BaseClock, const float64_t f64Output, const uint32_t u32PPB) {
+  return Si5351_CalcMSClkEx(ptMS, pi32ErrPPB, f64BaseClock, f64Output, u32PPB);
+}
+
 bool Si5351_I2C::decalcMSClk(float64_t* pf64Output, const float64_t f64BaseClock, const Si5351_MS_t* ptMS) {
   return Si5351_DecalcMSClk(pf64Output, f64BaseClock, ptMS);
 }
@@ -349,6 +665,10 @@ bool Si5351_I2C::calcMSPLL(Si5351_MS_t* ptMS, const double dBaseClock, const dou
   return Si5351_CalcMSPLL(ptMS, dBaseClock, dOutput);
 }
 
+bool Si5351_I2C::calcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const double dBaseClock, const double dOutput, const uint32_t u32PPB) {
+  return Si5351_CalcMSPLLEx(ptMS, pi32ErrPPB, dBaseClock, dOutput, u32PPB);
+}
+
 bool Si5351_I2C::decalcMSPLL(double* pdOutput, const double dBaseClock, const Si5351_MS_t* ptMS) {
   return Si5351_DecalcMSPLL(pdOutput, dBaseClock, ptMS);
 }
@@ -357,6 +677,10 @@ bool Si5351_I2C::calcMSClk(Si5351_MS_t* ptMS, const double dBaseClock, const dou
   return Si5351_CalcMSClk(ptMS, dBaseClock, dOutput);
 }
 
+bool Si5351_I2C::calcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const double dBaseClock, const double dOutput, const uint32_t u32PPB) {
+  return Si5351_CalcMSClkEx(ptMS, pi32ErrPPB, dBaseClock, dOutput, u32PPB);
+}
+
 bool Si5351_I2C::decalcMSClk(double* pdOutput, const double dBaseClock, const Si5351_MS_t* ptMS) {
   return Si5351_DecalcMSClk(pdOutput, dBaseClock, ptMS);
 }
@@ -378,3 +702,12 @@ bool Si5351_I2C::calcVCXO(uint32_t* pu32VCXO, const double dRatio, const uint8_t
 #endif
 #endif  /* SI5351_USE_BERKELEY_SOFTFLOAT_3 */
 
+/* Frequency Plan */
+
+bool Si5351_I2C::calcPlan(Si5351_Plan_t* ptPlan, const uint32_t u32BaseClock, const Si5351_PlanRequest_t* ptRequest) {
+  return Si5351_CalcPlan(ptPlan, u32BaseClock, ptRequest);
+}
+
+bool Si5351_I2C::setPlan(const Si5351_Plan_t* ptPlan) {
+  return Si5351_SetPlan(&this->tSi5351, ptPlan);
+}
@@ -11,6 +11,16 @@ typedef uint8_t (*Si5351_I2C_Read_t)(const uint8_t u8Address);
 typedef void (*Si5351_I2C_Write_t)(const uint8_t u8Value);
 typedef void (*Si5351_I2C_EndTransmission_t)(void);
 
+/* Default 7-bit I2C address (0x61 on alternate address parts), per instance with setAddress */
+#ifndef SI5351_I2C_ADDRESS
+#define SI5351_I2C_ADDRESS 0x60
+#endif
+
+/* Max data bytes per block transaction (Wire / TinyWireM buffer limit) */
+#ifndef SI5351_I2C_BLOCK_MAX
+#define SI5351_I2C_BLOCK_MAX 16
+#endif
+
 /* Si5351 I2C class */
 class Si5351_I2C {
 public:
@@ -26,6 +36,49 @@ public:
     void** ppLock
   );
   bool initDevice(void);
+  bool setLockPolicy(const Si5351_LockPolicy_t* ptPolicy, void* pContext);
+  bool getAddress(uint8_t* pu8Address);
+  bool setAddress(const uint8_t u8Address);
+
+  /* Register Cache */
+  bool attachCache(Si5351_Cache_t* ptCache);
+  bool invalidateCache(void);
+  bool syncCache(void);
+
+  /* Write Elision */
+  bool setWriteElision(const bool bElide);
+  bool getWriteStats(Si5351_WriteStats_t* ptWriteStats);
+  bool resetWriteStats(void);
+
+#if defined(SI5351_USE_STATS)
+  /* Operation Statistics */
+  bool attachStats(Si5351_Stats_t* ptStats, const Si5351_Timestamp_t tTimestamp);
+  bool getStats(Si5351_OpStats_t* ptOpStats, const Si5351_Api_t tApi);
+  bool resetStats(void);
+#endif
+
+#if defined(SI5351_USE_TRACE)
+  /* Register Access Trace (ptTrace NULL: detach) */
+  bool attachTrace(Si5351_Trace_t* ptTrace, const uint8_t u8Device);
+#endif
+
+  /* Transaction */
+  bool beginTransaction(void);
+  bool commit(void);
+  bool abortTransaction(void);
+
+  /* Lock */
+  bool tryLock(void);
+  bool lockWait(const uint32_t u32Tries);
+  bool unlock(void);
+
+  /* Register Access */
+  bool readRegisters(uint8_t* pu8Value, const uint8_t u8Reg, const uint8_t u8Count);
+  bool writeRegisters(const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count);
+  bool updateRegister(const uint8_t u8Reg, const uint8_t u8Mask, const uint8_t u8Value);
+  bool setRegisterBits(const uint8_t u8Reg, const uint8_t u8Bits);
+  bool clearRegisterBits(const uint8_t u8Reg, const uint8_t u8Bits);
+  bool toggleRegisterBits(const uint8_t u8Reg, const uint8_t u8Bits);
 
   /* Status */
   bool getStatus(Si5351_Status_t* ptStatus);
@@ -86,6 +139,16 @@ public:
   bool setMSB(const Si5351_MS_t* ptMS);
   bool getMS(Si5351_MS_t* ptMS, const Si5351_CLKNo_t tCLKNo);
   bool setMS(const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS);
+#if SI5351_CLKNUM > 3
+  bool getMS67(uint8_t* pu8MS, Si5351_MS_DIV_t* ptDIV, const Si5351_CLKNo_t tCLKNo);
+  bool setMS67(const Si5351_CLKNo_t tCLKNo, const uint8_t u8MS, const Si5351_MS_DIV_t tDIV);
+  bool setMS67Divider(const Si5351_CLKNo_t tCLKNo, const uint8_t u8MS);
+#endif
+
+  /* Frequency hop (writes only registers changed from ptLastMS) */
+  bool retuneMSA(const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS);
+  bool retuneMSB(const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS);
+  bool retuneMS(const Si5351_CLKNo_t tCLKNo, const Si5351_MS_t* ptMS, const Si5351_MS_t* ptLastMS);
 
   /* Spread Spectrum Parameters */
   bool getSSPEnable(bool* pbEnable);
@@ -112,10 +175,36 @@ public:
   bool setXTALLoadCap(const Si5351_XTALLoadCap_t tXTALLoadCap);
 
   /* Utility */
-#if defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
+  static bool calcMSRatio(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint64_t u64Num, const uint64_t u64Den, const uint32_t u32PPB);
+#if SI5351_CLKNUM > 3
+  static bool calcMS67(uint8_t* pu8MS, Si5351_MS_DIV_t* ptDIV, int32_t* pi32ErrPPB, const uint32_t u32VCO, const uint32_t u32Output);
+#endif
+
+#if defined(SI5351_USE_INTEGER_MATH)
+  static bool calcMSPLL(Si5351_MS_t* ptMS, const uint32_t u32BaseClock, const uint32_t u32Output);
+  static bool calcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint32_t u32BaseClock, const uint32_t u32Output, const uint32_t u32PPB);
+  static bool decalcMSPLL(uint32_t* pu32Output, const uint32_t u32BaseClock, const Si5351_MS_t* ptMS);
+  static bool calcMSClk(Si5351_MS_t* ptMS, const uint32_t u32BaseClock, const uint32_t u32Output);
+  static bool calcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const uint32_t u32BaseClock, const uint32_t u32Output, const uint32_t u32PPB);
+  static bool decalcMSClk(uint32_t* pu32Output, const uint32_t u32BaseClock, const Si5351_MS_t* ptMS);
+
+  static bool calcSSP(
+    Si5351_SSP_t* ptSSP,
+    const Si5351_SSP_Mode_t tSSC_MODE,
+    const uint32_t u32Freq_PFD,
+    const Si5351_MS_t* ptMS,
+    const uint16_t u16SscAmp
+  );
+
+#if SI5351_TYPE == 1
+  static bool calcVCXO(uint32_t* pu32VCXO, const Si5351_MS_t* ptMS, const uint8_t u8APR);
+#endif
+#elif defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
   static bool calcMSPLL(Si5351_MS_t* ptMS, const float64_t f64BaseClock, const float64_t f64Output);
+  static bool calcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const float64_t f64BaseClock, const float64_t f64Output, const uint32_t u32PPB);
   static bool decalcMSPLL(float64_t* pf64Output, const float64_t f64BaseClock, const Si5351_MS_t* ptMS);
   static bool calcMSClk(Si5351_MS_t* ptMS, const float64_t f64BaseClock, const float64_t f64Output);
+  static bool calcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const float64_t f64BaseClock, const float64_t f64Output, const uint32_t u32PPB);
   static bool decalcMSClk(float64_t* pf64Output, const float64_t f64BaseClock, const Si5351_MS_t* ptMS);
 
   static bool calcSSP(
@@ -131,8 +220,10 @@ public:
 #endif
 #else  /* SI5351_USE_BERKELEY_SOFTFLOAT_3 */
   static bool calcMSPLL(Si5351_MS_t* ptMS, const double dBaseClock, const double dOutput);
+  static bool calcMSPLLEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const double dBaseClock, const double dOutput, const uint32_t u32PPB);
   static bool decalcMSPLL(double* pdOutput, const double dBaseClock, const Si5351_MS_t* ptMS);
   static bool calcMSClk(Si5351_MS_t* ptMS, const double dBaseClock, const double dOutput);
+  static bool calcMSClkEx(Si5351_MS_t* ptMS, int32_t* pi32ErrPPB, const double dBaseClock, const double dOutput, const uint32_t u32PPB);
   static bool decalcMSClk(double* pdOutput, const double dBaseClock, const Si5351_MS_t* ptMS);
 
   static bool calcSSP(
@@ -148,9 +239,15 @@ public:
 #endif
 #endif  /* SI5351_USE_BERKELEY_SOFTFLOAT_3 */
 
+  /* Frequency Plan */
+  static bool calcPlan(Si5351_Plan_t* ptPlan, const uint32_t u32BaseClock, const Si5351_PlanRequest_t* ptRequest);
+  bool setPlan(const Si5351_Plan_t* ptPlan);
+
   /* Access (Don't use) */
   static uint8_t gen_read(void* pSi5351_I2C, const uint8_t u8Reg);
   static void gen_write(void* pSi5351_I2C, const uint8_t u8Reg, const uint8_t u8Value);
+  static void gen_read_block(void* pSi5351_I2C, const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count);
+  static void gen_write_block(void* pSi5351_I2C, const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count);
 
 private:
   Si5351_t tSi5351;
@@ -159,6 +256,32 @@ private:
   Si5351_I2C_Read_t              tRead;
   Si5351_I2C_Write_t             tWrite;
   Si5351_I2C_EndTransmission_t   tEndTransmission;
+  uint8_t                        u8Address;
+};
+
+/*
+  Transaction guard
+
+  Begins a transaction on construction and commits it on destruction
+  unless commit() or abort() was called before.
+  setPlan inside a guard commits the guard's transaction at each of its
+  steps (see Si5351_SetPlan): what was staged before goes out with the
+  first step, and only what follows setPlan is still one batch.
+*/
+class Si5351_I2C_Transaction {
+public:
+  explicit Si5351_I2C_Transaction(Si5351_I2C& roSi5351);
+  ~Si5351_I2C_Transaction();
+  bool isActive(void) const;
+  bool commit(void);
+  bool abort(void);
+
+private:
+  Si5351_I2C_Transaction(const Si5351_I2C_Transaction&);
+  Si5351_I2C_Transaction& operator=(const Si5351_I2C_Transaction&);
+
+  Si5351_I2C& roSi5351;
+  bool bActive;
 };
 
 #endif  /* _SI5351_I2C_H_ */
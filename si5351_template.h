@@ -0,0 +1,426 @@
+#ifndef _SI5351_TEMPLATE_H_
+#define _SI5351_TEMPLATE_H_
+
+/* Si5351 header-only template driver by AZO */
+/*
+  Si5351<Transport, Variant>
+
+  Transport is a type with static (inline) Wire-like members:
+    static void    beginTransmission(const uint8_t u8Address);
+    static void    requestFrom(const uint8_t u8Address, const uint8_t u8Count);
+    static uint8_t read(const uint8_t u8Address);
+    static void    write(const uint8_t u8Value);
+    static void    endTransmission(void);
+  (same shapes as the Si5351_I2C callbacks), so every register access
+  inlines down to the bus calls without the function pointers and NULL
+  checks of Si5351_t / Si5351_I2C.
+
+  No lock and no register cache: one owner per device. The C API is
+  unchanged; the divider utilities (Si5351_CalcMS...) are shared with it.
+
+  Variant is an Si5351_Variant descriptor (si5351_variant.h). CLK numbers
+  and input selections are plain integers checked against it, not against
+  SI5351_CLKNUM / SI5351_TYPE, so several variants can share one build.
+*/
+
+#include "si5351.h"
+#include "si5351_variant.h"
+
+/* Default 7-bit I2C address (0x61 on alternate address parts) */
+#ifndef SI5351_I2C_ADDRESS
+#define SI5351_I2C_ADDRESS 0x60
+#endif
+
+/* Max data bytes per block transfer (Wire / TinyWireM buffer limit) */
+#ifndef SI5351_I2C_BLOCK_MAX
+#define SI5351_I2C_BLOCK_MAX 16
+#endif
+
+/* Si5351 template class */
+template<class Transport, class Variant = Si5351_VariantA3>
+class Si5351 {
+public:
+  explicit Si5351(const uint8_t u8Address = SI5351_I2C_ADDRESS) : u8Address(u8Address & 0x7F) {
+  }
+
+  uint8_t getAddress(void) const {
+    return this->u8Address;
+  }
+
+  /* Initialize */
+  bool initDevice(void) {
+    uint8_t au8Value[8];
+    uint8_t u8Index;
+
+    /* Disable Outputs, power down all output drivers, set interrupt masks */
+    writeReg(Variant::REG_OE, 0xFF);
+    for(u8Index = 0; u8Index < 8; u8Index++) {
+      au8Value[u8Index] = 0x80;
+    }
+    writeBlock(Variant::REG_CLK_CONTROL, au8Value, 8);
+    writeReg(Variant::REG_INT_MASK, 0xF0);
+
+    return true;
+  }
+
+  /* Register Access */
+  bool readRegisters(uint8_t* pu8Value, const uint8_t u8Reg, const uint8_t u8Count) {
+    bool bValid = false;
+
+    if(pu8Value && u8Count > 0 && (uint16_t)u8Reg + u8Count <= 0x100) {
+      bValid = true;
+      readBlock(u8Reg, pu8Value, u8Count);
+    }
+
+    return bValid;
+  }
+
+  bool writeRegisters(const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+    bool bValid = false;
+
+    if(pu8Value && u8Count > 0 && (uint16_t)u8Reg + u8Count <= 0x100) {
+      bValid = true;
+      writeBlock(u8Reg, pu8Value, u8Count);
+    }
+
+    return bValid;
+  }
+
+  bool updateRegister(const uint8_t u8Reg, const uint8_t u8Mask, const uint8_t u8Value) {
+    modifyReg(u8Reg, u8Mask, u8Value);
+    return true;
+  }
+
+  bool setRegisterBits(const uint8_t u8Reg, const uint8_t u8Bits) {
+    modifyReg(u8Reg, u8Bits, 0xFF);
+    return true;
+  }
+
+  bool clearRegisterBits(const uint8_t u8Reg, const uint8_t u8Bits) {
+    modifyReg(u8Reg, u8Bits, 0x00);
+    return true;
+  }
+
+  bool toggleRegisterBits(const uint8_t u8Reg, const uint8_t u8Bits) {
+    writeReg(u8Reg, readReg(u8Reg) ^ u8Bits);
+    return true;
+  }
+
+  /* Reg.3 Output Enable Control (1 = disabled) */
+  bool getOutputEnable(uint8_t* pu8Disable) {
+    bool bValid = false;
+
+    if(pu8Disable) {
+      bValid = true;
+      *pu8Disable = readReg(Variant::REG_OE);
+    }
+
+    return bValid;
+  }
+
+  bool setOutputEnable(const uint8_t u8Enable) {
+    modifyReg(Variant::REG_OE, u8Enable & Variant::OE_MASK, 0x00);
+    return true;
+  }
+
+  bool setOutputDisable(const uint8_t u8Disable) {
+    modifyReg(Variant::REG_OE, u8Disable & Variant::OE_MASK, 0xFF);
+    return true;
+  }
+
+  /* CLKIN_DIV : CLKIN Input Divider 0:1 / 1:2 / 2:4 / 3:8 (Si5351C only) */
+  bool setCLKIN_DIV(const uint8_t u8Div) {
+    static_assert(Variant::HAS_CLKIN, "CLKIN_DIV needs an Si5351C variant");
+    modifyReg(Variant::REG_PLL_SRC, 0x3 << 6, (u8Div & 0x3) << 6);
+    return true;
+  }
+
+  /* PLL_SRC : Input Source Select for PLLA/PLLB (SI5351_INPUT_XTAL / CLKIN) */
+  bool setPLLA_SRC(const uint8_t u8Src) {
+    return setPLLSrc(2, u8Src);
+  }
+
+  bool setPLLB_SRC(const uint8_t u8Src) {
+    return setPLLSrc(3, u8Src);
+  }
+
+  /* Reg.16-23 CLKx Control */
+  bool setClkPowerDown(const uint8_t u8CLKNo, const bool bPowerDown) {
+    return setClkControl(u8CLKNo, 0x1 << 7, (uint8_t)(bPowerDown ? 1 : 0) << 7);
+  }
+
+  bool setClkMSSource(const uint8_t u8CLKNo, const Si5351_CLK_MS_SRC_t tSrc) {
+    return setClkControl(u8CLKNo, 0x1 << 5, ((uint8_t)tSrc & 0x1) << 5);
+  }
+
+  bool setClkInvert(const uint8_t u8CLKNo, const bool bInvert) {
+    return setClkControl(u8CLKNo, 0x1 << 4, (uint8_t)(bInvert ? 1 : 0) << 4);
+  }
+
+  /* SI5351_INPUT_XTAL / CLKIN / ALTMS / MS */
+  bool setClkSrc(const uint8_t u8CLKNo, const uint8_t u8Src) {
+    bool bValid = false;
+
+    if(Variant::isInput(u8Src)) {
+      bValid = setClkControl(u8CLKNo, 0x3 << 2, (u8Src & 0x3) << 2);
+    }
+
+    return bValid;
+  }
+
+  bool setClkIDrive(const uint8_t u8CLKNo, const Si5351_CLK_IDRV_t tIDrv) {
+    return setClkControl(u8CLKNo, 0x3, (uint8_t)tIDrv & 0x3);
+  }
+
+  /* Reg.24,25 CLKx Disable State */
+  bool setClkDisableState(const uint8_t u8CLKNo, const Si5351_CLK_DIS_STATE_t tDisState) {
+    bool bValid = false;
+
+    if(Variant::isClk(u8CLKNo)) {
+      bValid = true;
+      modifyReg(Variant::regDisState(u8CLKNo), 0x3 << (2 * (u8CLKNo % 4)), ((uint8_t)tDisState & 0x3) << (2 * (u8CLKNo % 4)));
+    }
+
+    return bValid;
+  }
+
+  /* Reg.22,26-33 Multisynth NA / Reg.23,34-41 Multisynth NB */
+  bool setMSA(const Si5351_MS_t* ptMS) {
+    return setPLL(Variant::regClkControl(6), Variant::REG_MSNA, ptMS);
+  }
+
+  bool setMSB(const Si5351_MS_t* ptMS) {
+    return setPLL(Variant::regClkControl(7), Variant::REG_MSNB, ptMS);
+  }
+
+  /* Reg.16-21,42-92 Multisynthx Parameters (CLK6/7: integer a only) */
+  bool setMS(const uint8_t u8CLKNo, const Si5351_MS_t* ptMS) {
+    bool bValid = false;
+    uint8_t au8Value[8];
+
+    if(ptMS && Variant::isMS(u8CLKNo)) {
+      bValid = true;
+      modifyReg(Variant::regClkControl(u8CLKNo), 0x1 << 6, (uint8_t)(ptMS->bInteger ? 1 : 0) << 6);
+      encodeMS(au8Value, ptMS);
+      au8Value[2] |= (readReg(Variant::regMS(u8CLKNo) + 2) & ~0x7F) | ((ptMS->tDIV & 0x7) << 4) | ((ptMS->bDivBy4 ? 3 : 0) << 2);
+      writeBlock(Variant::regMS(u8CLKNo), au8Value, 8);
+    } else if(ptMS && Variant::isMS67(u8CLKNo)) {
+      if(!ptMS->bDivBy4 && ptMS->u32MSX_P2 == 0 && !((ptMS->u32MSX_P1 + 512) & 0x7F)) {
+        bValid = setMS67(u8CLKNo, (ptMS->u32MSX_P1 + 512) >> 7, ptMS->tDIV);
+      }
+    }
+
+    return bValid;
+  }
+
+  /* Reg.90,91 MS6/MS7 even integer divider 6 - 254, Reg.92 R6/R7 */
+  bool setMS67(const uint8_t u8CLKNo, const uint32_t u32MS, const Si5351_MS_DIV_t tDIV) {
+    bool bValid = false;
+    uint8_t u8Shift;
+
+    if(Variant::isMS67(u8CLKNo) && isMS67Divider(u32MS)) {
+      bValid = true;
+      u8Shift = 4 * (u8CLKNo - 6);
+      writeReg(Variant::regMS67(u8CLKNo), (uint8_t)u32MS);
+      modifyReg(Variant::REG_R67, 0x7 << u8Shift, (tDIV & 0x7) << u8Shift);
+    }
+
+    return bValid;
+  }
+
+  bool setMS67Divider(const uint8_t u8CLKNo, const uint32_t u32MS) {
+    bool bValid = false;
+
+    if(Variant::isMS67(u8CLKNo) && isMS67Divider(u32MS)) {
+      bValid = true;
+      writeReg(Variant::regMS67(u8CLKNo), (uint8_t)u32MS);
+    }
+
+    return bValid;
+  }
+
+  /* Reg.165-170 Phase Offset */
+  bool setPhaseOffset(const uint8_t u8CLKNo, const uint8_t u8PhOff) {
+    bool bValid = false;
+
+    if(Variant::isMS(u8CLKNo)) {
+      bValid = true;
+      writeReg(Variant::regPhaseOffset(u8CLKNo), u8PhOff & 0x7F);
+    }
+
+    return bValid;
+  }
+
+  /* Reg.162-164 VCXO_Param (Si5351B only) */
+  bool setVCXO(const uint32_t u32VCXO) {
+    static_assert(Variant::HAS_VCXO, "VCXO needs an Si5351B variant");
+    uint8_t au8Value[3];
+
+    au8Value[0] = (uint8_t)( u32VCXO        & 0xFF);
+    au8Value[1] = (uint8_t)((u32VCXO >>  8) & 0xFF);
+    au8Value[2] = (uint8_t)((u32VCXO >> 16) & 0x3F);
+    writeBlock(Variant::REG_VCXO, au8Value, 3);
+
+    return true;
+  }
+
+  /* Reg.177 PLL soft reset */
+  bool PLLSoftReset(void) {
+    modifyReg(Variant::REG_PLL_RESET, 0xF0, 0xA0);
+    return true;
+  }
+
+  /* Reg.183 Crystal Internal Load Capacitance */
+  bool setXTALLoadCap(const Si5351_XTALLoadCap_t tXTALLoadCap) {
+    modifyReg(Variant::REG_XTAL_CL, 0x3 << 6, ((uint8_t)tXTALLoadCap & 0x3) << 6);
+    return true;
+  }
+
+  /* Divider calculation within the Variant's ranges, from its XTAL (or CLKIN / CLKIN_DIV) */
+  static bool calcMSPLL(Si5351_MS_t* ptMS, const uint32_t u32VCO, const uint8_t u8Src = SI5351_INPUT_XTAL, const uint8_t u8CLKINDiv = 0) {
+    bool bValid = false;
+    uint32_t u32Input;
+
+    if(ptMS && u8Src <= SI5351_INPUT_CLKIN && Variant::inputFreq(u8Src) && Variant::isVCO(u32VCO)) {
+      u32Input = Variant::inputFreq(u8Src) >> (u8CLKINDiv & 0x3);
+#if defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
+      bValid = Si5351_CalcMSPLL(ptMS, ui64_to_f64(u32Input), ui64_to_f64(u32VCO));
+#else
+      bValid = Si5351_CalcMSPLL(ptMS, u32Input, u32VCO);
+#endif  /* SI5351_USE_BERKELEY_SOFTFLOAT_3 */
+    }
+
+    return bValid;
+  }
+
+  static bool calcMSClk(Si5351_MS_t* ptMS, const uint32_t u32VCO, const uint32_t u32Freq) {
+    bool bValid = false;
+
+    if(ptMS && Variant::isVCO(u32VCO) && Variant::isOutput(u32Freq)) {
+#if defined(SI5351_USE_BERKELEY_SOFTFLOAT_3)
+      bValid = Si5351_CalcMSClk(ptMS, ui64_to_f64(u32VCO), ui64_to_f64(u32Freq));
+#else
+      bValid = Si5351_CalcMSClk(ptMS, u32VCO, u32Freq);
+#endif  /* SI5351_USE_BERKELEY_SOFTFLOAT_3 */
+    }
+
+    return bValid;
+  }
+
+private:
+  uint8_t u8Address;
+
+  static bool isMS67Divider(const uint32_t u32MS) {
+    return (u32MS >= 6 && u32MS <= 254 && !(u32MS & 0x1)) ? true : false;
+  }
+
+  bool setClkControl(const uint8_t u8CLKNo, const uint8_t u8Mask, const uint8_t u8Value) {
+    bool bValid = false;
+
+    if(Variant::isClk(u8CLKNo)) {
+      bValid = true;
+      modifyReg(Variant::regClkControl(u8CLKNo), u8Mask, u8Value);
+    }
+
+    return bValid;
+  }
+
+  bool setPLLSrc(const uint8_t u8Shift, const uint8_t u8Src) {
+    bool bValid = false;
+
+    if(u8Src <= SI5351_INPUT_CLKIN && Variant::isInput(u8Src)) {
+      bValid = true;
+      modifyReg(Variant::REG_PLL_SRC, 0x1 << u8Shift, u8Src << u8Shift);
+    }
+
+    return bValid;
+  }
+
+  bool setPLL(const uint8_t u8IntReg, const uint8_t u8Reg, const Si5351_MS_t* ptMS) {
+    bool bValid = false;
+    uint8_t au8Value[8];
+
+    if(ptMS) {
+      bValid = true;
+      modifyReg(u8IntReg, 0x1 << 6, (uint8_t)(ptMS->bInteger ? 1 : 0) << 6);
+      encodeMS(au8Value, ptMS);
+      au8Value[2] |= readReg(u8Reg + 2) & ~0x3;
+      writeBlock(u8Reg, au8Value, 8);
+    }
+
+    return bValid;
+  }
+
+  /* Multisynth parameter block (8 registers), as EncodeMS in si5351.c */
+  static void encodeMS(uint8_t* pu8Value, const Si5351_MS_t* ptMS) {
+    pu8Value[0] = (uint8_t)((ptMS->u32MSX_P3 >>  8) & 0xFF);
+    pu8Value[1] = (uint8_t)( ptMS->u32MSX_P3        & 0xFF);
+    pu8Value[2] = (uint8_t)((ptMS->u32MSX_P1 >> 16) & 0x3);
+    pu8Value[3] = (uint8_t)((ptMS->u32MSX_P1 >>  8) & 0xFF);
+    pu8Value[4] = (uint8_t)( ptMS->u32MSX_P1        & 0xFF);
+    pu8Value[5] = (uint8_t)(((ptMS->u32MSX_P3 >> 12) & 0xF0) | ((ptMS->u32MSX_P2 >> 16) & 0xF));
+    pu8Value[6] = (uint8_t)((ptMS->u32MSX_P2 >>  8) & 0xFF);
+    pu8Value[7] = (uint8_t)( ptMS->u32MSX_P2        & 0xFF);
+  }
+
+  /* Bus access */
+  uint8_t readReg(const uint8_t u8Reg) {
+    Transport::beginTransmission(this->u8Address);
+    Transport::write(u8Reg);
+    Transport::endTransmission();
+    Transport::requestFrom(this->u8Address, 1);
+    return Transport::read(this->u8Address);
+  }
+
+  void writeReg(const uint8_t u8Reg, const uint8_t u8Value) {
+    Transport::beginTransmission(this->u8Address);
+    Transport::write(u8Reg);
+    Transport::write(u8Value);
+    Transport::endTransmission();
+  }
+
+  void modifyReg(const uint8_t u8Reg, const uint8_t u8Mask, const uint8_t u8Value) {
+    writeReg(u8Reg, (readReg(u8Reg) & ~u8Mask) | (u8Value & u8Mask));
+  }
+
+  void readBlock(const uint8_t u8Reg, uint8_t* pu8Value, const uint8_t u8Count) {
+    uint8_t u8Index;
+    uint8_t u8Chunk;
+    uint8_t u8Byte;
+
+    for(u8Index = 0; u8Index < u8Count; u8Index += u8Chunk) {
+      u8Chunk = u8Count - u8Index;
+      if(u8Chunk > SI5351_I2C_BLOCK_MAX) {
+        u8Chunk = SI5351_I2C_BLOCK_MAX;
+      }
+      Transport::beginTransmission(this->u8Address);
+      Transport::write(u8Reg + u8Index);
+      Transport::endTransmission();
+      Transport::requestFrom(this->u8Address, u8Chunk);
+      for(u8Byte = 0; u8Byte < u8Chunk; u8Byte++) {
+        pu8Value[u8Index + u8Byte] = Transport::read(this->u8Address);
+      }
+    }
+  }
+
+  void writeBlock(const uint8_t u8Reg, const uint8_t* pu8Value, const uint8_t u8Count) {
+    uint8_t u8Index;
+    uint8_t u8Chunk;
+    uint8_t u8Byte;
+
+    for(u8Index = 0; u8Index < u8Count; u8Index += u8Chunk) {
+      u8Chunk = u8Count - u8Index;
+      if(u8Chunk > SI5351_I2C_BLOCK_MAX) {
+        u8Chunk = SI5351_I2C_BLOCK_MAX;
+      }
+      Transport::beginTransmission(this->u8Address);
+      Transport::write(u8Reg + u8Index);
+      for(u8Byte = 0; u8Byte < u8Chunk; u8Byte++) {
+        Transport::write(pu8Value[u8Index + u8Byte]);
+      }
+      Transport::endTransmission();
+    }
+  }
+};
+
+#endif  /* _SI5351_TEMPLATE_H_ */
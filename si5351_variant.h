@@ -0,0 +1,124 @@
+#ifndef _SI5351_VARIANT_H_
+#define _SI5351_VARIANT_H_
+
+/* Si5351 compile-time variant descriptor by AZO */
+/*
+  Si5351_Variant<Type, CLKNum, XTALFreq, CLKINFreq> (C++11)
+
+  Everything SI5351_TYPE / SI5351_CLKNUM / SI5351_XTAL_FREQ decide for the
+  C core, per type instead of per build: output count, feature availability
+  (VCXO, CLKIN, MS6/MS7), frequency ranges and register addresses. All
+  members are constexpr, so checks against them fold away, and an
+  Si5351A-3 and an Si5351C-8 can live in one image (see si5351_template.h).
+  Invalid combinations fail with static_assert, as the #error checks do.
+*/
+
+#include <stdint.h>
+
+#if !defined(__cplusplus) || __cplusplus < 201103L
+#error si5351_variant.h needs C++11
+#endif
+
+/* Input selections as register values (the C enums list CLKIN only in SI5351_TYPE 2 builds) */
+/* PLL_SRC : XTAL / CLKIN, CLKx_SRC : XTAL / CLKIN / ALTMS / MS */
+typedef enum Si5351_Input_t_ {
+  SI5351_INPUT_XTAL = 0,
+  SI5351_INPUT_CLKIN,
+  SI5351_INPUT_ALTMS,
+  SI5351_INPUT_MS
+} Si5351_Input_t;
+
+/* Device variant (u8Type 0:A / 1:B / 2:C, u8ClkNum 3 or 8, frequencies in Hz) */
+template<uint8_t u8Type, uint8_t u8ClkNum, uint32_t u32XTALFreq = 25000000, uint32_t u32CLKINFreq = 0>
+struct Si5351_Variant {
+  static_assert(u8Type <= 2, "Invalid Si5351 type");
+  static_assert(u8ClkNum == 8 || (u8Type == 0 && u8ClkNum == 3), "Invalid Si5351 CLK number");
+  static_assert(u32XTALFreq == 25000000 || u32XTALFreq == 27000000, "Invalid Si5351 XTAL frequency");
+  static_assert(u8Type != 2 || (u32CLKINFreq >= 10000000 && u32CLKINFreq <= 100000000), "Invalid Si5351 CLKIN frequency");
+
+  /* Device */
+  static constexpr uint8_t TYPE = u8Type;
+  static constexpr uint8_t CLKNUM = u8ClkNum;
+  /* CLKs with a full Multisynth (MS0-5), CLK6/7 have an integer divider */
+  static constexpr uint8_t MSNUM = (u8ClkNum > 3) ? 6 : 3;
+  static constexpr uint8_t OE_MASK = (u8ClkNum > 3) ? 0xFF : 0x07;
+  static constexpr bool HAS_VCXO = (u8Type == 1);
+  static constexpr bool HAS_CLKIN = (u8Type == 2);
+  static constexpr bool HAS_MS67 = (u8ClkNum > 3);
+
+  /* Frequencies (Hz) */
+  static constexpr uint32_t XTAL_FREQ = u32XTALFreq;
+  static constexpr uint32_t CLKIN_FREQ = u32CLKINFreq;
+  static constexpr uint32_t VCO_MIN = 600000000;
+  static constexpr uint32_t VCO_MAX = 900000000;
+  static constexpr uint32_t CLK_MIN = 2500;
+  static constexpr uint32_t CLK_MAX = 200000000;
+
+  /* Registers */
+  static constexpr uint8_t REG_STATUS = 0;
+  static constexpr uint8_t REG_INT_MASK = 2;
+  static constexpr uint8_t REG_OE = 3;
+  static constexpr uint8_t REG_OEB_MASK = 9;
+  static constexpr uint8_t REG_PLL_SRC = 15;
+  static constexpr uint8_t REG_CLK_CONTROL = 16;
+  static constexpr uint8_t REG_CLK_DIS_STATE = 24;
+  static constexpr uint8_t REG_MSNA = 26;
+  static constexpr uint8_t REG_MSNB = 34;
+  static constexpr uint8_t REG_MS = 42;
+  static constexpr uint8_t REG_MS67 = 90;
+  static constexpr uint8_t REG_R67 = 92;
+  static constexpr uint8_t REG_SSP = 149;
+  static constexpr uint8_t REG_VCXO = 162;
+  static constexpr uint8_t REG_PHASE_OFFSET = 165;
+  static constexpr uint8_t REG_PLL_RESET = 177;
+  static constexpr uint8_t REG_XTAL_CL = 183;
+
+  /* Checks */
+  static constexpr bool isClk(const uint8_t u8CLKNo) {
+    return u8CLKNo < CLKNUM;
+  }
+  static constexpr bool isMS(const uint8_t u8CLKNo) {
+    return u8CLKNo < MSNUM;
+  }
+  static constexpr bool isMS67(const uint8_t u8CLKNo) {
+    return HAS_MS67 && (u8CLKNo == 6 || u8CLKNo == 7);
+  }
+  static constexpr bool isInput(const uint8_t u8Input) {
+    return u8Input <= SI5351_INPUT_MS && (u8Input != SI5351_INPUT_CLKIN || HAS_CLKIN);
+  }
+  static constexpr bool isVCO(const uint32_t u32VCO) {
+    return u32VCO >= VCO_MIN && u32VCO <= VCO_MAX;
+  }
+  static constexpr bool isOutput(const uint32_t u32Freq) {
+    return u32Freq >= CLK_MIN && u32Freq <= CLK_MAX;
+  }
+
+  /* PLL reference (0:XTAL / 1:CLKIN), 0 if the input does not exist */
+  static constexpr uint32_t inputFreq(const uint8_t u8Input) {
+    return (u8Input == SI5351_INPUT_XTAL) ? XTAL_FREQ : ((u8Input == SI5351_INPUT_CLKIN && HAS_CLKIN) ? CLKIN_FREQ : 0);
+  }
+
+  /* Register addresses per CLK */
+  static constexpr uint8_t regClkControl(const uint8_t u8CLKNo) {
+    return REG_CLK_CONTROL + u8CLKNo;
+  }
+  static constexpr uint8_t regDisState(const uint8_t u8CLKNo) {
+    return REG_CLK_DIS_STATE + u8CLKNo / 4;
+  }
+  static constexpr uint8_t regMS(const uint8_t u8CLKNo) {
+    return REG_MS + 8 * u8CLKNo;
+  }
+  static constexpr uint8_t regMS67(const uint8_t u8CLKNo) {
+    return REG_MS67 + u8CLKNo - 6;
+  }
+  static constexpr uint8_t regPhaseOffset(const uint8_t u8CLKNo) {
+    return REG_PHASE_OFFSET + u8CLKNo;
+  }
+};
+
+typedef Si5351_Variant<0, 3> Si5351_VariantA3;
+typedef Si5351_Variant<0, 8> Si5351_VariantA8;
+typedef Si5351_Variant<1, 8> Si5351_VariantB8;
+typedef Si5351_Variant<2, 8, 25000000, 25000000> Si5351_VariantC8;
+
+#endif  /* _SI5351_VARIANT_H_ */